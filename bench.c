@@ -0,0 +1,1836 @@
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "json.h"
+
+/**
+ * @brief Minimum CPU time spent on every measurement, in seconds
+ */
+#define BENCH_MIN_SECONDS 0.5
+
+/**
+ * @brief Time spent on every file of the corpus before its passes are
+ * recorded, in seconds
+ */
+#define BENCH_WARMUP_SECONDS 0.1
+
+/**
+ * @brief Minimum number of recorded passes on every file of the corpus
+ */
+#define BENCH_MIN_PASSES 100
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+// Linked with `-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc`, so that
+// every allocation of the library and of the benchmark goes through these
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t bench_allocation_count;
+static size_t bench_allocation_bytes;
+
+void *__wrap_malloc(size_t size) {
+  __atomic_fetch_add(&bench_allocation_count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&bench_allocation_bytes, size, __ATOMIC_RELAXED);
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  __atomic_fetch_add(&bench_allocation_count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&bench_allocation_bytes, count * size, __ATOMIC_RELAXED);
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  __atomic_fetch_add(&bench_allocation_count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&bench_allocation_bytes, size, __ATOMIC_RELAXED);
+  return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Reads the number of allocations made so far and the bytes they
+ * asked for, including every `realloc`
+ *
+ * @return false If allocations are not counted in this build
+ */
+static bool bench_allocated(size_t *count, size_t *bytes) {
+#ifdef BENCH_COUNT_ALLOCATIONS
+  *count = __atomic_load_n(&bench_allocation_count, __ATOMIC_RELAXED);
+  *bytes = __atomic_load_n(&bench_allocation_bytes, __ATOMIC_RELAXED);
+  return true;
+#else
+  *count = 0;
+  *bytes = 0;
+  return false;
+#endif
+}
+
+/**
+ * @brief Builds a minified JSON array of `count` items, each produced by
+ * printing the item index with `item_format`
+ */
+static char *bench_make_array(size_t count, const char *item_format) {
+  size_t capacity = 64 * (count + 1);
+  char *buffer = malloc(capacity);
+  size_t offset = 0;
+
+  buffer[offset++] = '[';
+  for (size_t i = 0; i < count; i++) {
+    if (i != 0)
+      buffer[offset++] = ',';
+    offset += sprintf(buffer + offset, item_format, i, i);
+  }
+  buffer[offset++] = ']';
+  buffer[offset] = '\0';
+
+  return buffer;
+}
+
+/**
+ * @brief Builds a minified JSON array of `count` pseudo-random doubles
+ * of many magnitudes, each printed with `format`
+ */
+static char *bench_make_doubles(size_t count, const char *format) {
+  size_t capacity = 64 * (count + 1);
+  char *buffer = malloc(capacity);
+  size_t offset = 0;
+  unsigned long long state = 88172645463325252ULL;
+
+  buffer[offset++] = '[';
+  for (size_t i = 0; i < count; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    // A mantissa in [1, 10) scaled by 10^-20 to 10^19
+    double value = 1.0 + (double)(state >> 11) / 9007199254740992.0 * 9.0;
+    for (int exponent = (int)(state % 40) - 20; exponent > 0; exponent--)
+      value *= 10.0;
+    for (int exponent = (int)(state % 40) - 20; exponent < 0; exponent++)
+      value /= 10.0;
+    if (state & 0x100)
+      value = -value;
+
+    if (i != 0)
+      buffer[offset++] = ',';
+    offset += sprintf(buffer + offset, format, value);
+  }
+  buffer[offset++] = ']';
+  buffer[offset] = '\0';
+
+  return buffer;
+}
+
+/**
+ * @brief Builds a minified JSON array of `count` values, each nested
+ * `depth` levels deep in arrays and objects taking turns
+ */
+static char *bench_make_nested(size_t count, size_t depth) {
+  char *buffer = malloc(count * (depth * 7 + 3) + 3);
+  size_t offset = 0;
+
+  buffer[offset++] = '[';
+  for (size_t i = 0; i < count; i++) {
+    if (i != 0)
+      buffer[offset++] = ',';
+    for (size_t level = 0; level < depth; level++) {
+      if (level % 2 == 0) {
+        buffer[offset++] = '[';
+      } else {
+        memcpy(buffer + offset, "{\"a\":", 5);
+        offset += 5;
+      }
+    }
+    buffer[offset++] = '1';
+    for (size_t level = depth; level > 0; level--)
+      buffer[offset++] = (level - 1) % 2 == 0 ? ']' : '}';
+  }
+  buffer[offset++] = ']';
+  buffer[offset] = '\0';
+
+  return buffer;
+}
+
+/**
+ * @brief Reads a whole file into a NUL-terminated buffer
+ */
+static char *bench_read_file(const char *path, size_t *len) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Expected file \"%s\" not found\n", path);
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  *len = (size_t)ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  char *buffer = malloc(*len + 1);
+  *len = fread(buffer, 1, *len, file);
+  buffer[*len] = '\0';
+  fclose(file);
+
+  return buffer;
+}
+
+/**
+ * @brief Grows `buffer` so that `extra` more characters fit at `offset`
+ */
+static char *bench_reserve(char *buffer, size_t *capacity, size_t offset,
+                           size_t extra) {
+  if (offset + extra <= *capacity)
+    return buffer;
+
+  *capacity = 2 * (offset + extra);
+  return realloc(buffer, *capacity);
+}
+
+/**
+ * @brief Pretty-prints minified JSON with an indentation of `indent`
+ * spaces, the way most configuration files are written
+ */
+static char *bench_indent(const char *json, size_t len, size_t indent,
+                          size_t *out_len) {
+  size_t capacity = 2 * len + 64;
+  char *buffer = malloc(capacity);
+  size_t offset = 0;
+  size_t depth = 0;
+  int in_string = 0;
+
+  for (size_t i = 0; i < len; i++) {
+    char ch = json[i];
+    int closing = !in_string && (ch == '}' || ch == ']');
+    int opening = !in_string && (ch == '{' || ch == '[');
+    int line_break = opening || closing || (!in_string && ch == ',');
+
+    if (closing)
+      depth--;
+
+    // The character, a line break and its indentation, or a space
+    buffer = bench_reserve(buffer, &capacity, offset,
+                           depth * indent + indent + 4);
+
+    if (closing) {
+      buffer[offset++] = '\n';
+      memset(buffer + offset, ' ', depth * indent);
+      offset += depth * indent;
+    }
+
+    buffer[offset++] = ch;
+
+    if (in_string) {
+      if (ch == '\\' && i + 1 < len)
+        buffer[offset++] = json[++i];
+      else if (ch == '"')
+        in_string = 0;
+      continue;
+    }
+
+    if (ch == '"')
+      in_string = 1;
+    else if (ch == ':')
+      buffer[offset++] = ' ';
+
+    if (opening)
+      depth++;
+
+    if (line_break && !closing) {
+      buffer[offset++] = '\n';
+      memset(buffer + offset, ' ', depth * indent);
+      offset += depth * indent;
+    }
+  }
+
+  buffer[offset] = '\0';
+  *out_len = offset;
+
+  return buffer;
+}
+
+/**
+ * @brief How `bench_parse` parses its input
+ */
+enum bench_mode {
+  BENCH_TREE,
+  BENCH_DOCUMENT,
+  // Parses a fresh copy of the input each time, the copy being timed too
+  BENCH_IN_SITU,
+  // Reports every value to callbacks that only count them
+  BENCH_EVENTS,
+  BENCH_TAPE,
+};
+
+/**
+ * @brief Counts one event of any kind
+ */
+static typed(json_boolean) bench_count_event(void *userdata) {
+  (*(size_t *)userdata)++;
+  return true;
+}
+
+/**
+ * @brief Counts a key or a string
+ */
+static typed(json_boolean)
+    bench_count_string(void *userdata, typed(json_string_view) value) {
+  (void)value;
+  return bench_count_event(userdata);
+}
+
+/**
+ * @brief Counts a number
+ */
+static typed(json_boolean)
+    bench_count_number(void *userdata, typed(json_number) value) {
+  (void)value;
+  return bench_count_event(userdata);
+}
+
+/**
+ * @brief Counts a boolean
+ */
+static typed(json_boolean) bench_count_boolean(void *userdata,
+                                               typed(json_boolean) value) {
+  (void)value;
+  return bench_count_event(userdata);
+}
+
+/**
+ * @brief Callbacks that count every event
+ */
+static const typed(json_callbacks) bench_counting_callbacks = {
+    bench_count_event,  bench_count_event,  bench_count_event,
+    bench_count_event,  bench_count_string, bench_count_string,
+    bench_count_number, bench_count_boolean, bench_count_event,
+};
+
+/**
+ * @brief Parses and frees `json` repeatedly and returns the average CPU
+ * time of one iteration in seconds
+ */
+static double bench_parse(const char *json, size_t len, enum bench_mode mode,
+                          const typed(json_parse_options) * options) {
+  char *copy = mode == BENCH_IN_SITU ? malloc(len) : NULL;
+  long iterations = 0;
+  clock_t start = clock();
+  double elapsed;
+
+  do {
+    if (mode == BENCH_IN_SITU) {
+      memcpy(copy, json, len);
+      result(json_document) document_result =
+          json_parse_document_in_situ(copy, len, options);
+      typed(json_document) document =
+          result_unwrap(json_document)(&document_result);
+      json_document_free(&document);
+    } else if (mode == BENCH_DOCUMENT) {
+      result(json_document) document_result =
+          json_parse_document_with_options(json, len, options);
+      typed(json_document) document =
+          result_unwrap(json_document)(&document_result);
+      json_document_free(&document);
+    } else if (mode == BENCH_EVENTS) {
+      size_t events = 0;
+      json_parse_events_with_options(json, len, &bench_counting_callbacks,
+                                     &events, options);
+    } else if (mode == BENCH_TAPE) {
+      result(json_tape) tape_result = json_parse_tape(json, len, options);
+      typed(json_tape) tape = result_unwrap(json_tape)(&tape_result);
+      json_tape_free(&tape);
+    } else {
+      result(json_element) element_result =
+          json_parse_with_options(json, len, options);
+      typed(json_element) element =
+          result_unwrap(json_element)(&element_result);
+      json_free(&element);
+    }
+
+    iterations++;
+    elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  free(copy);
+  return elapsed / (double)iterations;
+}
+
+/**
+ * @brief Measures how the parse time of an array grows with the number
+ * of its elements. Linear growth shows as a constant time per element
+ */
+static void bench_array_scaling(const char *name, const char *item_format) {
+  const typed(json_parse_options) indexed = {.structural_index = true};
+
+  printf("%s\n", name);
+  printf("%10s %14s %14s %14s %14s\n", "elements", "parse (ms)",
+         "ns/element", "document ns/el", "indexed ns/el");
+
+  for (size_t count = 1000; count <= 1000000; count *= 10) {
+    char *json = bench_make_array(count, item_format);
+    size_t len = strlen(json);
+
+    double parse = bench_parse(json, len, BENCH_TREE, NULL);
+    double document = bench_parse(json, len, BENCH_DOCUMENT, NULL);
+    double document_indexed = bench_parse(json, len, BENCH_DOCUMENT, &indexed);
+
+    printf("%10zu %14.3f %14.1f %14.1f %14.1f\n", count, parse * 1e3,
+           parse * 1e9 / (double)count, document * 1e9 / (double)count,
+           document_indexed * 1e9 / (double)count);
+
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief A way of parsing measured on every sample file
+ */
+struct bench_variant {
+  const char *name;
+  enum bench_mode mode;
+  typed(json_parse_options) options;
+};
+
+/**
+ * @brief Measures the parse throughput of the sample files, most of
+ * whose bytes are strings
+ */
+static void bench_samples(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+  static const struct bench_variant variants[] = {
+      {"tree", BENCH_TREE, {0}},
+      {"document", BENCH_DOCUMENT, {0}},
+      {"indexed", BENCH_DOCUMENT, {.structural_index = true}},
+      {"views", BENCH_DOCUMENT, {.string_views = true}},
+      {"in situ", BENCH_IN_SITU, {0}},
+      {"interned", BENCH_DOCUMENT, {.intern_keys = true}},
+      {"shapes", BENCH_DOCUMENT, {.share_shapes = true}},
+      {"events", BENCH_EVENTS, {0}},
+      {"tape", BENCH_TAPE, {0}},
+  };
+  static const size_t variant_count = sizeof(variants) / sizeof(variants[0]);
+
+  printf("Sample files (MB/s)\n");
+  printf("%-20s %10s", "file", "bytes");
+  for (size_t v = 0; v < variant_count; v++)
+    printf(" %10s", variants[v].name);
+  printf("\n");
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    printf("%-20s %10zu", names[i], len);
+    for (size_t v = 0; v < variant_count; v++) {
+      double parse =
+          bench_parse(json, len, variants[v].mode, &variants[v].options);
+      printf(" %10.1f", (double)len / parse / 1e6);
+      fflush(stdout);
+    }
+    printf("\n");
+
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Compares the parse time of the sample files with that of the
+ * same files pretty-printed, whitespace skipping being a parse option
+ */
+static void bench_whitespace(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+  const typed(json_parse_options) skip = {.skip_whitespace = true};
+
+  printf("Whitespace (document parse, ms)\n");
+  printf("%-20s %14s %14s %14s %14s\n", "file", "pretty bytes", "minified",
+         "min. + option", "pretty");
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    size_t pretty_len;
+    char *pretty = bench_indent(json, len, 4, &pretty_len);
+
+    double minified = bench_parse(json, len, BENCH_DOCUMENT, NULL);
+    double minified_skip = bench_parse(json, len, BENCH_DOCUMENT, &skip);
+    double indented = bench_parse(pretty, pretty_len, BENCH_DOCUMENT, &skip);
+
+    printf("%-20s %14zu %14.3f %14.3f %14.3f\n", names[i], pretty_len,
+           minified * 1e3, minified_skip * 1e3, indented * 1e3);
+
+    free(pretty);
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Compares extracting a few fields of a sample file with compiled
+ * paths to parsing all of it into a tree
+ */
+static void bench_paths(const char *directory) {
+  static const char *pointers[] = {"/data/after", "/data/children/0/data/title",
+                                   "/data/children/24/data/ups"};
+  static const size_t pointer_count = sizeof(pointers) / sizeof(pointers[0]);
+
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/reddit.json", directory);
+
+  size_t len;
+  char *json = bench_read_file(path, &len);
+  if (json == NULL)
+    return;
+
+  typed(json_path) paths[sizeof(pointers) / sizeof(pointers[0])];
+  for (size_t i = 0; i < pointer_count; i++) {
+    result(json_path) path_result = json_path_compile(pointers[i]);
+    paths[i] = result_unwrap(json_path)(&path_result);
+  }
+
+  long iterations = 0;
+  clock_t start = clock();
+  double elapsed;
+
+  do {
+    for (size_t i = 0; i < pointer_count; i++) {
+      result(json_element) element_result =
+          json_path_find(&paths[i], json, len, NULL);
+      typed(json_element) element =
+          result_unwrap(json_element)(&element_result);
+      json_free(&element);
+    }
+
+    iterations++;
+    elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  double tree = bench_parse(json, len, BENCH_TREE, NULL);
+
+  printf("Paths (reddit.json, us)\n");
+  printf("%14s %14s\n", "3 paths", "tree parse");
+  printf("%14.1f %14.1f\n\n", elapsed * 1e6 / (double)iterations, tree * 1e6);
+
+  for (size_t i = 0; i < pointer_count; i++)
+    json_path_free(&paths[i]);
+  free(json);
+}
+
+/**
+ * @brief Whether the characters of a key read by a cursor are `name`
+ */
+static bool bench_key_is(typed(json_string_view) key, const char *name) {
+  return key.len == strlen(name) && memcmp(key.data, name, key.len) == 0;
+}
+
+/**
+ * @brief Moves a cursor inside an object to the value of its entry of
+ * key `name`, skipping the others
+ */
+static bool bench_cursor_field(typed(json_cursor) * cursor,
+                               const char *name) {
+  typed(json_string_view) key;
+
+  for (;;) {
+    result(json_boolean) next_result = json_cursor_next_field(cursor, &key);
+    if (!result_is_ok(json_boolean)(&next_result) ||
+        !result_unwrap(json_boolean)(&next_result))
+      return false;
+
+    if (bench_key_is(key, name))
+      return true;
+    json_cursor_skip(cursor);
+  }
+}
+
+/**
+ * @brief Moves a cursor beyond the object it is inside of, skipping the
+ * entries left
+ */
+static void bench_cursor_leave(typed(json_cursor) * cursor) {
+  typed(json_string_view) key;
+
+  for (;;) {
+    result(json_boolean) next_result = json_cursor_next_field(cursor, &key);
+    if (!result_is_ok(json_boolean)(&next_result) ||
+        !result_unwrap(json_boolean)(&next_result))
+      return;
+
+    json_cursor_skip(cursor);
+  }
+}
+
+/**
+ * @brief Sums the score of every post of reddit.json with a cursor
+ */
+static long bench_cursor_ups(const char *json, size_t len) {
+  typed(json_cursor) cursor = json_cursor_make(json, len, NULL);
+  long total = 0;
+
+  if (!json_cursor_enter_object(&cursor) ||
+      !bench_cursor_field(&cursor, "data") ||
+      !json_cursor_enter_object(&cursor) ||
+      !bench_cursor_field(&cursor, "children") ||
+      !json_cursor_enter_array(&cursor))
+    return 0;
+
+  for (;;) {
+    result(json_boolean) next_result = json_cursor_next_element(&cursor);
+    if (!result_is_ok(json_boolean)(&next_result) ||
+        !result_unwrap(json_boolean)(&next_result))
+      break;
+
+    // Every field of the post after its score is skipped too
+    json_cursor_enter_object(&cursor);
+    bench_cursor_field(&cursor, "data");
+    json_cursor_enter_object(&cursor);
+    bench_cursor_field(&cursor, "ups");
+
+    result(json_number) ups_result = json_cursor_get_number(&cursor);
+    total += result_unwrap(json_number)(&ups_result).value.as_long;
+
+    bench_cursor_leave(&cursor);
+    bench_cursor_leave(&cursor);
+  }
+
+  return total;
+}
+
+/**
+ * @brief Sums the score of every post of reddit.json with a tree
+ */
+static long bench_tree_ups(const char *json, size_t len) {
+  result(json_element) root_result = json_parse_n(json, len);
+  typed(json_element) root = result_unwrap(json_element)(&root_result);
+  long total = 0;
+
+  result(json_element) data_result =
+      json_object_find(root.value.as_object, "data");
+  typed(json_element) data = result_unwrap(json_element)(&data_result);
+  result(json_element) children_result =
+      json_object_find(data.value.as_object, "children");
+  typed(json_array) *children =
+      result_unwrap(json_element)(&children_result).value.as_array;
+
+  for (size_t i = 0; i < children->count; i++) {
+    result(json_element) post_result =
+        json_object_find(children->elements[i].value.as_object, "data");
+    typed(json_element) post = result_unwrap(json_element)(&post_result);
+    result(json_element) ups_result =
+        json_object_find(post.value.as_object, "ups");
+    total += result_unwrap(json_element)(&ups_result)
+                 .value.as_number.value.as_long;
+  }
+
+  json_free(&root);
+  return total;
+}
+
+/**
+ * @brief Compares summing a field of every record of a sample file with
+ * a cursor, which builds nothing, to doing it on a tree
+ */
+static void bench_cursor(const char *directory) {
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/reddit.json", directory);
+
+  size_t len;
+  char *json = bench_read_file(path, &len);
+  if (json == NULL)
+    return;
+
+  printf("Cursor (reddit.json, sum of every score, us)\n");
+  printf("%14s %14s\n", "cursor", "tree");
+
+  long totals[2] = {0, 0};
+  double times[2];
+  for (int tree = 0; tree < 2; tree++) {
+    long iterations = 0;
+    clock_t start = clock();
+    double elapsed;
+
+    do {
+      totals[tree] =
+          tree ? bench_tree_ups(json, len) : bench_cursor_ups(json, len);
+      iterations++;
+      elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    times[tree] = elapsed * 1e6 / (double)iterations;
+  }
+
+  printf("%14.1f %14.1f%s\n\n", times[0], times[1],
+         totals[0] == totals[1] ? "" : " (sums differ)");
+  free(json);
+}
+
+/**
+ * @brief Feeds `json` to a push parser in chunks of `chunk_size`
+ * characters repeatedly and returns the average CPU time of one parse in
+ * seconds
+ */
+static double bench_push_parse(const char *json, size_t len,
+                               size_t chunk_size) {
+  long iterations = 0;
+  clock_t start = clock();
+  double elapsed;
+
+  do {
+    size_t events = 0;
+    typed(json_push_parser) *parser =
+        json_push_parser_new(&bench_counting_callbacks, &events, NULL);
+    for (size_t offset = 0; offset < len; offset += chunk_size) {
+      size_t chunk_len = len - offset < chunk_size ? len - offset : chunk_size;
+      json_push_feed(parser, json + offset, chunk_len);
+    }
+    json_push_finish(parser);
+    json_push_parser_free(parser);
+
+    iterations++;
+    elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  return elapsed / (double)iterations;
+}
+
+/**
+ * @brief Compares reporting the events of the sample files from a whole
+ * buffer to feeding them to a push parser in chunks of several sizes
+ */
+static void bench_push(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+  static const size_t chunk_sizes[] = {16, 256, 4096, 65536};
+  static const size_t chunk_size_count =
+      sizeof(chunk_sizes) / sizeof(chunk_sizes[0]);
+
+  printf("Push parser (MB/s by chunk size)\n");
+  printf("%-20s %10s", "file", "whole");
+  for (size_t c = 0; c < chunk_size_count; c++)
+    printf(" %10zu", chunk_sizes[c]);
+  printf("\n");
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    double whole = bench_parse(json, len, BENCH_EVENTS, NULL);
+    printf("%-20s %10.1f", names[i], (double)len / whole / 1e6);
+    for (size_t c = 0; c < chunk_size_count; c++) {
+      double push = bench_push_parse(json, len, chunk_sizes[c]);
+      printf(" %10.1f", (double)len / push / 1e6);
+      fflush(stdout);
+    }
+    printf("\n");
+
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Serializes `element` to `sink` repeatedly and returns the
+ * average CPU time of one pass in seconds. A sink without a callback is
+ * emptied before every pass, so that it holds the output of the last one
+ */
+static double bench_serialize_element(const typed(json_element) * element,
+                                      int indent, typed(json_sink) * sink) {
+  long iterations = 0;
+  clock_t start = clock();
+  double elapsed;
+
+  do {
+    if (sink->write == NULL)
+      sink->len = 0;
+    json_serialize(element, indent, sink);
+
+    iterations++;
+    elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+  } while (elapsed < BENCH_MIN_SECONDS);
+
+  return elapsed / (double)iterations;
+}
+
+/**
+ * @brief Measures the throughput of serializing the sample files, in
+ * bytes written, minified and pretty-printed to a buffer and
+ * pretty-printed to a file
+ */
+static void bench_serialize(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+
+  printf("Serialize (MB/s of output)\n");
+  printf("%-20s %10s %10s %10s\n", "file", "minified", "pretty",
+         "file");
+
+  FILE *null_file = fopen("/dev/null", "wb");
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    result(json_document) document_result =
+        json_parse_document_n(json, len);
+    typed(json_document) document =
+        result_unwrap(json_document)(&document_result);
+
+    typed(json_sink) buffer = json_sink_make(NULL, NULL);
+    double minified = bench_serialize_element(&document.root, 0, &buffer);
+    size_t minified_len = buffer.len;
+    double pretty = bench_serialize_element(&document.root, 2, &buffer);
+    size_t pretty_len = buffer.len;
+    json_sink_free(&buffer);
+
+    printf("%-20s %10.1f %10.1f", names[i],
+           (double)minified_len / minified / 1e6,
+           (double)pretty_len / pretty / 1e6);
+    if (null_file != NULL) {
+      typed(json_sink) file = json_sink_make(json_sink_write_file, null_file);
+      double written = bench_serialize_element(&document.root, 2, &file);
+      json_sink_free(&file);
+      printf(" %10.1f", (double)pretty_len / written / 1e6);
+    }
+    printf("\n");
+
+    json_document_free(&document);
+    free(json);
+  }
+
+  if (null_file != NULL)
+    fclose(null_file);
+
+  printf("\n");
+}
+
+/**
+ * @brief Measures the throughput of generating records with a writer,
+ * straight to a buffer without building any element
+ */
+static void bench_writer(void) {
+  static const size_t count = 100000;
+
+  printf("Writer (%zu records)\n", count);
+  printf("%-20s %10s %14s %14s\n", "indent", "bytes", "write MB/s",
+         "ns/record");
+
+  for (int indent = 0; indent <= 2; indent += 2) {
+    typed(json_sink) sink = json_sink_make(NULL, NULL);
+    long iterations = 0;
+    clock_t start = clock();
+    double elapsed;
+
+    do {
+      sink.len = 0;
+      typed(json_writer) writer = json_writer_make(&sink, indent);
+
+      json_writer_begin_array(&writer);
+      for (size_t i = 0; i < count; i++) {
+        json_writer_begin_object(&writer);
+        json_writer_key(&writer, "id");
+        json_writer_long(&writer, (long)i);
+        json_writer_key(&writer, "name");
+        json_writer_string(&writer, "item");
+        json_writer_key(&writer, "price");
+        json_writer_double(&writer, (double)i / 7.0);
+        json_writer_key(&writer, "in_stock");
+        json_writer_boolean(&writer, i % 3 != 0);
+        json_writer_end_object(&writer);
+      }
+      json_writer_end_array(&writer);
+      json_writer_finish(&writer);
+
+      iterations++;
+      elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    double write = elapsed / (double)iterations;
+    printf("%-20d %10zu %14.1f %14.1f\n", indent, sink.len,
+           (double)sink.len / write / 1e6, write * 1e9 / (double)count);
+
+    json_sink_free(&sink);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Wall-clock time in seconds, which unlike CPU time does not add
+ * up the time of every thread
+ */
+static double bench_wall_seconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Measures the throughput of parsing newline-delimited records,
+ * one document per line on the calling thread and with
+ * `json_parse_lines` on several threads
+ */
+static void bench_lines(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+  static const size_t thread_counts[] = {1, 2, 4, 8};
+  static const size_t repeats = 100;
+
+  // Every sample file is a single line already
+  char *records[3];
+  size_t record_lens[3];
+  size_t len = 0;
+  for (size_t i = 0; i < 3; i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+    records[i] = bench_read_file(path, &record_lens[i]);
+    if (records[i] == NULL)
+      return;
+    len += repeats * (record_lens[i] + 1);
+  }
+
+  char *json = malloc(len);
+  size_t offset = 0;
+  for (size_t r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < 3; i++) {
+      memcpy(json + offset, records[i], record_lens[i]);
+      offset += record_lens[i];
+      json[offset++] = '\n';
+    }
+  }
+
+  printf("JSON Lines (%zu records, %zu bytes, wall-clock MB/s)\n",
+         3 * repeats, len);
+  printf("%14s", "per line");
+  for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]);
+       t++)
+    printf(" %11zu th", thread_counts[t]);
+  printf("\n");
+
+  long iterations = 0;
+  double start = bench_wall_seconds();
+  double elapsed;
+  do {
+    for (size_t line = 0, begin = 0; line < 3 * repeats; line++) {
+      size_t line_len = record_lens[line % 3];
+      result(json_document) document_result =
+          json_parse_document_n(json + begin, line_len);
+      typed(json_document) document =
+          result_unwrap(json_document)(&document_result);
+      json_document_free(&document);
+      begin += line_len + 1;
+    }
+
+    iterations++;
+    elapsed = bench_wall_seconds() - start;
+  } while (elapsed < BENCH_MIN_SECONDS);
+  printf("%14.1f", (double)len * (double)iterations / elapsed / 1e6);
+  fflush(stdout);
+
+  for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]);
+       t++) {
+    iterations = 0;
+    start = bench_wall_seconds();
+    do {
+      result(json_lines) lines_result =
+          json_parse_lines(json, len, thread_counts[t], NULL);
+      typed(json_lines) lines = result_unwrap(json_lines)(&lines_result);
+      json_lines_free(&lines);
+
+      iterations++;
+      elapsed = bench_wall_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+    printf(" %14.1f", (double)len * (double)iterations / elapsed / 1e6);
+    fflush(stdout);
+  }
+  printf("\n\n");
+
+  for (size_t i = 0; i < 3; i++)
+    free(records[i]);
+  free(json);
+}
+
+/**
+ * @brief Measures the throughput of parsing a large root array made of
+ * copies of the sample files, as one document on the calling thread and
+ * with `json_parse_document_parallel` on several threads
+ */
+static void bench_parallel(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+  static const size_t thread_counts[] = {1, 2, 4, 8};
+  static const size_t repeats = 100;
+
+  char *records[3];
+  size_t record_lens[3];
+  size_t len = 1;
+  for (size_t i = 0; i < 3; i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+    records[i] = bench_read_file(path, &record_lens[i]);
+    if (records[i] == NULL)
+      return;
+    len += repeats * (record_lens[i] + 1);
+  }
+
+  char *json = malloc(len);
+  size_t offset = 0;
+  json[offset++] = '[';
+  for (size_t r = 0; r < repeats; r++) {
+    for (size_t i = 0; i < 3; i++) {
+      if (offset != 1)
+        json[offset++] = ',';
+      memcpy(json + offset, records[i], record_lens[i]);
+      offset += record_lens[i];
+    }
+  }
+  json[offset++] = ']';
+
+  printf("Root array (%zu elements, %zu bytes, wall-clock MB/s)\n",
+         3 * repeats, len);
+  printf("%14s", "document");
+  for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]);
+       t++)
+    printf(" %11zu th", thread_counts[t]);
+  printf("\n");
+
+  for (size_t t = 0; t <= sizeof(thread_counts) / sizeof(thread_counts[0]);
+       t++) {
+    long iterations = 0;
+    double start = bench_wall_seconds();
+    double elapsed;
+    do {
+      result(json_document) document_result =
+          t == 0 ? json_parse_document_n(json, len)
+                 : json_parse_document_parallel(json, len,
+                                                thread_counts[t - 1], NULL);
+      typed(json_document) document =
+          result_unwrap(json_document)(&document_result);
+      json_document_free(&document);
+
+      iterations++;
+      elapsed = bench_wall_seconds() - start;
+    } while (elapsed < BENCH_MIN_SECONDS);
+    printf(t == 0 ? "%14.1f" : " %14.1f",
+           (double)len * (double)iterations / elapsed / 1e6);
+    fflush(stdout);
+  }
+  printf("\n\n");
+
+  for (size_t i = 0; i < 3; i++)
+    free(records[i]);
+  free(json);
+}
+
+/**
+ * @brief Measures the parse throughput of arrays made of numbers only,
+ * integers as well as doubles of short and full precision
+ */
+static void bench_numbers(void) {
+  static const size_t count = 100000;
+
+  printf("Numbers (%zu per array)\n", count);
+  printf("%-20s %10s %14s %14s %14s\n", "numbers", "bytes", "parse MB/s",
+         "ns/number", "write ns/num");
+
+  for (int i = 0; i < 4; i++) {
+    const char *name;
+    char *json;
+
+    switch (i) {
+    case 0:
+      name = "integers";
+      json = bench_make_array(count, "%zu%zu");
+      break;
+    case 1:
+      name = "fixed point";
+      json = bench_make_doubles(count, "%.2f");
+      break;
+    case 2:
+      name = "exponents";
+      json = bench_make_doubles(count, "%.6e");
+      break;
+    default:
+      name = "full precision";
+      json = bench_make_doubles(count, "%.17g");
+      break;
+    }
+
+    size_t len = strlen(json);
+    double parse = bench_parse(json, len, BENCH_DOCUMENT, NULL);
+
+    result(json_document) document_result = json_parse_document_n(json, len);
+    typed(json_document) document =
+        result_unwrap(json_document)(&document_result);
+    typed(json_sink) sink = json_sink_make(NULL, NULL);
+    double write = bench_serialize_element(&document.root, 0, &sink);
+    json_sink_free(&sink);
+    json_document_free(&document);
+
+    printf("%-20s %10zu %14.1f %14.1f %14.1f\n", name, len,
+           (double)len / parse / 1e6, parse * 1e9 / (double)count,
+           write * 1e9 / (double)count);
+
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Measures the time `json_object_find` takes to find every key of
+ * objects of growing width, and that of `json_object_find_key` with the
+ * keys made beforehand
+ */
+static void bench_lookup(void) {
+  printf("Lookup\n");
+  printf("%10s %14s %14s\n", "keys", "ns/find", "ns/find key");
+
+  for (size_t count = 10; count <= 100000; count *= 10) {
+    size_t capacity = 32 * (count + 1);
+    char *json = malloc(capacity);
+    char **keys = malloc(count * sizeof(char *));
+    typed(json_key) *made = malloc(count * sizeof(typed(json_key)));
+    size_t offset = 0;
+
+    json[offset++] = '{';
+    for (size_t i = 0; i < count; i++) {
+      keys[i] = malloc(24);
+      sprintf(keys[i], "key%zu", i);
+      made[i] = json_key_make(keys[i]);
+      offset += sprintf(json + offset, "%s\"%s\":%zu", i != 0 ? "," : "",
+                        keys[i], i);
+    }
+    json[offset++] = '}';
+
+    result(json_document) document_result =
+        json_parse_document_n(json, offset);
+    typed(json_document) document =
+        result_unwrap(json_document)(&document_result);
+    typed(json_object) *object = document.root.value.as_object;
+
+    printf("%10zu", count);
+    for (int precomputed = 0; precomputed < 2; precomputed++) {
+      long finds = 0;
+      clock_t start = clock();
+      double elapsed;
+
+      do {
+        for (size_t i = 0; i < count; i++) {
+          result(json_element) element_result =
+              precomputed ? json_object_find_key(object, &made[i])
+                          : json_object_find(object, keys[i]);
+          finds += result_is_ok(json_element)(&element_result);
+        }
+        elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+      } while (elapsed < BENCH_MIN_SECONDS);
+
+      printf(" %14.1f", elapsed * 1e9 / (double)finds);
+    }
+    printf("\n");
+
+    json_document_free(&document);
+    for (size_t i = 0; i < count; i++)
+      free(keys[i]);
+    free(keys);
+    free(made);
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief Compares finding a field in every record of an array with
+ * `json_object_find` to resolving it once per shape with
+ * `json_shape_find` and indexing the values of the records sharing it
+ */
+static void bench_records(void) {
+  static const char *fields[] = {"id", "name", "active", "score"};
+  static const size_t field_count = sizeof(fields) / sizeof(fields[0]);
+  size_t count = 100000;
+  char *json = bench_make_array(count, "{\"id\":%zu,\"name\":\"user%zu\","
+                                       "\"active\":true,\"score\":1.5}");
+
+  typed(json_parse_options) options = {.share_shapes = true};
+  result(json_document) document_result =
+      json_parse_document_with_options(json, strlen(json), &options);
+  typed(json_document) document =
+      result_unwrap(json_document)(&document_result);
+  typed(json_array) *records = document.root.value.as_array;
+
+  printf("Records (ns/field)\n");
+  printf("%14s %14s\n", "object find", "shape find");
+
+  double times[2];
+  for (int cached = 0; cached < 2; cached++) {
+    long finds = 0;
+    clock_t start = clock();
+    double elapsed;
+
+    do {
+      for (size_t f = 0; f < field_count; f++) {
+        typed(json_shape) *shape = NULL;
+        typed(size) index = 0;
+
+        for (size_t i = 0; i < records->count; i++) {
+          typed(json_object) *record = records->elements[i].value.as_object;
+
+          if (!cached) {
+            result(json_element) element_result =
+                json_object_find(record, fields[f]);
+            finds += result_is_ok(json_element)(&element_result);
+            continue;
+          }
+
+          if (record->shape != shape) {
+            result(size) index_result =
+                json_shape_find(record->shape, fields[f]);
+            shape = record->shape;
+            index = result_unwrap(size)(&index_result);
+          }
+          finds += record->values[index].type != JSON_ELEMENT_TYPE_NULL;
+        }
+      }
+      elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+    } while (elapsed < BENCH_MIN_SECONDS);
+
+    times[cached] = elapsed * 1e9 / (double)finds;
+  }
+  printf("%14.1f %14.1f\n\n", times[0], times[1]);
+
+  json_document_free(&document);
+  free(json);
+}
+
+/**
+ * @brief Measures the parse time of deeply nested input per level of
+ * nesting, which stays flat as the parser keeps its own stack
+ */
+static void bench_nesting(void) {
+  printf("Nesting\n");
+  printf("%10s %14s %14s %14s\n", "depth", "tree ns/level",
+         "document ns/l", "indexed ns/l");
+
+  for (size_t depth = 10; depth <= 100000; depth *= 10) {
+    // About a million levels in all, so that every depth parses as much
+    size_t count = 1000000 / depth;
+    char *json = bench_make_nested(count, depth);
+    size_t len = strlen(json);
+    typed(json_parse_options) options = {.max_depth = depth + 1};
+    typed(json_parse_options) indexed = options;
+    indexed.structural_index = true;
+
+    double parse = bench_parse(json, len, BENCH_TREE, &options);
+    double document = bench_parse(json, len, BENCH_DOCUMENT, &options);
+    double document_indexed = bench_parse(json, len, BENCH_DOCUMENT, &indexed);
+
+    double levels = (double)(count * depth);
+    printf("%10zu %14.1f %14.1f %14.1f\n", depth, parse * 1e9 / levels,
+           document * 1e9 / levels, document_indexed * 1e9 / levels);
+
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief The number of bytes handed out by `malloc` and not yet freed,
+ * 0 where the C library does not tell
+ */
+static size_t bench_heap_bytes(void) {
+#ifdef __GLIBC__
+  struct mallinfo2 info = mallinfo2();
+
+  // Large blocks are mapped on their own, apart from the heap
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief Counts the values of a tree by walking it
+ */
+static size_t bench_tree_values(const typed(json_element) * element) {
+  size_t values = 1;
+
+  if (element->type == JSON_ELEMENT_TYPE_OBJECT) {
+    typed(json_object) *object = element->value.as_object;
+    for (size_t i = 0; i < object->count; i++)
+      values += bench_tree_values(&object->values[i]);
+  } else if (element->type == JSON_ELEMENT_TYPE_ARRAY) {
+    typed(json_array) *array = element->value.as_array;
+    for (size_t i = 0; i < array->count; i++)
+      values += bench_tree_values(&array->elements[i]);
+  }
+
+  return values;
+}
+
+/**
+ * @brief Counts the values of a tape by walking it with its accessors
+ */
+static size_t bench_tape_values(typed(json_tape_value) value) {
+  size_t values = 1;
+  typed(json_element_type) type = json_tape_type(value);
+
+  if (type == JSON_ELEMENT_TYPE_OBJECT) {
+    for (typed(json_tape_value) key = json_tape_first(value);
+         !json_tape_is_end(key); key = json_tape_next(key))
+      values += bench_tape_values(json_tape_key_value(key));
+  } else if (type == JSON_ELEMENT_TYPE_ARRAY) {
+    for (typed(json_tape_value) element = json_tape_first(value);
+         !json_tape_is_end(element); element = json_tape_next(element))
+      values += bench_tape_values(element);
+  }
+
+  return values;
+}
+
+/**
+ * @brief Counts the values of a tape by scanning its words in order
+ */
+static size_t bench_tape_scan(const typed(json_tape) * tape) {
+  size_t values = 0;
+
+  for (size_t i = 0; i < tape->count; i++) {
+    typed(json_tape_tag) tag = (typed(json_tape_tag))(tape->words[i] >> 56);
+    if (tag == JSON_TAPE_TAG_OBJECT_END || tag == JSON_TAPE_TAG_ARRAY_END ||
+        tag == JSON_TAPE_TAG_KEY)
+      continue;
+
+    values++;
+
+    // Skip the word holding the number
+    if (tag == JSON_TAPE_TAG_LONG || tag == JSON_TAPE_TAG_DOUBLE)
+      i++;
+  }
+
+  return values;
+}
+
+/**
+ * @brief Compares the memory a sample file takes once parsed into a
+ * tree, a document and a tape, and the time to visit all of its values
+ */
+static void bench_tape(const char *directory) {
+  static const char *names[] = {"reddit.json", "food.json",
+                                "rickandmorty.json"};
+
+  printf("Tape (resident bytes, ns/value)\n");
+  printf("%-20s %10s %10s %10s %10s %10s %10s %10s\n", "file", "bytes",
+         "tree", "document", "tape", "tree walk", "tape walk", "tape scan");
+
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    size_t heap = bench_heap_bytes();
+    result(json_element) element_result = json_parse_n(json, len);
+    typed(json_element) element = result_unwrap(json_element)(&element_result);
+    size_t tree_bytes = bench_heap_bytes() - heap;
+
+    heap = bench_heap_bytes();
+    result(json_document) document_result = json_parse_document_n(json, len);
+    typed(json_document) document =
+        result_unwrap(json_document)(&document_result);
+    size_t document_bytes = bench_heap_bytes() - heap;
+    json_document_free(&document);
+
+    heap = bench_heap_bytes();
+    result(json_tape) tape_result = json_parse_tape(json, len, NULL);
+    typed(json_tape) tape = result_unwrap(json_tape)(&tape_result);
+    size_t tape_bytes = bench_heap_bytes() - heap;
+
+    printf("%-20s %10zu %10zu %10zu %10zu", names[i], len, tree_bytes,
+           document_bytes, tape_bytes);
+
+    for (int walk = 0; walk < 3; walk++) {
+      size_t values = 0;
+      clock_t start = clock();
+      double elapsed;
+
+      do {
+        if (walk == 0)
+          values += bench_tree_values(&element);
+        else if (walk == 1)
+          values += bench_tape_values(json_tape_root(&tape));
+        else
+          values += bench_tape_scan(&tape);
+        elapsed = (double)(clock() - start) / (double)CLOCKS_PER_SEC;
+      } while (elapsed < BENCH_MIN_SECONDS);
+
+      printf(" %10.2f", elapsed * 1e9 / (double)values);
+      fflush(stdout);
+    }
+    printf("\n");
+
+    json_free(&element);
+    json_tape_free(&tape);
+    free(json);
+  }
+
+  printf("\n");
+}
+
+/**
+ * @brief The operations timed on every file of the corpus, in the order
+ * each pass runs them
+ */
+enum bench_op {
+  BENCH_OP_PARSE,
+  // Finds every key of every object of the parsed tree
+  BENCH_OP_LOOKUP,
+  // Writes the tree minified to a buffer
+  BENCH_OP_SERIALIZE,
+  BENCH_OP_FREE,
+  BENCH_OP_COUNT,
+};
+
+static const char *bench_op_names[] = {"parse", "lookup", "serialize",
+                                       "free"};
+
+/**
+ * @brief The latency of every measured pass of an operation, along with
+ * what its last pass allocated
+ */
+struct bench_latencies {
+  double *ns;
+  size_t count;
+  size_t capacity;
+  // The number of operations of a pass, such as keys looked up
+  size_t ops;
+  size_t allocations;
+  size_t allocated_bytes;
+};
+
+/**
+ * @brief A point in time along with the allocations made until then
+ */
+struct bench_mark {
+  long long ns;
+  size_t allocations;
+  size_t allocated_bytes;
+};
+
+/**
+ * @brief A key of an object of a tree, to be looked up again
+ */
+struct bench_key {
+  typed(json_object) * object;
+  typed(json_string) key;
+};
+
+/**
+ * @brief The keys of every object of a tree, reused from pass to pass
+ */
+struct bench_keys {
+  struct bench_key *keys;
+  size_t count;
+  size_t capacity;
+};
+
+/**
+ * @brief Wall-clock time in whole nanoseconds, for timing single passes
+ */
+static long long bench_wall_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ * @brief Takes a mark {bench_mark} of the present
+ */
+static void bench_mark_now(struct bench_mark *mark) {
+  bench_allocated(&mark->allocations, &mark->allocated_bytes);
+  mark->ns = bench_wall_ns();
+}
+
+/**
+ * @brief Adds the time since `start` as a pass of operation `op`, unless
+ * `latencies` is `NULL` during the warm-up
+ */
+static void bench_record(struct bench_latencies *latencies, enum bench_op op,
+                         const struct bench_mark *start) {
+  struct bench_mark end;
+  end.ns = bench_wall_ns();
+  bench_allocated(&end.allocations, &end.allocated_bytes);
+
+  if (latencies == NULL)
+    return;
+
+  struct bench_latencies *latency = &latencies[op];
+  if (latency->count == latency->capacity) {
+    latency->capacity = latency->capacity == 0 ? 256 : latency->capacity * 2;
+    latency->ns = realloc(latency->ns, latency->capacity * sizeof(double));
+  }
+
+  latency->ns[latency->count++] = (double)(end.ns - start->ns);
+  latency->allocations = end.allocations - start->allocations;
+  latency->allocated_bytes = end.allocated_bytes - start->allocated_bytes;
+}
+
+/**
+ * @brief Collects the keys of every object of a tree
+ */
+static void bench_collect_keys(const typed(json_element) * element,
+                               struct bench_keys *keys) {
+  if (element->type == JSON_ELEMENT_TYPE_OBJECT) {
+    typed(json_object) *object = element->value.as_object;
+
+    for (size_t i = 0; i < object->count; i++) {
+      if (keys->count == keys->capacity) {
+        keys->capacity = keys->capacity == 0 ? 64 : keys->capacity * 2;
+        keys->keys =
+            realloc(keys->keys, keys->capacity * sizeof(struct bench_key));
+      }
+      keys->keys[keys->count].object = object;
+      keys->keys[keys->count].key = object->shape->keys[i].data;
+      keys->count++;
+
+      bench_collect_keys(&object->values[i], keys);
+    }
+  } else if (element->type == JSON_ELEMENT_TYPE_ARRAY) {
+    typed(json_array) *array = element->value.as_array;
+    for (size_t i = 0; i < array->count; i++)
+      bench_collect_keys(&array->elements[i], keys);
+  }
+}
+
+/**
+ * @brief Parses a file, looks up all of its keys, serializes it and
+ * frees it, timing each operation into `latencies` unless it is `NULL`
+ */
+static void bench_corpus_pass(const char *json, size_t len,
+                              struct bench_latencies *latencies,
+                              struct bench_keys *keys,
+                              typed(json_sink) * sink) {
+  struct bench_mark mark;
+
+  bench_mark_now(&mark);
+  result(json_element) element_result = json_parse_n(json, len);
+  bench_record(latencies, BENCH_OP_PARSE, &mark);
+  typed(json_element) element = result_unwrap(json_element)(&element_result);
+
+  keys->count = 0;
+  bench_collect_keys(&element, keys);
+
+  bench_mark_now(&mark);
+  for (size_t i = 0; i < keys->count; i++)
+    json_object_find(keys->keys[i].object, keys->keys[i].key);
+  bench_record(latencies, BENCH_OP_LOOKUP, &mark);
+
+  bench_mark_now(&mark);
+  sink->len = 0;
+  json_serialize(&element, 0, sink);
+  bench_record(latencies, BENCH_OP_SERIALIZE, &mark);
+
+  bench_mark_now(&mark);
+  json_free(&element);
+  bench_record(latencies, BENCH_OP_FREE, &mark);
+
+  if (latencies != NULL) {
+    latencies[BENCH_OP_PARSE].ops = 1;
+    latencies[BENCH_OP_LOOKUP].ops = keys->count;
+    latencies[BENCH_OP_SERIALIZE].ops = 1;
+    latencies[BENCH_OP_FREE].ops = 1;
+  }
+}
+
+/**
+ * @brief Compares two latencies for `qsort`
+ */
+static int bench_compare_ns(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief The latency below which `fraction` of the sorted passes are, by
+ * nearest rank
+ */
+static double bench_percentile(const struct bench_latencies *latency,
+                               double fraction) {
+  size_t rank = (size_t)(fraction * (double)latency->count + 0.999999);
+  return latency->ns[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * @brief Reports the passes of an operation on a file, as a row of the
+ * table or as an object written to `writer` if it is not `NULL`
+ */
+static void bench_report(const char *name, size_t len, enum bench_op op,
+                         struct bench_latencies *latency,
+                         typed(json_writer) * writer) {
+  qsort(latency->ns, latency->count, sizeof(double), bench_compare_ns);
+
+  double total = 0;
+  for (size_t i = 0; i < latency->count; i++)
+    total += latency->ns[i];
+
+  double mean = total / (double)latency->count;
+  double mb_per_s = (double)len / mean * 1e3;
+  double ns_per_op = mean / (double)latency->ops;
+  double p50 = bench_percentile(latency, 0.50);
+  double p99 = bench_percentile(latency, 0.99);
+  size_t unused;
+  bool counted = bench_allocated(&unused, &unused);
+
+  // Looking keys up does not go through the input
+  bool has_throughput = op != BENCH_OP_LOOKUP;
+
+  if (writer == NULL) {
+    char throughput[32] = "-";
+    char allocations[32] = "-";
+    char allocated_bytes[32] = "-";
+    if (has_throughput)
+      snprintf(throughput, sizeof(throughput), "%.1f", mb_per_s);
+    if (counted) {
+      snprintf(allocations, sizeof(allocations), "%zu",
+               latency->allocations);
+      snprintf(allocated_bytes, sizeof(allocated_bytes), "%zu",
+               latency->allocated_bytes);
+    }
+
+    printf("%-20s %-10s %10zu %8zu %10s %10.1f %12.0f %12.0f %10s %12s\n",
+           name, bench_op_names[op], latency->ops, latency->count,
+           throughput, ns_per_op, p50, p99, allocations, allocated_bytes);
+    return;
+  }
+
+  json_writer_begin_object(writer);
+  json_writer_key(writer, "file");
+  json_writer_string(writer, name);
+  json_writer_key(writer, "op");
+  json_writer_string(writer, bench_op_names[op]);
+  json_writer_key(writer, "bytes");
+  json_writer_long(writer, (long)len);
+  json_writer_key(writer, "ops_per_pass");
+  json_writer_long(writer, (long)latency->ops);
+  json_writer_key(writer, "passes");
+  json_writer_long(writer, (long)latency->count);
+  json_writer_key(writer, "mb_per_s");
+  if (has_throughput)
+    json_writer_double(writer, mb_per_s);
+  else
+    json_writer_null(writer);
+  json_writer_key(writer, "ns_per_op");
+  json_writer_double(writer, ns_per_op);
+  json_writer_key(writer, "p50_ns");
+  json_writer_double(writer, p50);
+  json_writer_key(writer, "p99_ns");
+  json_writer_double(writer, p99);
+  json_writer_key(writer, "allocations");
+  if (counted)
+    json_writer_long(writer, (long)latency->allocations);
+  else
+    json_writer_null(writer);
+  json_writer_key(writer, "allocated_bytes");
+  if (counted)
+    json_writer_long(writer, (long)latency->allocated_bytes);
+  else
+    json_writer_null(writer);
+  json_writer_end_object(writer);
+}
+
+/**
+ * @brief Compares two file names for `qsort`
+ */
+static int bench_compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Runs parse, lookup, serialize and free on every JSON file of a
+ * directory, warming up before timing every pass. Reports the mean,
+ * median and 99th percentile of each, either as a table or as JSON
+ */
+static void bench_corpus(const char *directory, bool json_output) {
+  DIR *dir = opendir(directory);
+  if (dir == NULL) {
+    fprintf(stderr, "Expected directory \"%s\" not found\n", directory);
+    return;
+  }
+
+  char **names = NULL;
+  size_t name_count = 0;
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    size_t name_len = strlen(entry->d_name);
+    if (name_len < 5 || strcmp(entry->d_name + name_len - 5, ".json") != 0)
+      continue;
+
+    names = realloc(names, (name_count + 1) * sizeof(char *));
+    names[name_count] = malloc(name_len + 1);
+    memcpy(names[name_count++], entry->d_name, name_len + 1);
+  }
+  closedir(dir);
+
+  // Listed in a fixed order so that runs can be compared line by line
+  qsort(names, name_count, sizeof(char *), bench_compare_names);
+
+  typed(json_sink) output = json_sink_make(json_sink_write_file, stdout);
+  typed(json_writer) writer = json_writer_make(&output, 2);
+
+  if (json_output) {
+    json_writer_begin_object(&writer);
+    json_writer_key(&writer, "directory");
+    json_writer_string(&writer, directory);
+    json_writer_key(&writer, "warmup_seconds");
+    json_writer_double(&writer, BENCH_WARMUP_SECONDS);
+    json_writer_key(&writer, "min_seconds");
+    json_writer_double(&writer, BENCH_MIN_SECONDS);
+    json_writer_key(&writer, "results");
+    json_writer_begin_array(&writer);
+  } else {
+    printf("Corpus (ns, per pass unless per op)\n");
+    printf("%-20s %-10s %10s %8s %10s %10s %12s %12s %10s %12s\n", "file",
+           "op", "ops/pass", "passes", "MB/s", "ns/op", "p50", "p99",
+           "allocs", "alloc bytes");
+  }
+
+  struct bench_keys keys = {0};
+  typed(json_sink) sink = json_sink_make(NULL, NULL);
+
+  for (size_t i = 0; i < name_count; i++) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", directory, names[i]);
+
+    size_t len;
+    char *json = bench_read_file(path, &len);
+    if (json == NULL)
+      continue;
+
+    result(json_element) check = json_parse_n(json, len);
+    if (result_is_err(json_element)(&check)) {
+      fprintf(stderr, "Skipping \"%s\": %s\n", path,
+              json_error_to_string(result_unwrap_err(json_element)(&check)));
+      free(json);
+      continue;
+    }
+    typed(json_element) checked = result_unwrap(json_element)(&check);
+    json_free(&checked);
+
+    struct bench_latencies latencies[BENCH_OP_COUNT] = {{0}};
+    double start = bench_wall_seconds();
+
+    // Passes of the warm-up are run the same way, only not recorded
+    for (;;) {
+      double elapsed = bench_wall_seconds() - start;
+      bool warm = elapsed >= BENCH_WARMUP_SECONDS;
+      if (warm && latencies[0].count >= BENCH_MIN_PASSES &&
+          elapsed >= BENCH_WARMUP_SECONDS + BENCH_MIN_SECONDS)
+        break;
+
+      bench_corpus_pass(json, len, warm ? latencies : NULL, &keys, &sink);
+    }
+
+    for (int op = 0; op < BENCH_OP_COUNT; op++) {
+      // Files without objects have no keys to look up
+      if (latencies[op].ops != 0)
+        bench_report(names[i], len, (enum bench_op)op, &latencies[op],
+                     json_output ? &writer : NULL);
+      free(latencies[op].ns);
+    }
+
+    free(json);
+  }
+
+  if (json_output) {
+    json_writer_end_array(&writer);
+    json_writer_end_object(&writer);
+    json_writer_finish(&writer);
+    printf("\n");
+  } else {
+    printf("\n");
+  }
+
+  json_sink_free(&sink);
+  json_sink_free(&output);
+  free(keys.keys);
+  for (size_t i = 0; i < name_count; i++)
+    free(names[i]);
+  free(names);
+}
+
+int main(int argc, char **argv) {
+  const char *directory = "../sample";
+  bool corpus_only = false;
+  bool json_output = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--corpus") == 0) {
+      corpus_only = true;
+    } else if (strcmp(argv[i], "--json") == 0) {
+      // Only the corpus is reported in a machine-readable form
+      corpus_only = true;
+      json_output = true;
+    } else {
+      directory = argv[i];
+    }
+  }
+
+  bench_corpus(directory, json_output);
+  if (corpus_only)
+    return 0;
+
+  bench_samples(directory);
+  bench_whitespace(directory);
+  bench_paths(directory);
+  bench_cursor(directory);
+  bench_push(directory);
+  bench_lines(directory);
+  bench_parallel(directory);
+  bench_serialize(directory);
+  bench_writer();
+  bench_numbers();
+  bench_lookup();
+  bench_records();
+  bench_nesting();
+  bench_tape(directory);
+  bench_array_scaling("Array of numbers", "%zu");
+  bench_array_scaling("Array of objects", "{\"id\":%zu,\"name\":\"item%zu\"}");
+
+  return 0;
+}
@@ -1,25 +1,37 @@
 #include "json.h"
 
 #include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <locale.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#ifndef JSON_NO_THREADS
+#include <pthread.h>
+#endif
+
+#if !defined(JSON_NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define JSON_SIMD_X86
+#include <immintrin.h>
+#endif
+
 /**
  * @brief Determines whether a character `ch` is whitespace
  */
 #define is_whitespace(ch) (ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t')
 
-#ifdef JSON_SKIP_WHITESPACE
-void json_skip_whitespace(typed(json_string) * str_ptr) {
-  while (is_whitespace(**str_ptr))
-    (*str_ptr)++;
-}
-#else
-#define json_skip_whitespace(arg)
-#endif
+/**
+ * @brief Determines whether a character `ch` is a decimal digit
+ */
+#define is_digit(ch) ((ch) >= '0' && (ch) <= '9')
 
 #ifdef JSON_DEBUG
 #define log(str, ...) printf(str "\n", ##__VA_ARGS__)
@@ -89,1010 +101,7726 @@ void json_debug_print(typed(json_string) str, typed(size) len) {
 #define reallocN(ptr, type, count) (type *)realloc(ptr, (count) * sizeof(type))
 
 /**
- * @brief Parses a JSON element {json_element_t} and moves the string
- * pointer to the end of the parsed element
+ * @brief Key lengths stored in the slots of a shape saturate at the
+ * largest 32-bit length
  */
-static result(json_entry) json_parse_entry(typed(json_string) *);
+#define json_slot_key_len(len)                                                 \
+  ((typed(uint32))((len) < UINT32_MAX ? (len) : UINT32_MAX))
 
 /**
- * @brief Guesses the element type at the start of a string
+ * @brief Reports an event to the callback `name` if there is one, which
+ * tells whether to go on
  */
-static result(json_element_type) json_guess_element_type(typed(json_string));
+#define json_emit(callbacks, name, ...)                                        \
+  ((callbacks)->name == NULL || (callbacks)->name(__VA_ARGS__))
 
 /**
- * @brief Whether a token represents a string. Like '"'
+ * @brief Number of bytes reserved for the scratch stack {json_parser_t}
+ * the first time an item is pushed, doubled whenever it runs out
  */
-static bool json_is_string(char);
+#define JSON_STACK_INITIAL_CAPACITY 1024
 
 /**
- * @brief Whether a token represents a number. Like '0'
+ * @brief How deep objects and arrays may nest when a parse is given no
+ * options or leaves `max_depth` at 0
  */
-static bool json_is_number(char);
+#define JSON_DEFAULT_MAX_DEPTH 1024
 
 /**
- * @brief Whether a token represents a object. Like '"'
+ * @brief Number of nested containers `json_free` keeps track of on the
+ * call stack before moving them to the heap, doubled whenever it runs out
  */
-static bool json_is_object(char);
+#define JSON_FREE_STACK_INITIAL_CAPACITY 32
 
 /**
- * @brief Whether a token represents a array. Like '['
+ * @brief Number of nested containers `json_writer_element` keeps track
+ * of on the call stack before moving them to the heap, likewise
  */
-static bool json_is_array(char);
+#define JSON_WRITER_STACK_INITIAL_CAPACITY 32
 
 /**
- * @brief Whether a token represents a boolean. Like 't'
+ * @brief The number of low bits of the word opening a container on a
+ * tape that hold the position one past its end. The bits above them up
+ * to the tag hold the number of its items
  */
-static bool json_is_boolean(char);
+#define JSON_TAPE_END_BITS 40
 
 /**
- * @brief Whether a token represents a null. Like 'n'
+ * @brief The number of items of a container on a tape above which it
+ * is counted by walking it
  */
-static bool json_is_null(char);
+#define JSON_TAPE_COUNT_MAX 0xFFFF
 
 /**
- * @brief Parses a JSON element value {json_element_value_t} based
- * on the `type` parameter passed and moves the string pointer
- * to end of the parsed element
+ * @brief Number of slots of the table of keys {json_key_table_t} of a
+ * document when it is created, doubled whenever it is half full
  */
-static result(json_element_value)
-    json_parse_element_value(typed(json_string) *, typed(json_element_type));
+#define JSON_KEY_TABLE_INITIAL_CAPACITY 256
 
 /**
- * @brief Parses a `String` {json_string_t} and moves the string
- * pointer to the end of the parsed string
+ * @brief Number of slots of the table of shapes {json_shape_table_t} of
+ * a document when it is created, doubled whenever it is half full
  */
-static result(json_element_value) json_parse_string(typed(json_string) *);
+#define JSON_SHAPE_TABLE_INITIAL_CAPACITY 64
 
 /**
- * @brief Parses a `Number` {json_number_t} and moves the string
- * pointer to the end of the parsed number
+ * @brief Number of lines a worker of `json_parse_lines` claims at once
  */
-static result(json_element_value) json_parse_number(typed(json_string) *);
+#define JSON_LINES_BATCH_SIZE 64
 
 /**
- * @brief Parses a `Object` {json_object_t} and moves the string
- * pointer to the end of the parsed object
+ * @brief Number of bytes below which splitting a root array over one
+ * more thread costs more than it saves
  */
-static result(json_element_value) json_parse_object(typed(json_string) *);
-
-static typed(uint64) json_key_hash(typed(json_string));
+#define JSON_PARALLEL_MIN_SLICE_SIZE 65536
 
 /**
- * @brief Parses a `Array` {json_array_t} and moves the string
- * pointer to the end of the parsed array
+ * @brief Number of bytes of the buffer of a push parser
+ * {json_push_parser_t} for a token split across chunks when it is first
+ * needed, doubled whenever it runs out
  */
-static result(json_element_value) json_parse_array(typed(json_string) *);
+#define JSON_PUSH_BUFFER_INITIAL_CAPACITY 64
 
 /**
- * @brief Parses a `Boolean` {json_boolean_t} and moves the string
- * pointer to the end of the parsed boolean
+ * @brief Number of levels of nesting a push parser {json_push_parser_t}
+ * first makes room for, doubled whenever it runs out
  */
-static result(json_element_value) json_parse_boolean(typed(json_string) *);
+#define JSON_PUSH_CONTAINERS_INITIAL_CAPACITY 32
 
 /**
- * @brief Skips a Key-Value pair
- *
- * @return true If a valid entry is skipped
- * @return false If entry was invalid (still skips)
+ * @brief Size of the on-stack copy a number is converted from. Longer
+ * numbers are copied to the heap
  */
-static bool json_skip_entry(typed(json_string) *);
+#define JSON_NUMBER_BUFFER_SIZE 64
 
 /**
- * @brief Skips an element value
- *
- * @return true If a valid element is skipped
- * @return false If element was invalid (still skips)
+ * @brief Most significant digits of a number kept in its 64-bit
+ * mantissa, digits after them only move its exponent
  */
-static bool json_skip_element_value(typed(json_string) *,
-                                    typed(json_element_type));
+#define JSON_MANTISSA_DIGITS 19
 
 /**
- * @brief Skips a string value
- *
- * @return true If a valid string is skipped
- * @return false If string was invalid (still skips)
+ * @brief Exponents of the smallest and largest powers of ten in
+ * {json_powers_of_ten}. Decimal exponents beyond them give a zero or an
+ * infinite double for any 19-digit mantissa, and the largest is also
+ * the one shortest decimals of the smallest subnormals are scaled by
  */
-static bool json_skip_string(typed(json_string) *);
+#define JSON_POWER_OF_TEN_MIN -342
+#define JSON_POWER_OF_TEN_MAX 324
 
 /**
- * @brief Skips a number value
- *
- * @return true If a valid number is skipped
- * @return false If number was invalid (still skips)
+ * @brief Number of bytes a sink {json_sink_t} batches before handing
+ * them to its callback, and the first capacity of one keeping its output
  */
-static bool json_skip_number(typed(json_string) *);
+#define JSON_SINK_BUFFER_SIZE 65536
 
 /**
- * @brief Skips an object value
- *
- * @return true If a valid object is skipped
- * @return false If object was invalid (still skips)
+ * @brief Size of the first block of an arena {json_arena_t} when the
+ * length of the input does not suggest a bigger one
  */
-static bool json_skip_object(typed(json_string) *);
+#define JSON_ARENA_MIN_BLOCK_SIZE 4096
 
 /**
- * @brief Skips an array value
- *
- * @return true If a valid array is skipped
- * @return false If array was invalid (still skips)
+ * @brief Whether whitespace is skipped when a parse is given no options
  */
-static bool json_skip_array(typed(json_string) *);
+#ifdef JSON_SKIP_WHITESPACE
+#define JSON_DEFAULT_SKIP_WHITESPACE true
+#else
+#define JSON_DEFAULT_SKIP_WHITESPACE false
+#endif
 
 /**
- * @brief Skips a boolean value
- *
- * @return true If a valid boolean is skipped
- * @return false If boolean was invalid (still skips)
+ * @brief Alignment of every allocation handed out by an arena
  */
-static bool json_skip_boolean(typed(json_string) *);
+#define JSON_ARENA_ALIGNMENT 8
 
 /**
- * @brief Moves a JSON string pointer beyond any whitespace
+ * @brief Rounds `n` up to the next multiple of {JSON_ARENA_ALIGNMENT}
  */
-// static void json_skip_whitespace_actual(typed(json_string) *);
+#define json_arena_align(n)                                                    \
+  (((n) + JSON_ARENA_ALIGNMENT - 1) & ~(typed(size))(JSON_ARENA_ALIGNMENT - 1))
 
 /**
- * @brief Moves a JSON string pointer beyond `null` literal
- *
+ * @brief Offset of the data following an arena block header
  */
-static void json_skip_null(typed(json_string) *);
+#define JSON_ARENA_BLOCK_HEADER_SIZE                                           \
+  json_arena_align(sizeof(typed(json_arena_block)))
 
 /**
- * @brief Prints a JSON element {json_element_t} type
+ * @brief Push an uninitialized item of `type` on the scratch stack of
+ * the `parser` and return the pointer to it
  */
-static void json_print_element(typed(json_element) *, int, int);
+#define parser_stack_push(parser, type)                                        \
+  (type *)json_parser_stack_push(parser, sizeof(type))
 
 /**
- * @brief Prints a `String` {json_string_t} type
+ * @brief Pointer to the item of `type` at byte offset `mark` of the
+ * scratch stack of the `parser`
  */
-static void json_print_string(typed(json_string));
+#define parser_stack_at(parser, type, mark)                                    \
+  ((type *)((parser)->stack + (mark)))
 
 /**
- * @brief Prints a `Number` {json_number_t} type
+ * @brief Pointer to the frame {json_frame_t} of the innermost container
+ * the `parser` is in
  */
-static void json_print_number(typed(json_number));
+#define parser_frame(parser)                                                   \
+  parser_stack_at(parser, typed(json_frame), (parser)->frame)
 
 /**
- * @brief Prints an `Object` {json_object_t} type
+ * @brief Byte offset on the scratch stack of the `parser` of the first
+ * item of the innermost container it is in, right above its frame
  */
-static void json_print_object(typed(json_object) *, int, int);
+#define parser_frame_items(parser)                                             \
+  ((parser)->frame + json_arena_align(sizeof(typed(json_frame))))
 
 /**
- * @brief Prints an `Array` {json_array_t} type
+ * @brief Allocate `count` number of items of `type` from wherever the
+ * `parser` allocates the document
  */
-static void json_print_array(typed(json_array) *, int, int);
+#define parser_allocN(parser, type, count)                                     \
+  (type *)json_parser_alloc(parser, (count) * sizeof(type))
 
 /**
- * @brief Prints a `Boolean` {json_boolean_t} type
+ * @brief Allocate an item of `type` from wherever the `parser`
+ * allocates the document
  */
-static void json_print_boolean(typed(json_boolean));
+#define parser_alloc(parser, type) parser_allocN(parser, type, 1)
 
 /**
- * @brief Frees a `String` (json_string_t) from memory
+ * @brief Pointer to the frame {json_tape_frame_t} of the innermost
+ * container the tape `builder` is in
  */
-static void json_free_string(typed(json_string));
+#define tape_frame(builder)                                                    \
+  parser_stack_at(&(builder)->parser, typed(json_tape_frame),                  \
+                  (builder)->parser.frame)
 
 /**
- * @brief Frees an `Object` (json_object_t) from memory
+ * @brief A word of a tape made of a tag {json_tape_tag_t} and the
+ * payload below it
  */
-static void json_free_object(typed(json_object) *);
+#define tape_word(tag, payload) (((typed(uint64))(tag) << 56) | (payload))
 
 /**
- * @brief Frees an `Array` (json_array_t) from memory
+ * @brief The tag {json_tape_tag_t} of a word of a tape
  */
-static void json_free_array(typed(json_array) *);
+#define tape_word_tag(word) ((typed(json_tape_tag))((word) >> 56))
 
 /**
- * @brief Utility function to convert an escaped string to a formatted string
+ * @brief The payload of a word of a tape, below its tag
  */
-static result(json_string)
-    json_unescape_string(typed(json_string), typed(size));
+#define tape_word_payload(word) ((word) & ((1ULL << 56) - 1))
+
+typedef struct json_arena_block_s typed(json_arena_block);
+typedef struct json_index_s typed(json_index);
+typedef struct json_key_table_s typed(json_key_table);
+typedef struct json_key_table_slot_s typed(json_key_table_slot);
+typedef struct json_parsed_entry_s typed(json_parsed_entry);
+typedef struct json_frame_s typed(json_frame);
+typedef struct json_free_frame_s typed(json_free_frame);
+typedef struct json_writer_frame_s typed(json_writer_frame);
+typedef struct json_tape_builder_s typed(json_tape_builder);
+typedef struct json_tape_frame_s typed(json_tape_frame);
+typedef struct json_shape_table_s typed(json_shape_table);
+typedef struct json_shape_table_slot_s typed(json_shape_table_slot);
+typedef struct json_parser_s typed(json_parser);
+typedef struct json_lines_job_s typed(json_lines_job);
+typedef struct json_lines_worker_s typed(json_lines_worker);
+typedef struct json_array_slice_s typed(json_array_slice);
 
 /**
- * @brief Offset to the last `"` of a JSON string
+ * @brief A slot of the hash index of a shape {json_shape_t}. Lookups
+ * compare the hash and the length of a key before its characters
  */
-static typed(size) json_string_len(typed(json_string));
+struct json_shape_slot_s {
+  // The high half of the hash of the key, the low half picks the slot
+  typed(uint32) hash;
+  // The length of the key, saturated. Keys are never empty, so 0 means
+  // the slot is empty
+  typed(uint32) key_len;
+  // The position of the key in the shape
+  typed(size) index;
+};
 
-result(json_element) json_parse(typed(json_string) json_str) {
-  if (json_str == NULL) {
-    return result_err(json_element)(JSON_ERROR_EMPTY);
-  }
+/**
+ * @brief A key met while parsing a document whose keys are interned
+ */
+struct json_key_table_slot_s {
+  typed(uint64) hash;
+  // `NULL` if the slot is empty
+  typed(json_string) key;
+  typed(size) key_len;
+};
 
-  typed(size) len = strlen(json_str);
-  if (len == 0) {
-    return result_err(json_element)(JSON_ERROR_EMPTY);
-  }
+/**
+ * @brief The distinct keys of a document, so that every object of the
+ * document shares a single copy of each
+ */
+struct json_key_table_s {
+  // A power of two number of slots, at most half of them taken
+  typed(json_key_table_slot) * slots;
+  typed(size) count;
+  typed(size) capacity;
+};
 
-  result_try(json_element, json_element_type, type,
-             json_guess_element_type(json_str));
-  result_try(json_element, json_element_value, value,
-             json_parse_element_value(&json_str, type));
+/**
+ * @brief An entry collected on the scratch stack, along with the hash
+ * of its key for the index of its object
+ */
+struct json_parsed_entry_s {
+  typed(json_entry) entry;
+  typed(uint64) hash;
+};
 
-  const typed(json_element) element = {
-      .type = type,
-      .value = value,
-  };
+/**
+ * @brief An object or array being parsed, on the scratch stack right
+ * below the items it has collected so far. Frames replace recursion, so
+ * the depth of the input costs no call stack
+ */
+struct json_frame_s {
+  // The offset of the frame of the enclosing container, if any
+  typed(size) parent;
+  // '{' or '['
+  char bracket;
+  typed(size) count;
+  // The number of items made room for up front along the structural
+  // index, 0 otherwise
+  typed(size) capacity;
+  // The final buffer of an array parsed along the structural index, its
+  // elements being parsed right into it. `NULL` otherwise
+  typed(json_element) * elements;
+  // The key of the entry whose value is being parsed, if any
+  typed(json_string_view) key;
+  typed(uint64) hash;
+};
 
-  return result_ok(json_element)(element);
-}
+/**
+ * @brief An object or array of a tree whose values `json_free` is
+ * freeing, before the container itself
+ */
+struct json_free_frame_s {
+  typed(json_element) * values;
+  typed(size) count;
+  typed(size) next;
+  // The allocation the values are part of, and the separate one of the
+  // elements of an array
+  void *container;
+  void *elements;
+};
 
-result(json_entry) json_parse_entry(typed(json_string) * str_ptr) {
-  result_try(json_entry, json_element_value, key, json_parse_string(str_ptr));
-  json_skip_whitespace(str_ptr);
+/**
+ * @brief An object or array of a tree whose values `json_writer_element`
+ * is writing
+ */
+struct json_writer_frame_s {
+  const typed(json_element) * values;
+  // The keys of the values of an object
+  const typed(json_string_view) * keys;
+  typed(size) count;
+  typed(size) next;
+  bool is_object;
+};
 
-  // Skip the ':' delimiter
-  (*str_ptr)++;
+/**
+ * @brief An object or array being written to a tape, on the scratch
+ * stack of the parser like a frame {json_frame_t}
+ */
+struct json_tape_frame_s {
+  // The offset of the frame of the enclosing container, if any
+  typed(size) parent;
+  // '{' or '['
+  char bracket;
+  typed(size) count;
+  // The position of the word opening the container
+  typed(size) open;
+  // The length of the words and of the strings of the tape when the
+  // current item started, to which a failed item is cut back
+  typed(size) item_words;
+  typed(size) item_strings;
+};
 
-  json_skip_whitespace(str_ptr);
+/**
+ * @brief A shape met while parsing a document whose shapes are shared
+ */
+struct json_shape_table_slot_s {
+  // The signature of the keys of the shape, in their order
+  typed(uint64) hash;
+  // `NULL` if the slot is empty
+  typed(json_shape) * shape;
+};
 
-  result(json_element_type) type_result = json_guess_element_type(*str_ptr);
-  if (result_is_err(json_element_type)(&type_result)) {
-    free((void *)key.as_string);
-    return result_map_err(json_entry, json_element_type, &type_result);
-  }
-  typed(json_element_type) type =
-      result_unwrap(json_element_type)(&type_result);
+/**
+ * @brief The distinct shapes of a document, so that objects with the
+ * same keys in the same order share a single one
+ */
+struct json_shape_table_s {
+  // A power of two number of slots, at most half of them taken
+  typed(json_shape_table_slot) * slots;
+  typed(size) count;
+  typed(size) capacity;
+};
 
-  result(json_element_value) value_result =
-      json_parse_element_value(str_ptr, type);
-  if (result_is_err(json_element_value)(&value_result)) {
-    free((void *)key.as_string);
-    return result_map_err(json_entry, json_element_value, &value_result);
-  }
-  typed(json_element_value) value =
-      result_unwrap(json_element_value)(&value_result);
+/**
+ * @brief A chunk of memory from which an arena {json_arena_t} hands out
+ * allocations. The data follows the header. Blocks are chained so that
+ * the whole arena is released by walking the chain once
+ */
+struct json_arena_block_s {
+  typed(json_arena_block) * next;
+  typed(size) capacity;
+  typed(size) used;
+};
 
-  typed(json_entry) entry = {
-      .key = key.as_string,
-      .element =
-          {
-              .type = type,
-              .value = value,
-          },
-  };
+struct json_arena_s {
+  typed(json_arena_block) * head;
+};
 
-  return result_ok(json_entry)(entry);
-}
+/**
+ * @brief Positions of the structural characters of an input: `{}[]:,`
+ * outside of strings and the quotes around every string, in order
+ */
+struct json_index_s {
+  // The input the positions are offsets into
+  typed(json_string) begin;
+  typed(uint32) * positions;
+  // For every '{' and '[', an upper bound of its number of items, i.e.
+  // one more than its commas, or 0 if it holds nothing but whitespace.
+  // For every closing quote, 1 if its string holds a backslash
+  typed(uint32) * sizes;
+  typed(size) count;
+  typed(size) capacity;
+  // The next position the parser has yet to reach
+  typed(size) next;
+};
 
-result(json_element_type) json_guess_element_type(typed(json_string) str) {
-  const char ch = *str;
-  typed(json_element_type) type;
+/**
+ * @brief State shared by every function taking part in a single parse
+ */
+struct json_parser_s {
+  // Where the document is allocated. `NULL` means every allocation is
+  // an individual `malloc` that `json_free` releases
+  typed(json_arena) * arena;
+  // One past the last character of the input. Nothing at or beyond it
+  // is ever read, so the input need not be NUL-terminated
+  typed(json_string) end;
+  // Scratch space on which objects and arrays collect their items
+  // until the closing brace, to then copy them into an exactly sized
+  // buffer. A nested container pops its items before the enclosing one
+  // pushes the next, so a single stack is shared by every level
+  char *stack;
+  typed(size) stack_size;
+  typed(size) stack_capacity;
+  // The offset on the scratch stack of the frame {json_frame_t} of the
+  // innermost container being parsed
+  typed(size) frame;
+  // The number of containers the parser is in, and how many it may be
+  typed(size) depth;
+  typed(size) max_depth;
+  // Whether whitespace between tokens is skipped
+  bool skip_whitespace;
+  // The structural index objects, arrays and strings are parsed with,
+  // unless its positions are `NULL`
+  typed(json_index) index;
+  // Whether strings are unescaped into the input itself, which the
+  // caller passed as mutable
+  bool in_situ;
+  // Whether strings without escapes are left in the input as views
+  bool string_views;
+  // The keys met so far, unless its slots are `NULL`
+  typed(json_key_table) keys;
+  // The shapes met so far, unless its slots are `NULL`. Shapes are only
+  // shared along with the keys, which then compare by pointer
+  typed(json_shape_table) shapes;
+};
 
-  if (json_is_string(ch))
-    type = JSON_ELEMENT_TYPE_STRING;
-  else if (json_is_object(ch))
-    type = JSON_ELEMENT_TYPE_OBJECT;
-  else if (json_is_array(ch))
-    type = JSON_ELEMENT_TYPE_ARRAY;
-  else if (json_is_null(ch))
-    type = JSON_ELEMENT_TYPE_NULL;
-  else if (json_is_number(ch))
-    type = JSON_ELEMENT_TYPE_NUMBER;
-  else if (json_is_boolean(ch))
-    type = JSON_ELEMENT_TYPE_BOOLEAN;
-  else
-    return result_err(json_element_type)(JSON_ERROR_INVALID_TYPE);
+/**
+ * @brief A tape {json_tape_t} being parsed, along with room to grow
+ */
+struct json_tape_builder_s {
+  typed(json_parser) parser;
+  typed(json_tape) tape;
+  typed(size) capacity;
+  typed(size) strings_capacity;
+};
 
-  return result_ok(json_element_type)(type);
-}
+/**
+ * @brief The lines of a single `json_parse_lines` call, shared by all of
+ * its workers
+ */
+struct json_lines_job_s {
+  // The characters of every line, without the line break
+  typed(json_string_view) * spans;
+  result(json_element) * results;
+  typed(size) count;
+  const typed(json_parse_options) * options;
+  // The first line no worker has claimed yet
+  typed(size) next;
+#ifndef JSON_NO_THREADS
+  pthread_mutex_t lock;
+#endif
+};
 
-bool json_is_string(char ch) { return ch == '"'; }
+/**
+ * @brief A worker of `json_parse_lines`, parsing the lines it claims
+ * into an arena of its own
+ */
+struct json_lines_worker_s {
+  typed(json_lines_job) * job;
+  typed(json_arena) * arena;
+};
 
-bool json_is_number(char ch) {
-  return (ch >= '0' && ch <= '9') || ch == '+' || ch == '-' || ch == '.' ||
-         ch == 'e' || ch == 'E';
-}
+/**
+ * @brief A range of the elements of a root array, parsed by a worker of
+ * `json_parse_document_parallel` into an arena of its own
+ */
+struct json_array_slice_s {
+  // Ends where the range does. The elements are left on its scratch
+  // stack to be joined with those of the other ranges
+  typed(json_parser) parser;
+  typed(json_string) begin;
+  typed(size) count;
+  // Whether an element nests deeper than the parse allows, which fails
+  // the whole array rather than only dropping the element
+  bool too_deep;
+};
 
-bool json_is_object(char ch) { return ch == '{'; }
+/**
+ * @brief What a push parser expects next
+ */
+typedef enum json_push_state_e {
+  JSON_PUSH_STATE_VALUE,
+  // Right after '['
+  JSON_PUSH_STATE_VALUE_OR_END,
+  JSON_PUSH_STATE_KEY,
+  // Right after '{'
+  JSON_PUSH_STATE_KEY_OR_END,
+  JSON_PUSH_STATE_COLON,
+  JSON_PUSH_STATE_COMMA_OR_END,
+  // The root element is complete
+  JSON_PUSH_STATE_DONE,
+  // A callback stopped the parse
+  JSON_PUSH_STATE_STOPPED,
+  JSON_PUSH_STATE_FAILED,
+} typed(json_push_state);
 
-bool json_is_array(char ch) { return ch == '['; }
+/**
+ * @brief The token a push parser is in, if any
+ */
+typedef enum json_push_token_e {
+  JSON_PUSH_TOKEN_NONE,
+  JSON_PUSH_TOKEN_STRING,
+  JSON_PUSH_TOKEN_NUMBER,
+  // `true`, `false` or `null`
+  JSON_PUSH_TOKEN_LITERAL,
+} typed(json_push_token);
+
+struct json_push_parser_s {
+  const typed(json_callbacks) * callbacks;
+  void *userdata;
+  // Skips whitespace and unescapes strings. Its end is that of the chunk
+  // being fed
+  typed(json_parser) parser;
+  typed(json_push_state) state;
+  // Why the parse failed, once it has
+  typed(json_error) error;
+  // The bracket opening every object and array the parser is in
+  char *containers;
+  typed(size) depth;
+  typed(size) containers_capacity;
+  typed(json_push_token) token;
+  // Whether the string being read is a key
+  bool is_key;
+  // Whether the string being read holds an escape
+  bool escaped;
+  // Whether the previous chunk ended with the '\\' of an escape
+  bool escape_pending;
+  // The characters of a token split across chunks, so far
+  char *buffer;
+  typed(size) buffer_len;
+  typed(size) buffer_capacity;
+};
 
-bool json_is_boolean(char ch) { return ch == 't' || ch == 'f'; }
+/**
+ * @brief The character at `str`, or '\0' once the end of the input of
+ * the `parser` is reached
+ */
+#define json_peek(parser, str) ((str) < (parser)->end ? *(str) : '\0')
 
-bool json_is_null(char ch) { return ch == 'n'; }
+/**
+ * @brief Moves a JSON string pointer beyond a run of whitespace that
+ * starts with at least one whitespace character
+ */
+static void json_skip_whitespace_run(typed(json_parser) *,
+                                     typed(json_string) *);
 
-result(json_element_value)
-    json_parse_element_value(typed(json_string) * str_ptr,
-                             typed(json_element_type) type) {
-  switch (type) {
-  case JSON_ELEMENT_TYPE_STRING:
-    return json_parse_string(str_ptr);
-  case JSON_ELEMENT_TYPE_NUMBER:
-    return json_parse_number(str_ptr);
-  case JSON_ELEMENT_TYPE_OBJECT:
-    return json_parse_object(str_ptr);
-  case JSON_ELEMENT_TYPE_ARRAY:
-    return json_parse_array(str_ptr);
-  case JSON_ELEMENT_TYPE_BOOLEAN:
-    return json_parse_boolean(str_ptr);
-  case JSON_ELEMENT_TYPE_NULL:
-    json_skip_null(str_ptr);
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
-  default:
-    return result_err(json_element_value)(JSON_ERROR_INVALID_TYPE);
-  }
+/**
+ * @brief Moves a JSON string pointer beyond any whitespace, if the
+ * `parser` skips whitespace at all. Minified input only pays for one
+ * comparison here
+ */
+static inline void json_skip_whitespace(typed(json_parser) * parser,
+                                        typed(json_string) * str_ptr) {
+  if (parser->skip_whitespace && *str_ptr < parser->end &&
+      is_whitespace(**str_ptr))
+    json_skip_whitespace_run(parser, str_ptr);
 }
 
-result(json_element_value) json_parse_string(typed(json_string) * str_ptr) {
-  // Skip the first '"' character
-  (*str_ptr)++;
-
-  typed(size) len = json_string_len(*str_ptr);
-  if (len == 0) {
-    // Skip the end quote
-    (*str_ptr)++;
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
-  }
+/**
+ * @brief Moves the string pointer beyond the current character, unless
+ * the end of the input is already reached
+ */
+static void json_skip_char(typed(json_parser) *, typed(json_string) *);
 
-  result_try(json_element_value, json_string, output,
-             json_unescape_string(*str_ptr, len));
+/**
+ * @brief Creates an empty arena whose first block can hold at least
+ * `size_hint` bytes
+ */
+static typed(json_arena) * json_arena_new(typed(size));
 
-  // Skip to beyond the string
-  (*str_ptr) += len + 1;
+/**
+ * @brief Allocates memory from an arena, adding a block when the
+ * current one is exhausted
+ */
+static void *json_arena_alloc(typed(json_arena) *, typed(size));
 
-  typed(json_element_value) retval = {0};
-  retval.as_string = output;
 
-  return result_ok(json_element_value)(retval);
-}
+/**
+ * @brief Frees every block of an arena along with the arena itself
+ */
+static void json_arena_free(typed(json_arena) *);
 
-result(json_element_value) json_parse_number(typed(json_string) * str_ptr) {
-  typed(json_string) temp_str = *str_ptr;
-  bool has_decimal = false;
+/**
+ * @brief Allocates memory for the document being parsed
+ */
+static void *json_parser_alloc(typed(json_parser) *, typed(size));
 
-  while (json_is_number(*temp_str)) {
-    if (*temp_str == '.') {
-      has_decimal = true;
-    }
+/**
+ * @brief Reserves `size` bytes on top of the scratch stack of the parser,
+ * growing it geometrically. Pointers into the stack are invalidated, so
+ * items are addressed by their offset from the bottom
+ */
+static void *json_parser_stack_push(typed(json_parser) *, typed(size));
 
-    temp_str++;
-  }
+/**
+ * @brief Frees memory of the document being parsed. A no-op when the
+ * document lives in an arena
+ */
+static void json_parser_free(typed(json_parser) *, void *);
 
-  typed(json_number) number = {0};
-  typed(json_number_value) val = {0};
+/**
+ * @brief Parses `len` characters of input into a document with
+ * `options`, unescaping strings in place when `in_situ`
+ */
+static result(json_document)
+    json_parse_document_into(typed(json_string), typed(size),
+                             const typed(json_parse_options) *, bool in_situ);
 
-  if (has_decimal) {
-    errno = 0;
+/**
+ * @brief Prepares a parse of `len` characters of input with `options`,
+ * allocating the document from `arena` unless it is `NULL`
+ */
+static void json_parser_init(typed(json_parser) *, typed(json_string),
+                             typed(size), const typed(json_parse_options) *,
+                             typed(json_arena) *);
 
-    val.as_double = strtod(*str_ptr, (char **)str_ptr);
+/**
+ * @brief Releases the scratch memory of a finished parse
+ */
+static void json_parser_finish(typed(json_parser) *);
 
-    number.type = JSON_NUMBER_TYPE_DOUBLE;
-    number.value = val;
+/**
+ * @brief Builds the structural index of `len` characters of input.
+ * Returns false, leaving no index behind, if the input is too long to
+ * index or its brackets or quotes do not balance
+ */
+static bool json_index_build(typed(json_parser) *, typed(json_index) *,
+                             typed(json_string), typed(size));
 
-    if (errno == EINVAL || errno == ERANGE)
-      return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
-  } else {
-    errno = 0;
+/**
+ * @brief Checks that the brackets of an index nest properly and fills
+ * in the size of every container
+ */
+static bool json_index_measure(typed(json_parser) *, typed(json_index) *);
 
-    val.as_long = strtol(*str_ptr, (char **)str_ptr, 10);
+/**
+ * @brief Marks the characters of a block escaped by a backslash.
+ * `carry` tells whether the previous block ended in an unfinished
+ * escape, and is updated for the next block
+ */
+static typed(uint64) json_block_escaped(typed(uint64), typed(uint64) *);
 
-    number.type = JSON_NUMBER_TYPE_LONG;
-    number.value = val;
+/**
+ * @brief Sets every bit that has an odd number of set bits at or below
+ * it, which marks the insides of strings given their quotes
+ */
+static typed(uint64) json_prefix_xor(typed(uint64));
 
-    if (errno == EINVAL || errno == ERANGE)
-      return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
-  }
+/**
+ * @brief The position of the lowest set bit of a word, which must not be
+ * 0
+ */
+static int json_ctz64(typed(uint64));
 
-  typed(json_element_value) retval = {0};
-  retval.as_number = number;
+/**
+ * @brief Frees the positions and sizes of a structural index
+ */
+static void json_index_free(typed(json_index) *);
 
-  return result_ok(json_element_value)(retval);
-}
+/**
+ * @brief Moves the index beyond the rest of the current item of a
+ * container, up to the next ',' or the closing bracket on its level
+ */
+static void json_index_skip_item(typed(json_index) *);
 
-result(json_element_value) json_parse_object(typed(json_string) * str_ptr) {
-  typed(json_string) temp_str = *str_ptr;
+/**
+ * @brief Parses the root JSON element {json_element_t} of a string
+ */
+static result(json_element) json_parse_root(typed(json_parser) *,
+                                            typed(json_string));
 
-  // ******* First find the number of valid entries *******
-  // Skip the first '{' character
-  temp_str++;
+/**
+ * @brief Guesses the element type at the start of a string
+ */
+static result(json_element_type)
+    json_guess_element_type(typed(json_parser) *, typed(json_string));
 
-  json_skip_whitespace(&temp_str);
+/**
+ * @brief Whether a token represents a string. Like '"'
+ */
+static bool json_is_string(char);
 
-  if (*temp_str == '}') {
-    // Skip the end '}' in the actual pointer
-    (*str_ptr) = temp_str + 1;
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
-  }
+/**
+ * @brief Whether a token represents a number. Like '0'
+ */
+static bool json_is_number(char);
 
-  typed(size) count = 0;
+/**
+ * @brief Whether a token represents a object. Like '"'
+ */
+static bool json_is_object(char);
 
-  while (*temp_str != '\0') {
-    // Skip any accidental whitespace
-    json_skip_whitespace(&temp_str);
+/**
+ * @brief Whether a token represents a array. Like '['
+ */
+static bool json_is_array(char);
 
-    // If the entry could be skipped
-    if (json_skip_entry(&temp_str)) {
-      count++;
-    }
+/**
+ * @brief Whether a token represents a boolean. Like 't'
+ */
+static bool json_is_boolean(char);
+
+/**
+ * @brief Whether a token represents a null. Like 'n'
+ */
+static bool json_is_null(char);
+
+/**
+ * @brief Parses a JSON element value {json_element_value_t} based
+ * on the `type` parameter passed and moves the string pointer
+ * to end of the parsed element
+ */
+static result(json_element_value)
+    json_parse_element_value(typed(json_parser) *, typed(json_string) *,
+                             typed(json_element_type));
+
+/**
+ * @brief Parses a `String` {json_string_t} and moves the string
+ * pointer to the end of the parsed string. Parses a key instead when
+ * `key_hash` is not `NULL`, storing its hash there
+ */
+static result(json_element_value) json_parse_string(typed(json_parser) *,
+                                                    typed(json_string) *,
+                                                    typed(uint64) * key_hash);
+
+/**
+ * @brief Makes the string value of the `len` characters of a JSON
+ * string, unescaping them if the string is `escaped`
+ */
+static result(json_element_value)
+    json_string_value(typed(json_parser) *, typed(json_string), typed(size),
+                      bool);
+
+/**
+ * @brief Makes the key of the `len` characters of a JSON string and
+ * stores its hash. When keys are interned, a key met before is not made
+ * again but shared
+ */
+static result(json_element_value)
+    json_key_value(typed(json_parser) *, typed(json_string), typed(size),
+                   bool, typed(uint64) *);
+
+/**
+ * @brief The slot of a table of keys holding the `len` characters of a
+ * key of hash `hash`, or the empty slot where it belongs
+ */
+static typed(json_key_table_slot) *
+    json_key_table_find(typed(json_key_table) *, typed(json_string),
+                        typed(size), typed(uint64));
+
+/**
+ * @brief Doubles the number of slots of a table of keys
+ */
+static void json_key_table_grow(typed(json_key_table) *);
+
+/**
+ * @brief Parses a `String` {json_string_t} whose quotes are the next
+ * two positions of the structural index, or a key when `key_hash` is not
+ * `NULL`
+ */
+static result(json_element_value)
+    json_parse_string_indexed(typed(json_parser) *, typed(json_string) *,
+                              typed(uint64) * key_hash);
+
+/**
+ * @brief Parses a `Number` {json_number_t} and moves the string
+ * pointer to the end of the parsed number
+ */
+static result(json_element_value) json_parse_number(typed(json_parser) *,
+                                                    typed(json_string) *);
+
+/**
+ * @brief Converts a decimal `mantissa` times ten to the power of
+ * `exponent` to the nearest double, unless digits beyond the mantissa
+ * were `truncated` in a way that could change the rounding
+ *
+ * @return false If the number needs the slow exact conversion
+ */
+static bool json_decimal_to_double(typed(uint64), typed(int64), bool, bool,
+                                   double *);
+
+/**
+ * @brief Rounds a decimal `mantissa` times ten to the power of
+ * `exponent` to the nearest double with the Eisel-Lemire algorithm
+ *
+ * @return false If the product is too close to halfway between two
+ * doubles, or the result is not a normal double
+ */
+static bool json_eisel_lemire(typed(uint64), typed(int64), bool, double *);
+
+/**
+ * @brief Multiplies two 64-bit integers into a 128-bit product. Returns
+ * its low half and stores its high half
+ */
+static typed(uint64) json_multiply_128(typed(uint64), typed(uint64),
+                                       typed(uint64) *);
+
+/**
+ * @brief Converts the number between a string pointer and `end` with
+ * `strtod`, with the decimal point of the C locale whatever the current
+ * one is
+ *
+ * @return false If the number is too large for a double. Numbers too
+ * small for one are rounded to a subnormal or to zero
+ */
+static bool json_strtod(typed(json_string), typed(json_string), double *);
+
+/**
+ * @brief Parses a `Object` {json_object_t} or an `Array` {json_array_t}
+ * and moves the string pointer to the end of it. Nested containers are
+ * parsed in the same loop, each on a frame {json_frame_t} of the scratch
+ * stack, walking the structural index if there is one
+ */
+static result(json_element_value)
+    json_parse_container(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Moves the string pointer beyond the opening bracket of a
+ * container and pushes a frame for it, unless the container is empty
+ *
+ * @return true If a frame was pushed
+ * @return false If the container is empty (still skips it)
+ */
+static bool json_frame_open(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Moves the structural index beyond the opening bracket of a
+ * container and pushes a frame for it, unless the container is empty
+ *
+ * @return true If a frame was pushed
+ * @return false If the container is empty (still skips it)
+ */
+static bool json_frame_open_indexed(typed(json_parser) *,
+                                    typed(json_string) *);
+
+/**
+ * @brief Pushes a frame for a container opened by `bracket`, with room
+ * made for `capacity` items up front
+ */
+static void json_frame_push(typed(json_parser) *, char, typed(size),
+                            typed(json_element) *);
+
+/**
+ * @brief Parses the items of the innermost container into its frame,
+ * going on after the nested container just added if `resume`
+ *
+ * @return true If stopped at a nested container, left to be opened
+ * @return false If the closing bracket was reached (and skipped)
+ */
+static bool json_frame_items(typed(json_parser) *, typed(json_string) *,
+                             bool);
+
+/**
+ * @brief Parses the items of the innermost container into its frame by
+ * walking the structural index, like `json_frame_items`
+ */
+static bool json_frame_items_indexed(typed(json_parser) *,
+                                     typed(json_string) *, bool);
+
+/**
+ * @brief Parses an item of the innermost container. A scalar value is
+ * added to its frame, while the key of a nested container is kept there
+ *
+ * @return true If the value is a nested container, left to be opened
+ */
+static bool json_frame_item(typed(json_parser) *, typed(json_string) *,
+                            bool);
+
+/**
+ * @brief Parses the item of the innermost container at the next position
+ * of the structural index, like `json_frame_item`
+ */
+static bool json_frame_item_indexed(typed(json_parser) *,
+                                    typed(json_string) *, bool);
+
+/**
+ * @brief Adds a value to the innermost container, under the key kept in
+ * its frame if it is an object. A failed value drops the entry
+ */
+static void json_frame_add(typed(json_parser) *, typed(json_element_type),
+                           result(json_element_value));
+
+/**
+ * @brief Makes the value of the innermost container out of its items
+ * and pops its frame
+ */
+static result(json_element_value) json_frame_close(typed(json_parser) *,
+                                                   typed(json_element_type) *);
+
+/**
+ * @brief Pops every frame of a parse beyond `depth`, freeing what their
+ * items hold, to fail with a {JSON_ERROR_TOO_DEEP} error
+ */
+static result(json_element_value) json_frame_unwind(typed(json_parser) *,
+                                                    typed(size));
+
+/**
+ * @brief Makes an object {json_object_t} of `count` parsed entries,
+ * sharing the shape of an earlier object with the same keys or hashing
+ * them into a shape of its own
+ */
+static typed(json_object) *
+    json_object_build(typed(json_parser) *, typed(json_parsed_entry) *,
+                      typed(size));
+
+/**
+ * @brief Fills the keys and the hash index of a shape with `count`
+ * parsed entries
+ */
+static void json_shape_index(typed(json_shape) *, typed(json_parsed_entry) *,
+                             typed(size));
+
+/**
+ * @brief The signature of `count` parsed entries, which depends on the
+ * hash of every key and on their order
+ */
+static typed(uint64) json_shape_signature(typed(json_parsed_entry) *,
+                                          typed(size));
+
+/**
+ * @brief The slot of a table of shapes holding the shape of `count`
+ * parsed entries of signature `hash`, or the empty slot where it belongs
+ */
+static typed(json_shape_table_slot) *
+    json_shape_table_find(typed(json_shape_table) *,
+                          typed(json_parsed_entry) *, typed(size),
+                          typed(uint64));
+
+/**
+ * @brief Doubles the number of slots of a table of shapes
+ */
+static void json_shape_table_grow(typed(json_shape_table) *);
+
+/**
+ * @brief The number of slots of the hash index of a shape of `count`
+ * keys, the smallest power of two at most 3/4 full and with at least one
+ * slot empty
+ */
+static typed(size) json_shape_capacity(typed(size));
+
+/**
+ * @brief Looks up the first slot of a shape with the `len` characters
+ * of a key of hash `hash`, or returns `NULL`
+ */
+static typed(json_shape_slot) *
+    json_shape_lookup(typed(json_shape) *, typed(json_string), typed(size),
+                      typed(uint64));
+
+/**
+ * @brief Writes the container at the string pointer to a tape, along
+ * with everything nested in it, and moves the string pointer beyond it.
+ * Follows `json_parse_container` item by item
+ */
+static result(json_boolean) json_tape_container(typed(json_tape_builder) *,
+                                                typed(json_string) *);
+
+/**
+ * @brief Moves the string pointer beyond the opening bracket of a
+ * container and writes the word opening it, unless it is empty
+ *
+ * @return true If a frame was pushed
+ * @return false If the container is empty (still skips it)
+ */
+static bool json_tape_open(typed(json_tape_builder) *, typed(json_string) *);
+
+/**
+ * @brief Writes the items of the innermost container, going on after
+ * the nested container just added if `resume`, like `json_frame_items`
+ *
+ * @return true If stopped at a nested container, left to be opened
+ * @return false If the closing bracket was reached (and skipped)
+ */
+static bool json_tape_items(typed(json_tape_builder) *, typed(json_string) *,
+                            bool);
+
+/**
+ * @brief Writes an item of the innermost container, like
+ * `json_frame_item`. The key of a nested container stays on the tape
+ *
+ * @return true If the value is a nested container, left to be opened
+ */
+static bool json_tape_item(typed(json_tape_builder) *, typed(json_string) *,
+                           bool);
+
+/**
+ * @brief Counts the value just written in the innermost container, or
+ * cuts the tape back to the start of its item if it failed
+ */
+static void json_tape_add(typed(json_tape_builder) *, result(json_boolean));
+
+/**
+ * @brief Writes the word closing the innermost container, or removes
+ * the container if it has no items, and pops its frame
+ */
+static result(json_boolean) json_tape_close(typed(json_tape_builder) *);
+
+/**
+ * @brief Writes a value of `type` to a tape and moves the string pointer
+ * beyond it, like `json_parse_element_value`
+ */
+static result(json_boolean)
+    json_tape_element_value(typed(json_tape_builder) *, typed(json_string) *,
+                            typed(json_element_type));
+
+/**
+ * @brief Writes the string or key at the string pointer to a tape with
+ * the tag `tag`, like `json_parse_string`
+ */
+static result(json_boolean) json_tape_string(typed(json_tape_builder) *,
+                                             typed(json_string) *,
+                                             typed(json_tape_tag));
+
+/**
+ * @brief Appends a word to a tape, growing it as needed
+ */
+static void json_tape_push(typed(json_tape_builder) *, typed(uint64));
+
+/**
+ * @brief The position on a tape right after the value at `index`
+ */
+static typed(size) json_tape_skip(const typed(json_tape) *, typed(size));
+
+/**
+ * @brief Looks up the value of the first entry of an object on a tape
+ * with the `len` characters of a key
+ */
+static result(json_tape_value) json_tape_find(typed(json_tape_value),
+                                              typed(json_string), typed(size));
+
+/**
+ * @brief Parses a `Boolean` {json_boolean_t} and moves the string
+ * pointer to the end of the parsed boolean
+ */
+static result(json_element_value) json_parse_boolean(typed(json_parser) *,
+                                                     typed(json_string) *);
+
+/**
+ * @brief Skips the ':' after the key of an entry and the value after it
+ *
+ * @return true If a valid value is skipped
+ * @return false If value was invalid (still skips)
+ */
+static bool json_skip_entry_value(typed(json_parser) *,
+                                  typed(json_string) *);
+
+/**
+ * @brief Skips an element value
+ *
+ * @return true If a valid element is skipped
+ * @return false If element was invalid (still skips)
+ */
+static bool json_skip_element_value(typed(json_parser) *, typed(json_string) *,
+                                    typed(json_element_type));
+
+/**
+ * @brief Skips a string value
+ *
+ * @return true If a valid string is skipped
+ * @return false If string was invalid (still skips)
+ */
+static bool json_skip_string(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Skips a number value
+ *
+ * @return true If a valid number is skipped
+ * @return false If number was invalid (still skips)
+ */
+static bool json_skip_number(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Skips an object or array value. The brackets of the containers
+ * nested in it are kept on the scratch stack rather than recursed into
+ *
+ * @return true If a valid container holding a valid item is skipped
+ * @return false If container was invalid or empty (still skips)
+ */
+static bool json_skip_container(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Skips the items of the innermost container being skipped, going
+ * on after the nested container just skipped if `resume`. `kept` is set
+ * once a valid item is skipped
+ *
+ * @return true If stopped at a nested container, left to be opened
+ * @return false If the closing bracket was reached (and skipped)
+ */
+static bool json_skip_items(typed(json_parser) *, typed(json_string) *, bool,
+                            bool *);
+
+/**
+ * @brief Skips an object or array nested deeper than a parse allows by
+ * matching its brackets outside of strings, without any recursion
+ */
+static void json_skip_brackets(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Skips a boolean value
+ *
+ * @return true If a valid boolean is skipped
+ * @return false If boolean was invalid (still skips)
+ */
+static bool json_skip_boolean(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Length of the `true` or `false` literal at the start of a
+ * string, or 0 if neither is there in full
+ */
+static typed(size) json_boolean_len(typed(json_parser) *, typed(json_string));
+
+/**
+ * @brief Moves a JSON string pointer beyond `null` literal
+ *
+ */
+static void json_skip_null(typed(json_parser) *, typed(json_string) *);
+
+/**
+ * @brief Finds the element a segment of a path refers to in the element
+ * at `str`, skipping over the ones before it
+ *
+ * @return The start of the element found
+ */
+static result(json_string) json_path_step(typed(json_parser) *,
+                                          typed(json_string),
+                                          const typed(json_path_segment) *);
+
+/**
+ * @brief Finds the value of the first entry of the object at `str` whose
+ * key is that of a segment of a path
+ */
+static result(json_string)
+    json_path_step_object(typed(json_parser) *, typed(json_string),
+                          const typed(json_path_segment) *);
+
+/**
+ * @brief Finds the element of the array at `str` at the index of a
+ * segment of a path
+ */
+static result(json_string)
+    json_path_step_array(typed(json_parser) *, typed(json_string),
+                         const typed(json_path_segment) *);
+
+/**
+ * @brief Whether the element at `str` is kept by the parse, i.e. is
+ * neither null nor empty. Containers are only read up to their first
+ * such item
+ */
+static bool json_path_holds_value(typed(json_parser) *, typed(json_string),
+                                  typed(json_element_type));
+
+/**
+ * @brief Reports the events of the element at a string pointer and moves
+ * the string pointer to its end. The brackets of the containers it is in
+ * are kept on the scratch stack, below the strings being unescaped
+ *
+ * @return Either whether to go on or {json_error_t}
+ */
+static result(json_boolean)
+    json_emit_element(typed(json_parser) *, typed(json_string) *,
+                      const typed(json_callbacks) *, void *);
+
+/**
+ * @brief Reports a value and moves the string pointer past it. An object
+ * or array is only opened, with its first key if any, unless it is empty
+ */
+static result(json_boolean)
+    json_emit_value(typed(json_parser) *, typed(json_string) *,
+                    const typed(json_callbacks) *, void *);
+
+/**
+ * @brief Reports the key of an object entry and moves the string pointer
+ * past the ':' after it
+ */
+static result(json_boolean)
+    json_emit_key(typed(json_parser) *, typed(json_string) *,
+                  const typed(json_callbacks) *, void *);
+
+/**
+ * @brief Reports a string, or a key if `is_key`, unescaped on the
+ * scratch stack, and moves the string pointer to the end of the string
+ */
+static result(json_boolean)
+    json_emit_string(typed(json_parser) *, typed(json_string) *,
+                     const typed(json_callbacks) *, void *, bool);
+
+/**
+ * @brief Reports `len` characters of a string, or of a key if `is_key`,
+ * unescaping them on the scratch stack first if `escaped`
+ */
+static result(json_boolean)
+    json_emit_string_chars(typed(json_parser) *, typed(json_string),
+                           typed(size), bool, const typed(json_callbacks) *,
+                           void *, bool);
+
+/**
+ * @brief Makes a push parser fail or stop for good once a run of it
+ * does, and passes the result of the run on
+ */
+static result(json_boolean) json_push_settle(typed(json_push_parser) *,
+                                             result(json_boolean));
+
+/**
+ * @brief Reports the events of the current chunk of a push parser from
+ * the string pointer on, up to the end of the root element or the chunk
+ */
+static result(json_boolean) json_push_run(typed(json_push_parser) *,
+                                          typed(json_string));
+
+/**
+ * @brief Goes on with the token a push parser is in, from the string
+ * pointer on. Reports the token if it ends in the current chunk, else
+ * buffers the rest of the chunk and moves the string pointer to its end
+ */
+static result(json_boolean) json_push_token(typed(json_push_parser) *,
+                                            typed(json_string) *);
+
+/**
+ * @brief Reports the token a push parser is in, whose last characters
+ * are those from `start` to `end`
+ */
+static result(json_boolean) json_push_token_end(typed(json_push_parser) *,
+                                                typed(json_string),
+                                                typed(json_string));
+
+/**
+ * @brief Finds the closing '"' of the string a push parser is in, or
+ * returns `end` if the string goes on in the next chunk
+ */
+static typed(json_string) json_push_scan_string(typed(json_push_parser) *,
+                                                typed(json_string),
+                                                typed(json_string));
+
+/**
+ * @brief Whether a character may be part of a number
+ */
+static bool json_push_is_number_char(char);
+
+/**
+ * @brief Appends characters of a token split across chunks to the
+ * buffer of a push parser
+ */
+static void json_push_buffer(typed(json_push_parser) *, typed(json_string),
+                             typed(size));
+
+/**
+ * @brief Enters a push parser into an object or array, according to the
+ * bracket that opens it
+ */
+static void json_push_open(typed(json_push_parser) *, char);
+
+/**
+ * @brief Leaves the innermost object or array of a push parser and
+ * reports its end
+ *
+ * @return Whether to go on
+ */
+static bool json_push_close(typed(json_push_parser) *);
+
+/**
+ * @brief The state of a push parser after a whole value
+ */
+static typed(json_push_state) json_push_next_state(typed(json_push_parser) *);
+
+/**
+ * @brief Splits a buffer into the spans of its lines, dropping the
+ * '\r' of a "\r\n" line break
+ *
+ * @return The number of lines
+ */
+static typed(size) json_lines_split(typed(json_string), typed(size),
+                                    typed(json_string_view) **);
+
+/**
+ * @brief Parses batches of the lines of a job {json_lines_job_t} until
+ * none is left. Runs on a thread of its own, or on the calling one
+ *
+ * @param worker The {json_lines_worker_t}
+ */
+static void *json_lines_work(void *);
+
+/**
+ * @brief Claims the next batch of lines of a job, from `*begin` up to
+ * `*end`
+ *
+ * @return Whether any line was left to claim
+ */
+static bool json_lines_claim(typed(json_lines_job) *, typed(size) *,
+                             typed(size) *);
+
+/**
+ * @brief The number of processors online, at least 1
+ */
+static typed(size) json_processor_count(void);
+
+/**
+ * @brief Runs `work` on each of `count` workers of `size` bytes, every
+ * one but the first on a thread of its own, the first on the calling
+ * thread, and waits for all of them. A thread that fails to start runs
+ * its worker on the calling thread instead
+ */
+static void json_run_workers(void *(*)(void *), void *, typed(size),
+                             typed(size));
+
+/**
+ * @brief Finds where to split the elements of a root array into at most
+ * `slice_count` ranges of about the same size, with a quote-aware scan of
+ * the structural characters from `str`, right after the opening '['.
+ * Every range but the first starts right after a ',' of the root array,
+ * and every one ends at the next such ',' or at the closing ']'
+ *
+ * @return The number of ranges, whose `slice_count + 1` bounds are
+ * written to `bounds`, or 0 if the array is never closed
+ */
+static typed(size) json_array_split(typed(json_string), typed(json_string),
+                                    typed(size), typed(json_string) *);
+
+/**
+ * @brief Parses the elements of a range of a root array onto the
+ * scratch stack of its parser, as `json_parse_array` does
+ *
+ * @param slice The {json_array_slice_t}
+ */
+static void *json_array_slice_work(void *);
+
+/**
+ * @brief Moves every block of `other` into `arena` and frees `other`
+ */
+static void json_arena_adopt(typed(json_arena) *, typed(json_arena) *);
+
+/**
+ * @brief Sets up a parser over the rest of the input of a cursor, so
+ * that the cursor moves with the routines of the parser
+ */
+static void json_cursor_parser(typed(json_cursor) *, typed(json_parser) *);
+
+/**
+ * @brief Moves a cursor inside an object or array to its next item, past
+ * the ',' delimiter, or beyond the `close` bracket
+ *
+ * @return Either whether there was an item or {json_error_t}
+ */
+static result(json_boolean) json_cursor_next(typed(json_cursor) *,
+                                             typed(json_parser) *, char);
+
+/**
+ * @brief Whether the `len` characters of a JSON string are the key of a
+ * segment of a path, unescaping them first if the string is `escaped`
+ */
+static bool json_path_key_equals(typed(json_parser) *, typed(json_string),
+                                 typed(size), bool,
+                                 const typed(json_path_segment) *);
+
+/**
+ * @brief Flushes the buffer of a sink, or grows it if `len` characters
+ * still do not fit
+ */
+static void json_sink_grow(typed(json_sink) *, typed(size));
+
+/**
+ * @brief Makes room for `len` more characters in a sink and returns
+ * where they go. Output that fits only pays for one comparison here
+ */
+static inline char *json_sink_reserve(typed(json_sink) * sink,
+                                      typed(size) len) {
+  if (sink->capacity - sink->len < len)
+    json_sink_grow(sink, len);
+
+  return sink->buffer + sink->len;
+}
+
+/**
+ * @brief Writes `len` characters to a sink
+ */
+static void json_sink_put(typed(json_sink) *, typed(json_string), typed(size));
+
+/**
+ * @brief Separates the next value written from the one before it,
+ * unless it follows its key, and moves it to a line of its own when
+ * indenting
+ */
+static void json_writer_prepare(typed(json_writer) *);
+
+/**
+ * @brief Writes a value of a tree unless it is a container, which is
+ * then begun and its values left to be written along a frame it fills in
+ *
+ * @return true If the value is a container, left to be written
+ */
+static bool json_writer_open(typed(json_writer) *, typed(json_writer_frame) *,
+                             const typed(json_element) *);
+
+/**
+ * @brief Writes a `String` {json_string_t} type of `len` characters,
+ * escaping what JSON does not allow in a string
+ */
+static void json_serialize_string(typed(json_sink) *, typed(json_string),
+                                  typed(size));
+
+/**
+ * @brief Writes a `Number` {json_number_t} type
+ */
+static void json_serialize_number(typed(json_sink) *, typed(json_number));
+
+/**
+ * @brief Writes a line break followed by `len` spaces
+ */
+static void json_serialize_newline(typed(json_sink) *, typed(size));
+
+/**
+ * @brief Writes the escape sequence of a character that cannot appear in
+ * a JSON string as it is, and returns its length
+ */
+static typed(size) json_escape_char(char *, unsigned char);
+
+/**
+ * @brief Writes the decimal digits of an integer, and returns how many
+ */
+static typed(size) json_format_digits(char *, typed(uint64));
+
+/**
+ * @brief Writes a `long` in decimal and returns its length
+ */
+static typed(size) json_format_long(char *, long);
+
+/**
+ * @brief Writes a double with the fewest digits that read back as the
+ * same double, and returns its length. Infinities and NaN, which JSON
+ * has no way to write, are written as `null`
+ */
+static typed(size) json_format_double(char *, double);
+
+/**
+ * @brief The shortest decimal rounding to a positive finite double, as
+ * its digits and the exponent of the last one, with the Schubfach
+ * algorithm by Raffaello Giulietti
+ */
+static typed(uint64) json_shortest_decimal(double, int *);
+
+/**
+ * @brief Schubfach for a double of significand `c` and binary exponent
+ * `q`, whose decimal exponent is then moved by `dk`
+ */
+static typed(uint64) json_schubfach(typed(uint64), int, int, int *);
+
+/**
+ * @brief Multiplies a significand by the 126-bit power of ten `g1`,`g0`
+ * keeping the top 64 bits, with the bits dropped rounding to odd
+ */
+static typed(uint64) json_round_to_odd(typed(uint64), typed(uint64),
+                                       typed(uint64));
+
+/**
+ * @brief Frees a `String` (json_string_t) from memory
+ */
+static void json_free_string(typed(json_string));
+
+/**
+ * @brief Frees a value of a tree unless it is a container, whose values
+ * are then to be freed along a frame it fills in
+ *
+ * @return true If the value is a container, left to be freed
+ */
+static bool json_free_open(typed(json_free_frame) *, typed(json_element) *);
+
+/**
+ * @brief Utility function to convert an escaped string to a formatted
+ * string. Writes it, NUL-terminated, to an `output` of at least one more
+ * character than the escaped string, which may be the escaped string
+ * itself
+ *
+ * @return The length of the formatted string
+ */
+static result(size)
+    json_unescape_string(typed(json_string), typed(size), char *output);
+
+/**
+ * @brief Offset to the last `"` of a JSON string. Sets `escaped`, unless
+ * it is `NULL`, when the string holds at least one escape sequence
+ */
+static typed(size)
+    json_string_len(typed(json_parser) *, typed(json_string), bool *);
+
+/**
+ * @brief Decodes the code point of a `\\u` escape, joining a surrogate
+ * pair into one. Moves the string pointer from the `u` to the last hex
+ * digit consumed
+ *
+ * @return The code point, or -1 if the escape is malformed
+ */
+static long json_unescape_code_point(typed(json_string) *, typed(json_string));
+
+/**
+ * @brief Value of the 4 hex digits at the start of a string, or -1 if
+ * any of them is not a hex digit
+ */
+static long json_hex4(typed(json_string));
+
+/**
+ * @brief Writes a code point as UTF-8 and returns the number of bytes
+ */
+static typed(size) json_utf8_encode(typed(uint32), char *);
+
+/**
+ * @brief A kernel finding the first `"` or `\\` between a string pointer
+ * and `end`. Returns `end` if there is none
+ */
+typedef typed(json_string) (*typed(json_string_scanner))(typed(json_string),
+                                                         typed(json_string));
+
+/**
+ * @brief Portable kernel looking at 8 characters at a time where the
+ * byte order allows, one at a time otherwise
+ */
+static typed(json_string) json_scan_string_scalar(typed(json_string),
+                                                  typed(json_string));
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief SSE2 kernel looking at 16 characters at a time
+ */
+static typed(json_string) json_scan_string_sse2(typed(json_string),
+                                                typed(json_string));
+
+/**
+ * @brief AVX2 kernel looking at 32 characters at a time
+ */
+static typed(json_string) json_scan_string_avx2(typed(json_string),
+                                                typed(json_string));
+#endif
+
+/**
+ * @brief Portable kernel finding the first `"`, `\\` or control
+ * character, 8 characters at a time where the byte order allows
+ */
+static typed(json_string) json_scan_escape_scalar(typed(json_string),
+                                                  typed(json_string));
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief SSE2 kernel finding the first `"`, `\\` or control character
+ */
+static typed(json_string) json_scan_escape_sse2(typed(json_string),
+                                                typed(json_string));
+
+/**
+ * @brief AVX2 kernel finding the first `"`, `\\` or control character
+ */
+static typed(json_string) json_scan_escape_avx2(typed(json_string),
+                                                typed(json_string));
+#endif
+
+/**
+ * @brief Portable kernel finding the first character that is not
+ * whitespace, 8 characters at a time where the byte order allows
+ */
+static typed(json_string) json_scan_whitespace_scalar(typed(json_string),
+                                                      typed(json_string));
+
+#ifdef JSON_SIMD_X86
+/**
+ * @brief SSE2 kernel finding the first character that is not whitespace
+ */
+static typed(json_string) json_scan_whitespace_sse2(typed(json_string),
+                                                    typed(json_string));
+
+/**
+ * @brief AVX2 kernel finding the first character that is not whitespace
+ */
+static typed(json_string) json_scan_whitespace_avx2(typed(json_string),
+                                                    typed(json_string));
+#endif
+
+/**
+ * @brief One bit per character of a 64 character block of input
+ */
+typedef struct json_block_masks_s {
+  typed(uint64) quote;
+  typed(uint64) backslash;
+  // Any of `{}[]:,`, whether in a string or not
+  typed(uint64) operators;
+} typed(json_block_masks);
+
+/**
+ * @brief A kernel classifying the 64 characters of a block
+ */
+typedef void (*typed(json_block_classifier))(typed(json_string),
+                                             typed(json_block_masks) *);
+
+#ifndef JSON_SIMD_X86
+/**
+ * @brief Portable kernel classifying a block one character at a time
+ */
+static void json_classify_block_scalar(typed(json_string),
+                                       typed(json_block_masks) *);
+#else
+/**
+ * @brief SSE2 kernel classifying a block 16 characters at a time
+ */
+static void json_classify_block_sse2(typed(json_string),
+                                     typed(json_block_masks) *);
+
+/**
+ * @brief AVX2 kernel classifying a block 32 characters at a time
+ */
+static void json_classify_block_avx2(typed(json_string),
+                                     typed(json_block_masks) *);
+#endif
+
+/**
+ * @brief Points every kernel at the best variant the CPU supports
+ */
+static void json_kernels_resolve(void);
+
+/**
+ * @brief Resolves the kernels on first use and scans a string
+ */
+static typed(json_string) json_scan_string_resolve(typed(json_string),
+                                                   typed(json_string));
+
+/**
+ * @brief Resolves the kernels on first use and scans for a character to
+ * escape
+ */
+static typed(json_string) json_scan_escape_resolve(typed(json_string),
+                                                   typed(json_string));
+
+/**
+ * @brief Resolves the kernels on first use and scans whitespace
+ */
+static typed(json_string) json_scan_whitespace_resolve(typed(json_string),
+                                                       typed(json_string));
+
+/**
+ * @brief Resolves the kernels on first use and classifies a block
+ */
+static void json_classify_block_resolve(typed(json_string),
+                                        typed(json_block_masks) *);
+
+/**
+ * @brief The kernel used to scan strings, resolved on the first call
+ */
+static typed(json_string_scanner) json_scan_string = json_scan_string_resolve;
+
+/**
+ * @brief The kernel finding the first character that is not whitespace
+ * between a string pointer and `end`, resolved on the first call.
+ * Returns `end` if there is none
+ */
+static typed(json_string_scanner) json_scan_whitespace =
+    json_scan_whitespace_resolve;
+
+/**
+ * @brief The kernel finding the first character a serialized string must
+ * escape between a string pointer and `end`, resolved on the first call.
+ * Returns `end` if there is none
+ */
+static typed(json_string_scanner) json_scan_escape = json_scan_escape_resolve;
+
+/**
+ * @brief The kernel classifying blocks for the structural index,
+ * resolved on the first call
+ */
+static typed(json_block_classifier) json_classify_block =
+    json_classify_block_resolve;
+
+/**
+ * @brief Doubles of the powers of ten that are exact, up to 1e22
+ */
+static const double json_exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * @brief The decimal digits of every number below 100, two per number
+ */
+static const char json_digit_pairs[] = "00010203040506070809"
+                                       "10111213141516171819"
+                                       "20212223242526272829"
+                                       "30313233343536373839"
+                                       "40414243444546474849"
+                                       "50515253545556575859"
+                                       "60616263646566676869"
+                                       "70717273747576777879"
+                                       "80818283848586878889"
+                                       "90919293949596979899";
+
+/**
+ * @brief The powers of ten from {JSON_POWER_OF_TEN_MIN} to
+ * {JSON_POWER_OF_TEN_MAX}, each as the high and low halves of a 128-bit
+ * mantissa rounded down and shifted so that its top bit is set
+ */
+static const typed(uint64) json_powers_of_ten[][2] = {
+    {0xEEF453D6923BD65A, 0x113FAA2906A13B3F}, // 1e-342
+    {0x9558B4661B6565F8, 0x4AC7CA59A424C507}, // 1e-341
+    {0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649}, // 1e-340
+    {0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC}, // 1e-339
+    {0x91D8A02BB6C10594, 0x79071B9B8A4BE869}, // 1e-338
+    {0xB64EC836A47146F9, 0x9748E2826CDEE284}, // 1e-337
+    {0xE3E27A444D8D98B7, 0xFD1B1B2308169B25}, // 1e-336
+    {0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7}, // 1e-335
+    {0xB208EF855C969F4F, 0xBDBD2D335E51A935}, // 1e-334
+    {0xDE8B2B66B3BC4723, 0xAD2C788035E61382}, // 1e-333
+    {0x8B16FB203055AC76, 0x4C3BCB5021AFCC31}, // 1e-332
+    {0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D}, // 1e-331
+    {0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D}, // 1e-330
+    {0x87D4713D6F33AA6B, 0x8672648C40E5AD68}, // 1e-329
+    {0xA9C98D8CCB009506, 0x680EFDAF511F18C2}, // 1e-328
+    {0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2}, // 1e-327
+    {0x84A57695FE98746D, 0x014BB630F7604B57}, // 1e-326
+    {0xA5CED43B7E3E9188, 0x419EA3BD35385E2D}, // 1e-325
+    {0xCF42894A5DCE35EA, 0x52064CAC828675B9}, // 1e-324
+    {0x818995CE7AA0E1B2, 0x7343EFEBD1940993}, // 1e-323
+    {0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8}, // 1e-322
+    {0xCA66FA129F9B60A6, 0xD41A26E077774EF6}, // 1e-321
+    {0xFD00B897478238D0, 0x8920B098955522B4}, // 1e-320
+    {0x9E20735E8CB16382, 0x55B46E5F5D5535B0}, // 1e-319
+    {0xC5A890362FDDBC62, 0xEB2189F734AA831D}, // 1e-318
+    {0xF712B443BBD52B7B, 0xA5E9EC7501D523E4}, // 1e-317
+    {0x9A6BB0AA55653B2D, 0x47B233C92125366E}, // 1e-316
+    {0xC1069CD4EABE89F8, 0x999EC0BB696E840A}, // 1e-315
+    {0xF148440A256E2C76, 0xC00670EA43CA250D}, // 1e-314
+    {0x96CD2A865764DBCA, 0x380406926A5E5728}, // 1e-313
+    {0xBC807527ED3E12BC, 0xC605083704F5ECF2}, // 1e-312
+    {0xEBA09271E88D976B, 0xF7864A44C633682E}, // 1e-311
+    {0x93445B8731587EA3, 0x7AB3EE6AFBE0211D}, // 1e-310
+    {0xB8157268FDAE9E4C, 0x5960EA05BAD82964}, // 1e-309
+    {0xE61ACF033D1A45DF, 0x6FB92487298E33BD}, // 1e-308
+    {0x8FD0C16206306BAB, 0xA5D3B6D479F8E056}, // 1e-307
+    {0xB3C4F1BA87BC8696, 0x8F48A4899877186C}, // 1e-306
+    {0xE0B62E2929ABA83C, 0x331ACDABFE94DE87}, // 1e-305
+    {0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14}, // 1e-304
+    {0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9}, // 1e-303
+    {0xDB71E91432B1A24A, 0xC9E82CD9F69D6150}, // 1e-302
+    {0x892731AC9FAF056E, 0xBE311C083A225CD2}, // 1e-301
+    {0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406}, // 1e-300
+    {0xD64D3D9DB981787D, 0x092CBBCCDAD5B108}, // 1e-299
+    {0x85F0468293F0EB4E, 0x25BBF56008C58EA5}, // 1e-298
+    {0xA76C582338ED2621, 0xAF2AF2B80AF6F24E}, // 1e-297
+    {0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1}, // 1e-296
+    {0x82CCA4DB847945CA, 0x50D98D9FC890ED4D}, // 1e-295
+    {0xA37FCE126597973C, 0xE50FF107BAB528A0}, // 1e-294
+    {0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8}, // 1e-293
+    {0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A}, // 1e-292
+    {0x9FAACF3DF73609B1, 0x77B191618C54E9AC}, // 1e-291
+    {0xC795830D75038C1D, 0xD59DF5B9EF6A2417}, // 1e-290
+    {0xF97AE3D0D2446F25, 0x4B0573286B44AD1D}, // 1e-289
+    {0x9BECCE62836AC577, 0x4EE367F9430AEC32}, // 1e-288
+    {0xC2E801FB244576D5, 0x229C41F793CDA73F}, // 1e-287
+    {0xF3A20279ED56D48A, 0x6B43527578C1110F}, // 1e-286
+    {0x9845418C345644D6, 0x830A13896B78AAA9}, // 1e-285
+    {0xBE5691EF416BD60C, 0x23CC986BC656D553}, // 1e-284
+    {0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8}, // 1e-283
+    {0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9}, // 1e-282
+    {0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53}, // 1e-281
+    {0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68}, // 1e-280
+    {0x91376C36D99995BE, 0x23100809B9C21FA1}, // 1e-279
+    {0xB58547448FFFFB2D, 0xABD40A0C2832A78A}, // 1e-278
+    {0xE2E69915B3FFF9F9, 0x16C90C8F323F516C}, // 1e-277
+    {0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3}, // 1e-276
+    {0xB1442798F49FFB4A, 0x99CD11CFDF41779C}, // 1e-275
+    {0xDD95317F31C7FA1D, 0x40405643D711D583}, // 1e-274
+    {0x8A7D3EEF7F1CFC52, 0x482835EA666B2572}, // 1e-273
+    {0xAD1C8EAB5EE43B66, 0xDA3243650005EECF}, // 1e-272
+    {0xD863B256369D4A40, 0x90BED43E40076A82}, // 1e-271
+    {0x873E4F75E2224E68, 0x5A7744A6E804A291}, // 1e-270
+    {0xA90DE3535AAAE202, 0x711515D0A205CB36}, // 1e-269
+    {0xD3515C2831559A83, 0x0D5A5B44CA873E03}, // 1e-268
+    {0x8412D9991ED58091, 0xE858790AFE9486C2}, // 1e-267
+    {0xA5178FFF668AE0B6, 0x626E974DBE39A872}, // 1e-266
+    {0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F}, // 1e-265
+    {0x80FA687F881C7F8E, 0x7CE66634BC9D0B99}, // 1e-264
+    {0xA139029F6A239F72, 0x1C1FFFC1EBC44E80}, // 1e-263
+    {0xC987434744AC874E, 0xA327FFB266B56220}, // 1e-262
+    {0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8}, // 1e-261
+    {0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9}, // 1e-260
+    {0xC4CE17B399107C22, 0xCB550FB4384D21D3}, // 1e-259
+    {0xF6019DA07F549B2B, 0x7E2A53A146606A48}, // 1e-258
+    {0x99C102844F94E0FB, 0x2EDA7444CBFC426D}, // 1e-257
+    {0xC0314325637A1939, 0xFA911155FEFB5308}, // 1e-256
+    {0xF03D93EEBC589F88, 0x793555AB7EBA27CA}, // 1e-255
+    {0x96267C7535B763B5, 0x4BC1558B2F3458DE}, // 1e-254
+    {0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16}, // 1e-253
+    {0xEA9C227723EE8BCB, 0x465E15A979C1CADC}, // 1e-252
+    {0x92A1958A7675175F, 0x0BFACD89EC191EC9}, // 1e-251
+    {0xB749FAED14125D36, 0xCEF980EC671F667B}, // 1e-250
+    {0xE51C79A85916F484, 0x82B7E12780E7401A}, // 1e-249
+    {0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810}, // 1e-248
+    {0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15}, // 1e-247
+    {0xDFBDCECE67006AC9, 0x67A791E093E1D49A}, // 1e-246
+    {0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0}, // 1e-245
+    {0xAECC49914078536D, 0x58FAE9F773886E18}, // 1e-244
+    {0xDA7F5BF590966848, 0xAF39A475506A899E}, // 1e-243
+    {0x888F99797A5E012D, 0x6D8406C952429603}, // 1e-242
+    {0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83}, // 1e-241
+    {0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64}, // 1e-240
+    {0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F}, // 1e-239
+    {0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E}, // 1e-238
+    {0xD0601D8EFC57B08B, 0xF13B94DAF124DA26}, // 1e-237
+    {0x823C12795DB6CE57, 0x76C53D08D6B70858}, // 1e-236
+    {0xA2CB1717B52481ED, 0x54768C4B0C64CA6E}, // 1e-235
+    {0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09}, // 1e-234
+    {0xFE5D54150B090B02, 0xD3F93B35435D7C4C}, // 1e-233
+    {0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF}, // 1e-232
+    {0xC6B8E9B0709F109A, 0x359AB6419CA1091B}, // 1e-231
+    {0xF867241C8CC6D4C0, 0xC30163D203C94B62}, // 1e-230
+    {0x9B407691D7FC44F8, 0x79E0DE63425DCF1D}, // 1e-229
+    {0xC21094364DFB5636, 0x985915FC12F542E4}, // 1e-228
+    {0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D}, // 1e-227
+    {0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42}, // 1e-226
+    {0xBD8430BD08277231, 0x50C6FF782A838353}, // 1e-225
+    {0xECE53CEC4A314EBD, 0xA4F8BF5635246428}, // 1e-224
+    {0x940F4613AE5ED136, 0x871B7795E136BE99}, // 1e-223
+    {0xB913179899F68584, 0x28E2557B59846E3F}, // 1e-222
+    {0xE757DD7EC07426E5, 0x331AEADA2FE589CF}, // 1e-221
+    {0x9096EA6F3848984F, 0x3FF0D2C85DEF7621}, // 1e-220
+    {0xB4BCA50B065ABE63, 0x0FED077A756B53A9}, // 1e-219
+    {0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894}, // 1e-218
+    {0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C}, // 1e-217
+    {0xB080392CC4349DEC, 0xBD8D794D96AACFB3}, // 1e-216
+    {0xDCA04777F541C567, 0xECF0D7A0FC5583A0}, // 1e-215
+    {0x89E42CAAF9491B60, 0xF41686C49DB57244}, // 1e-214
+    {0xAC5D37D5B79B6239, 0x311C2875C522CED5}, // 1e-213
+    {0xD77485CB25823AC7, 0x7D633293366B828B}, // 1e-212
+    {0x86A8D39EF77164BC, 0xAE5DFF9C02033197}, // 1e-211
+    {0xA8530886B54DBDEB, 0xD9F57F830283FDFC}, // 1e-210
+    {0xD267CAA862A12D66, 0xD072DF63C324FD7B}, // 1e-209
+    {0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D}, // 1e-208
+    {0xA46116538D0DEB78, 0x52D9BE85F074E608}, // 1e-207
+    {0xCD795BE870516656, 0x67902E276C921F8B}, // 1e-206
+    {0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6}, // 1e-205
+    {0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4}, // 1e-204
+    {0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD}, // 1e-203
+    {0xFAD2A4B13D1B5D6C, 0x796B805720085F81}, // 1e-202
+    {0x9CC3A6EEC6311A63, 0xCBE3303674053BB0}, // 1e-201
+    {0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C}, // 1e-200
+    {0xF4F1B4D515ACB93B, 0xEE92FB5515482D44}, // 1e-199
+    {0x991711052D8BF3C5, 0x751BDD152D4D1C4A}, // 1e-198
+    {0xBF5CD54678EEF0B6, 0xD262D45A78A0635D}, // 1e-197
+    {0xEF340A98172AACE4, 0x86FB897116C87C34}, // 1e-196
+    {0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0}, // 1e-195
+    {0xBAE0A846D2195712, 0x8974836059CCA109}, // 1e-194
+    {0xE998D258869FACD7, 0x2BD1A438703FC94B}, // 1e-193
+    {0x91FF83775423CC06, 0x7B6306A34627DDCF}, // 1e-192
+    {0xB67F6455292CBF08, 0x1A3BC84C17B1D542}, // 1e-191
+    {0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93}, // 1e-190
+    {0x8E938662882AF53E, 0x547EB47B7282EE9C}, // 1e-189
+    {0xB23867FB2A35B28D, 0xE99E619A4F23AA43}, // 1e-188
+    {0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4}, // 1e-187
+    {0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04}, // 1e-186
+    {0xAE0B158B4738705E, 0x9624AB50B148D445}, // 1e-185
+    {0xD98DDAEE19068C76, 0x3BADD624DD9B0957}, // 1e-184
+    {0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6}, // 1e-183
+    {0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C}, // 1e-182
+    {0xD47487CC8470652B, 0x7647C3200069671F}, // 1e-181
+    {0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073}, // 1e-180
+    {0xA5FB0A17C777CF09, 0xF468107100525890}, // 1e-179
+    {0xCF79CC9DB955C2CC, 0x7182148D4066EEB4}, // 1e-178
+    {0x81AC1FE293D599BF, 0xC6F14CD848405530}, // 1e-177
+    {0xA21727DB38CB002F, 0xB8ADA00E5A506A7C}, // 1e-176
+    {0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C}, // 1e-175
+    {0xFD442E4688BD304A, 0x908F4A166D1DA663}, // 1e-174
+    {0x9E4A9CEC15763E2E, 0x9A598E4E043287FE}, // 1e-173
+    {0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD}, // 1e-172
+    {0xF7549530E188C128, 0xD12BEE59E68EF47C}, // 1e-171
+    {0x9A94DD3E8CF578B9, 0x82BB74F8301958CE}, // 1e-170
+    {0xC13A148E3032D6E7, 0xE36A52363C1FAF01}, // 1e-169
+    {0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1}, // 1e-168
+    {0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9}, // 1e-167
+    {0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7}, // 1e-166
+    {0xEBDF661791D60F56, 0x111B495B3464AD21}, // 1e-165
+    {0x936B9FCEBB25C995, 0xCAB10DD900BEEC34}, // 1e-164
+    {0xB84687C269EF3BFB, 0x3D5D514F40EEA742}, // 1e-163
+    {0xE65829B3046B0AFA, 0x0CB4A5A3112A5112}, // 1e-162
+    {0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB}, // 1e-161
+    {0xB3F4E093DB73A093, 0x59ED216765690F56}, // 1e-160
+    {0xE0F218B8D25088B8, 0x306869C13EC3532C}, // 1e-159
+    {0x8C974F7383725573, 0x1E414218C73A13FB}, // 1e-158
+    {0xAFBD2350644EEACF, 0xE5D1929EF90898FA}, // 1e-157
+    {0xDBAC6C247D62A583, 0xDF45F746B74ABF39}, // 1e-156
+    {0x894BC396CE5DA772, 0x6B8BBA8C328EB783}, // 1e-155
+    {0xAB9EB47C81F5114F, 0x066EA92F3F326564}, // 1e-154
+    {0xD686619BA27255A2, 0xC80A537B0EFEFEBD}, // 1e-153
+    {0x8613FD0145877585, 0xBD06742CE95F5F36}, // 1e-152
+    {0xA798FC4196E952E7, 0x2C48113823B73704}, // 1e-151
+    {0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5}, // 1e-150
+    {0x82EF85133DE648C4, 0x9A984D73DBE722FB}, // 1e-149
+    {0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA}, // 1e-148
+    {0xCC963FEE10B7D1B3, 0x318DF905079926A8}, // 1e-147
+    {0xFFBBCFE994E5C61F, 0xFDF17746497F7052}, // 1e-146
+    {0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633}, // 1e-145
+    {0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0}, // 1e-144
+    {0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0}, // 1e-143
+    {0x9C1661A651213E2D, 0x06BEA10CA65C084E}, // 1e-142
+    {0xC31BFA0FE5698DB8, 0x486E494FCFF30A62}, // 1e-141
+    {0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA}, // 1e-140
+    {0x986DDB5C6B3A76B7, 0xF89629465A75E01C}, // 1e-139
+    {0xBE89523386091465, 0xF6BBB397F1135823}, // 1e-138
+    {0xEE2BA6C0678B597F, 0x746AA07DED582E2C}, // 1e-137
+    {0x94DB483840B717EF, 0xA8C2A44EB4571CDC}, // 1e-136
+    {0xBA121A4650E4DDEB, 0x92F34D62616CE413}, // 1e-135
+    {0xE896A0D7E51E1566, 0x77B020BAF9C81D17}, // 1e-134
+    {0x915E2486EF32CD60, 0x0ACE1474DC1D122E}, // 1e-133
+    {0xB5B5ADA8AAFF80B8, 0x0D819992132456BA}, // 1e-132
+    {0xE3231912D5BF60E6, 0x10E1FFF697ED6C69}, // 1e-131
+    {0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1}, // 1e-130
+    {0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2}, // 1e-129
+    {0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE}, // 1e-128
+    {0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B}, // 1e-127
+    {0xAD4AB7112EB3929D, 0x86C16C98D2C953C6}, // 1e-126
+    {0xD89D64D57A607744, 0xE871C7BF077BA8B7}, // 1e-125
+    {0x87625F056C7C4A8B, 0x11471CD764AD4972}, // 1e-124
+    {0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF}, // 1e-123
+    {0xD389B47879823479, 0x4AFF1D108D4EC2C3}, // 1e-122
+    {0x843610CB4BF160CB, 0xCEDF722A585139BA}, // 1e-121
+    {0xA54394FE1EEDB8FE, 0xC2974EB4EE658828}, // 1e-120
+    {0xCE947A3DA6A9273E, 0x733D226229FEEA32}, // 1e-119
+    {0x811CCC668829B887, 0x0806357D5A3F525F}, // 1e-118
+    {0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7}, // 1e-117
+    {0xC9BCFF6034C13052, 0xFC89B393DD02F0B5}, // 1e-116
+    {0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2}, // 1e-115
+    {0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D}, // 1e-114
+    {0xC5029163F384A931, 0x0A9E795E65D4DF11}, // 1e-113
+    {0xF64335BCF065D37D, 0x4D4617B5FF4A16D5}, // 1e-112
+    {0x99EA0196163FA42E, 0x504BCED1BF8E4E45}, // 1e-111
+    {0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6}, // 1e-110
+    {0xF07DA27A82C37088, 0x5D767327BB4E5A4C}, // 1e-109
+    {0x964E858C91BA2655, 0x3A6A07F8D510F86F}, // 1e-108
+    {0xBBE226EFB628AFEA, 0x890489F70A55368B}, // 1e-107
+    {0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E}, // 1e-106
+    {0x92C8AE6B464FC96F, 0x3B0B8BC90012929D}, // 1e-105
+    {0xB77ADA0617E3BBCB, 0x09CE6EBB40173744}, // 1e-104
+    {0xE55990879DDCAABD, 0xCC420A6A101D0515}, // 1e-103
+    {0x8F57FA54C2A9EAB6, 0x9FA946824A12232D}, // 1e-102
+    {0xB32DF8E9F3546564, 0x47939822DC96ABF9}, // 1e-101
+    {0xDFF9772470297EBD, 0x59787E2B93BC56F7}, // 1e-100
+    {0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A}, // 1e-99
+    {0xAEFAE51477A06B03, 0xEDE622920B6B23F1}, // 1e-98
+    {0xDAB99E59958885C4, 0xE95FAB368E45ECED}, // 1e-97
+    {0x88B402F7FD75539B, 0x11DBCB0218EBB414}, // 1e-96
+    {0xAAE103B5FCD2A881, 0xD652BDC29F26A119}, // 1e-95
+    {0xD59944A37C0752A2, 0x4BE76D3346F0495F}, // 1e-94
+    {0x857FCAE62D8493A5, 0x6F70A4400C562DDB}, // 1e-93
+    {0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952}, // 1e-92
+    {0xD097AD07A71F26B2, 0x7E2000A41346A7A7}, // 1e-91
+    {0x825ECC24C873782F, 0x8ED400668C0C28C8}, // 1e-90
+    {0xA2F67F2DFA90563B, 0x728900802F0F32FA}, // 1e-89
+    {0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9}, // 1e-88
+    {0xFEA126B7D78186BC, 0xE2F610C84987BFA8}, // 1e-87
+    {0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9}, // 1e-86
+    {0xC6EDE63FA05D3143, 0x91503D1C79720DBB}, // 1e-85
+    {0xF8A95FCF88747D94, 0x75A44C6397CE912A}, // 1e-84
+    {0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA}, // 1e-83
+    {0xC24452DA229B021B, 0xFBE85BADCE996168}, // 1e-82
+    {0xF2D56790AB41C2A2, 0xFAE27299423FB9C3}, // 1e-81
+    {0x97C560BA6B0919A5, 0xDCCD879FC967D41A}, // 1e-80
+    {0xBDB6B8E905CB600F, 0x5400E987BBC1C920}, // 1e-79
+    {0xED246723473E3813, 0x290123E9AAB23B68}, // 1e-78
+    {0x9436C0760C86E30B, 0xF9A0B6720AAF6521}, // 1e-77
+    {0xB94470938FA89BCE, 0xF808E40E8D5B3E69}, // 1e-76
+    {0xE7958CB87392C2C2, 0xB60B1D1230B20E04}, // 1e-75
+    {0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2}, // 1e-74
+    {0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3}, // 1e-73
+    {0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0}, // 1e-72
+    {0x8D590723948A535F, 0x579C487E5A38AD0E}, // 1e-71
+    {0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851}, // 1e-70
+    {0xDCDB1B2798182244, 0xF8E431456CF88E65}, // 1e-69
+    {0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF}, // 1e-68
+    {0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F}, // 1e-67
+    {0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F}, // 1e-66
+    {0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9}, // 1e-65
+    {0xA87FEA27A539E9A5, 0x3F2398D747B36224}, // 1e-64
+    {0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD}, // 1e-63
+    {0x83A3EEEEF9153E89, 0x1953CF68300424AC}, // 1e-62
+    {0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7}, // 1e-61
+    {0xCDB02555653131B6, 0x3792F412CB06794D}, // 1e-60
+    {0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0}, // 1e-59
+    {0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4}, // 1e-58
+    {0xC8DE047564D20A8B, 0xF245825A5A445275}, // 1e-57
+    {0xFB158592BE068D2E, 0xEED6E2F0F0D56712}, // 1e-56
+    {0x9CED737BB6C4183D, 0x55464DD69685606B}, // 1e-55
+    {0xC428D05AA4751E4C, 0xAA97E14C3C26B886}, // 1e-54
+    {0xF53304714D9265DF, 0xD53DD99F4B3066A8}, // 1e-53
+    {0x993FE2C6D07B7FAB, 0xE546A8038EFE4029}, // 1e-52
+    {0xBF8FDB78849A5F96, 0xDE98520472BDD033}, // 1e-51
+    {0xEF73D256A5C0F77C, 0x963E66858F6D4440}, // 1e-50
+    {0x95A8637627989AAD, 0xDDE7001379A44AA8}, // 1e-49
+    {0xBB127C53B17EC159, 0x5560C018580D5D52}, // 1e-48
+    {0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6}, // 1e-47
+    {0x9226712162AB070D, 0xCAB3961304CA70E8}, // 1e-46
+    {0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22}, // 1e-45
+    {0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A}, // 1e-44
+    {0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242}, // 1e-43
+    {0xB267ED1940F1C61C, 0x55F038B237591ED3}, // 1e-42
+    {0xDF01E85F912E37A3, 0x6B6C46DEC52F6688}, // 1e-41
+    {0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015}, // 1e-40
+    {0xAE397D8AA96C1B77, 0xABEC975E0A0D081A}, // 1e-39
+    {0xD9C7DCED53C72255, 0x96E7BD358C904A21}, // 1e-38
+    {0x881CEA14545C7575, 0x7E50D64177DA2E54}, // 1e-37
+    {0xAA242499697392D2, 0xDDE50BD1D5D0B9E9}, // 1e-36
+    {0xD4AD2DBFC3D07787, 0x955E4EC64B44E864}, // 1e-35
+    {0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E}, // 1e-34
+    {0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E}, // 1e-33
+    {0xCFB11EAD453994BA, 0x67DE18EDA5814AF2}, // 1e-32
+    {0x81CEB32C4B43FCF4, 0x80EACF948770CED7}, // 1e-31
+    {0xA2425FF75E14FC31, 0xA1258379A94D028D}, // 1e-30
+    {0xCAD2F7F5359A3B3E, 0x096EE45813A04330}, // 1e-29
+    {0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC}, // 1e-28
+    {0x9E74D1B791E07E48, 0x775EA264CF55347D}, // 1e-27
+    {0xC612062576589DDA, 0x95364AFE032A819D}, // 1e-26
+    {0xF79687AED3EEC551, 0x3A83DDBD83F52204}, // 1e-25
+    {0x9ABE14CD44753B52, 0xC4926A9672793542}, // 1e-24
+    {0xC16D9A0095928A27, 0x75B7053C0F178293}, // 1e-23
+    {0xF1C90080BAF72CB1, 0x5324C68B12DD6338}, // 1e-22
+    {0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E03}, // 1e-21
+    {0xBCE5086492111AEA, 0x88F4BB1CA6BCF584}, // 1e-20
+    {0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E5}, // 1e-19
+    {0x9392EE8E921D5D07, 0x3AFF322E62439FCF}, // 1e-18
+    {0xB877AA3236A4B449, 0x09BEFEB9FAD487C2}, // 1e-17
+    {0xE69594BEC44DE15B, 0x4C2EBE687989A9B3}, // 1e-16
+    {0x901D7CF73AB0ACD9, 0x0F9D37014BF60A10}, // 1e-15
+    {0xB424DC35095CD80F, 0x538484C19EF38C94}, // 1e-14
+    {0xE12E13424BB40E13, 0x2865A5F206B06FB9}, // 1e-13
+    {0x8CBCCC096F5088CB, 0xF93F87B7442E45D3}, // 1e-12
+    {0xAFEBFF0BCB24AAFE, 0xF78F69A51539D748}, // 1e-11
+    {0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1B}, // 1e-10
+    {0x89705F4136B4A597, 0x31680A88F8953030}, // 1e-9
+    {0xABCC77118461CEFC, 0xFDC20D2B36BA7C3D}, // 1e-8
+    {0xD6BF94D5E57A42BC, 0x3D32907604691B4C}, // 1e-7
+    {0x8637BD05AF6C69B5, 0xA63F9A49C2C1B10F}, // 1e-6
+    {0xA7C5AC471B478423, 0x0FCF80DC33721D53}, // 1e-5
+    {0xD1B71758E219652B, 0xD3C36113404EA4A8}, // 1e-4
+    {0x83126E978D4FDF3B, 0x645A1CAC083126E9}, // 1e-3
+    {0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A3}, // 1e-2
+    {0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCC}, // 1e-1
+    {0x8000000000000000, 0x0000000000000000}, // 1e0
+    {0xA000000000000000, 0x0000000000000000}, // 1e1
+    {0xC800000000000000, 0x0000000000000000}, // 1e2
+    {0xFA00000000000000, 0x0000000000000000}, // 1e3
+    {0x9C40000000000000, 0x0000000000000000}, // 1e4
+    {0xC350000000000000, 0x0000000000000000}, // 1e5
+    {0xF424000000000000, 0x0000000000000000}, // 1e6
+    {0x9896800000000000, 0x0000000000000000}, // 1e7
+    {0xBEBC200000000000, 0x0000000000000000}, // 1e8
+    {0xEE6B280000000000, 0x0000000000000000}, // 1e9
+    {0x9502F90000000000, 0x0000000000000000}, // 1e10
+    {0xBA43B74000000000, 0x0000000000000000}, // 1e11
+    {0xE8D4A51000000000, 0x0000000000000000}, // 1e12
+    {0x9184E72A00000000, 0x0000000000000000}, // 1e13
+    {0xB5E620F480000000, 0x0000000000000000}, // 1e14
+    {0xE35FA931A0000000, 0x0000000000000000}, // 1e15
+    {0x8E1BC9BF04000000, 0x0000000000000000}, // 1e16
+    {0xB1A2BC2EC5000000, 0x0000000000000000}, // 1e17
+    {0xDE0B6B3A76400000, 0x0000000000000000}, // 1e18
+    {0x8AC7230489E80000, 0x0000000000000000}, // 1e19
+    {0xAD78EBC5AC620000, 0x0000000000000000}, // 1e20
+    {0xD8D726B7177A8000, 0x0000000000000000}, // 1e21
+    {0x878678326EAC9000, 0x0000000000000000}, // 1e22
+    {0xA968163F0A57B400, 0x0000000000000000}, // 1e23
+    {0xD3C21BCECCEDA100, 0x0000000000000000}, // 1e24
+    {0x84595161401484A0, 0x0000000000000000}, // 1e25
+    {0xA56FA5B99019A5C8, 0x0000000000000000}, // 1e26
+    {0xCECB8F27F4200F3A, 0x0000000000000000}, // 1e27
+    {0x813F3978F8940984, 0x4000000000000000}, // 1e28
+    {0xA18F07D736B90BE5, 0x5000000000000000}, // 1e29
+    {0xC9F2C9CD04674EDE, 0xA400000000000000}, // 1e30
+    {0xFC6F7C4045812296, 0x4D00000000000000}, // 1e31
+    {0x9DC5ADA82B70B59D, 0xF020000000000000}, // 1e32
+    {0xC5371912364CE305, 0x6C28000000000000}, // 1e33
+    {0xF684DF56C3E01BC6, 0xC732000000000000}, // 1e34
+    {0x9A130B963A6C115C, 0x3C7F400000000000}, // 1e35
+    {0xC097CE7BC90715B3, 0x4B9F100000000000}, // 1e36
+    {0xF0BDC21ABB48DB20, 0x1E86D40000000000}, // 1e37
+    {0x96769950B50D88F4, 0x1314448000000000}, // 1e38
+    {0xBC143FA4E250EB31, 0x17D955A000000000}, // 1e39
+    {0xEB194F8E1AE525FD, 0x5DCFAB0800000000}, // 1e40
+    {0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000}, // 1e41
+    {0xB7ABC627050305AD, 0xF14A3D9E40000000}, // 1e42
+    {0xE596B7B0C643C719, 0x6D9CCD05D0000000}, // 1e43
+    {0x8F7E32CE7BEA5C6F, 0xE4820023A2000000}, // 1e44
+    {0xB35DBF821AE4F38B, 0xDDA2802C8A800000}, // 1e45
+    {0xE0352F62A19E306E, 0xD50B2037AD200000}, // 1e46
+    {0x8C213D9DA502DE45, 0x4526F422CC340000}, // 1e47
+    {0xAF298D050E4395D6, 0x9670B12B7F410000}, // 1e48
+    {0xDAF3F04651D47B4C, 0x3C0CDD765F114000}, // 1e49
+    {0x88D8762BF324CD0F, 0xA5880A69FB6AC800}, // 1e50
+    {0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00}, // 1e51
+    {0xD5D238A4ABE98068, 0x72A4904598D6D880}, // 1e52
+    {0x85A36366EB71F041, 0x47A6DA2B7F864750}, // 1e53
+    {0xA70C3C40A64E6C51, 0x999090B65F67D924}, // 1e54
+    {0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D}, // 1e55
+    {0x82818F1281ED449F, 0xBFF8F10E7A8921A4}, // 1e56
+    {0xA321F2D7226895C7, 0xAFF72D52192B6A0D}, // 1e57
+    {0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490}, // 1e58
+    {0xFEE50B7025C36A08, 0x02F236D04753D5B4}, // 1e59
+    {0x9F4F2726179A2245, 0x01D762422C946590}, // 1e60
+    {0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5}, // 1e61
+    {0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2}, // 1e62
+    {0x9B934C3B330C8577, 0x63CC55F49F88EB2F}, // 1e63
+    {0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB}, // 1e64
+    {0xF316271C7FC3908A, 0x8BEF464E3945EF7A}, // 1e65
+    {0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC}, // 1e66
+    {0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317}, // 1e67
+    {0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD}, // 1e68
+    {0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A}, // 1e69
+    {0xB975D6B6EE39E436, 0xB3E2FD538E122B44}, // 1e70
+    {0xE7D34C64A9C85D44, 0x60DBBCA87196B616}, // 1e71
+    {0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD}, // 1e72
+    {0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41}, // 1e73
+    {0xE264589A4DCDAB14, 0xC696963C7EED2DD1}, // 1e74
+    {0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2}, // 1e75
+    {0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB}, // 1e76
+    {0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE}, // 1e77
+    {0x8A2DBF142DFCC7AB, 0x6E3569326C784337}, // 1e78
+    {0xACB92ED9397BF996, 0x49C2C37F07965404}, // 1e79
+    {0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906}, // 1e80
+    {0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3}, // 1e81
+    {0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C}, // 1e82
+    {0xD2D80DB02AABD62B, 0xF50A3FA490C30190}, // 1e83
+    {0x83C7088E1AAB65DB, 0x792667C6DA79E0FA}, // 1e84
+    {0xA4B8CAB1A1563F52, 0x577001B891185938}, // 1e85
+    {0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86}, // 1e86
+    {0x80B05E5AC60B6178, 0x544F8158315B05B4}, // 1e87
+    {0xA0DC75F1778E39D6, 0x696361AE3DB1C721}, // 1e88
+    {0xC913936DD571C84C, 0x03BC3A19CD1E38E9}, // 1e89
+    {0xFB5878494ACE3A5F, 0x04AB48A04065C723}, // 1e90
+    {0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76}, // 1e91
+    {0xC45D1DF942711D9A, 0x3BA5D0BD324F8394}, // 1e92
+    {0xF5746577930D6500, 0xCA8F44EC7EE36479}, // 1e93
+    {0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB}, // 1e94
+    {0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E}, // 1e95
+    {0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E}, // 1e96
+    {0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12}, // 1e97
+    {0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97}, // 1e98
+    {0xEA1575143CF97226, 0xF52D09D71A3293BD}, // 1e99
+    {0x924D692CA61BE758, 0x593C2626705F9C56}, // 1e100
+    {0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C}, // 1e101
+    {0xE498F455C38B997A, 0x0B6DFB9C0F956447}, // 1e102
+    {0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC}, // 1e103
+    {0xB2977EE300C50FE7, 0x58EDEC91EC2CB657}, // 1e104
+    {0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED}, // 1e105
+    {0x8B865B215899F46C, 0xBD79E0D20082EE74}, // 1e106
+    {0xAE67F1E9AEC07187, 0xECD8590680A3AA11}, // 1e107
+    {0xDA01EE641A708DE9, 0xE80E6F4820CC9495}, // 1e108
+    {0x884134FE908658B2, 0x3109058D147FDCDD}, // 1e109
+    {0xAA51823E34A7EEDE, 0xBD4B46F0599FD415}, // 1e110
+    {0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A}, // 1e111
+    {0x850FADC09923329E, 0x03E2CF6BC604DDB0}, // 1e112
+    {0xA6539930BF6BFF45, 0x84DB8346B786151C}, // 1e113
+    {0xCFE87F7CEF46FF16, 0xE612641865679A63}, // 1e114
+    {0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E}, // 1e115
+    {0xA26DA3999AEF7749, 0xE3BE5E330F38F09D}, // 1e116
+    {0xCB090C8001AB551C, 0x5CADF5BFD3072CC5}, // 1e117
+    {0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6}, // 1e118
+    {0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA}, // 1e119
+    {0xC646D63501A1511D, 0xB281E1FD541501B8}, // 1e120
+    {0xF7D88BC24209A565, 0x1F225A7CA91A4226}, // 1e121
+    {0x9AE757596946075F, 0x3375788DE9B06958}, // 1e122
+    {0xC1A12D2FC3978937, 0x0052D6B1641C83AE}, // 1e123
+    {0xF209787BB47D6B84, 0xC0678C5DBD23A49A}, // 1e124
+    {0x9745EB4D50CE6332, 0xF840B7BA963646E0}, // 1e125
+    {0xBD176620A501FBFF, 0xB650E5A93BC3D898}, // 1e126
+    {0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE}, // 1e127
+    {0x93BA47C980E98CDF, 0xC66F336C36B10137}, // 1e128
+    {0xB8A8D9BBE123F017, 0xB80B0047445D4184}, // 1e129
+    {0xE6D3102AD96CEC1D, 0xA60DC059157491E5}, // 1e130
+    {0x9043EA1AC7E41392, 0x87C89837AD68DB2F}, // 1e131
+    {0xB454E4A179DD1877, 0x29BABE4598C311FB}, // 1e132
+    {0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A}, // 1e133
+    {0x8CE2529E2734BB1D, 0x1899E4A65F58660C}, // 1e134
+    {0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F}, // 1e135
+    {0xDC21A1171D42645D, 0x76707543F4FA1F73}, // 1e136
+    {0x899504AE72497EBA, 0x6A06494A791C53A8}, // 1e137
+    {0xABFA45DA0EDBDE69, 0x0487DB9D17636892}, // 1e138
+    {0xD6F8D7509292D603, 0x45A9D2845D3C42B6}, // 1e139
+    {0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2}, // 1e140
+    {0xA7F26836F282B732, 0x8E6CAC7768D7141E}, // 1e141
+    {0xD1EF0244AF2364FF, 0x3207D795430CD926}, // 1e142
+    {0x8335616AED761F1F, 0x7F44E6BD49E807B8}, // 1e143
+    {0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6}, // 1e144
+    {0xCD036837130890A1, 0x36DBA887C37A8C0F}, // 1e145
+    {0x802221226BE55A64, 0xC2494954DA2C9789}, // 1e146
+    {0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C}, // 1e147
+    {0xC83553C5C8965D3D, 0x6F92829494E5ACC7}, // 1e148
+    {0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9}, // 1e149
+    {0x9C69A97284B578D7, 0xFF2A760414536EFB}, // 1e150
+    {0xC38413CF25E2D70D, 0xFEF5138519684ABA}, // 1e151
+    {0xF46518C2EF5B8CD1, 0x7EB258665FC25D69}, // 1e152
+    {0x98BF2F79D5993802, 0xEF2F773FFBD97A61}, // 1e153
+    {0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA}, // 1e154
+    {0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38}, // 1e155
+    {0x952AB45CFA97A0B2, 0xDD945A747BF26183}, // 1e156
+    {0xBA756174393D88DF, 0x94F971119AEEF9E4}, // 1e157
+    {0xE912B9D1478CEB17, 0x7A37CD5601AAB85D}, // 1e158
+    {0x91ABB422CCB812EE, 0xAC62E055C10AB33A}, // 1e159
+    {0xB616A12B7FE617AA, 0x577B986B314D6009}, // 1e160
+    {0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B}, // 1e161
+    {0x8E41ADE9FBEBC27D, 0x14588F13BE847307}, // 1e162
+    {0xB1D219647AE6B31C, 0x596EB2D8AE258FC8}, // 1e163
+    {0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB}, // 1e164
+    {0x8AEC23D680043BEE, 0x25DE7BB9480D5854}, // 1e165
+    {0xADA72CCC20054AE9, 0xAF561AA79A10AE6A}, // 1e166
+    {0xD910F7FF28069DA4, 0x1B2BA1518094DA04}, // 1e167
+    {0x87AA9AFF79042286, 0x90FB44D2F05D0842}, // 1e168
+    {0xA99541BF57452B28, 0x353A1607AC744A53}, // 1e169
+    {0xD3FA922F2D1675F2, 0x42889B8997915CE8}, // 1e170
+    {0x847C9B5D7C2E09B7, 0x69956135FEBADA11}, // 1e171
+    {0xA59BC234DB398C25, 0x43FAB9837E699095}, // 1e172
+    {0xCF02B2C21207EF2E, 0x94F967E45E03F4BB}, // 1e173
+    {0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5}, // 1e174
+    {0xA1BA1BA79E1632DC, 0x6462D92A69731732}, // 1e175
+    {0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE}, // 1e176
+    {0xFCB2CB35E702AF78, 0x5CDA735244C3D43E}, // 1e177
+    {0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7}, // 1e178
+    {0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0}, // 1e179
+    {0xF6C69A72A3989F5B, 0x8AAD549E57273D45}, // 1e180
+    {0x9A3C2087A63F6399, 0x36AC54E2F678864B}, // 1e181
+    {0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD}, // 1e182
+    {0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5}, // 1e183
+    {0x969EB7C47859E743, 0x9F644AE5A4B1B325}, // 1e184
+    {0xBC4665B596706114, 0x873D5D9F0DDE1FEE}, // 1e185
+    {0xEB57FF22FC0C7959, 0xA90CB506D155A7EA}, // 1e186
+    {0x9316FF75DD87CBD8, 0x09A7F12442D588F2}, // 1e187
+    {0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F}, // 1e188
+    {0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA}, // 1e189
+    {0x8FA475791A569D10, 0xF96E017D694487BC}, // 1e190
+    {0xB38D92D760EC4455, 0x37C981DCC395A9AC}, // 1e191
+    {0xE070F78D3927556A, 0x85BBE253F47B1417}, // 1e192
+    {0x8C469AB843B89562, 0x93956D7478CCEC8E}, // 1e193
+    {0xAF58416654A6BABB, 0x387AC8D1970027B2}, // 1e194
+    {0xDB2E51BFE9D0696A, 0x06997B05FCC0319E}, // 1e195
+    {0x88FCF317F22241E2, 0x441FECE3BDF81F03}, // 1e196
+    {0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3}, // 1e197
+    {0xD60B3BD56A5586F1, 0x8A71E223D8D3B074}, // 1e198
+    {0x85C7056562757456, 0xF6872D5667844E49}, // 1e199
+    {0xA738C6BEBB12D16C, 0xB428F8AC016561DB}, // 1e200
+    {0xD106F86E69D785C7, 0xE13336D701BEBA52}, // 1e201
+    {0x82A45B450226B39C, 0xECC0024661173473}, // 1e202
+    {0xA34D721642B06084, 0x27F002D7F95D0190}, // 1e203
+    {0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4}, // 1e204
+    {0xFF290242C83396CE, 0x7E67047175A15271}, // 1e205
+    {0x9F79A169BD203E41, 0x0F0062C6E984D386}, // 1e206
+    {0xC75809C42C684DD1, 0x52C07B78A3E60868}, // 1e207
+    {0xF92E0C3537826145, 0xA7709A56CCDF8A82}, // 1e208
+    {0x9BBCC7A142B17CCB, 0x88A66076400BB691}, // 1e209
+    {0xC2ABF989935DDBFE, 0x6ACFF893D00EA435}, // 1e210
+    {0xF356F7EBF83552FE, 0x0583F6B8C4124D43}, // 1e211
+    {0x98165AF37B2153DE, 0xC3727A337A8B704A}, // 1e212
+    {0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C}, // 1e213
+    {0xEDA2EE1C7064130C, 0x1162DEF06F79DF73}, // 1e214
+    {0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8}, // 1e215
+    {0xB9A74A0637CE2EE1, 0x6D953E2BD7173692}, // 1e216
+    {0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437}, // 1e217
+    {0x910AB1D4DB9914A0, 0x1D9C9892400A22A2}, // 1e218
+    {0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B}, // 1e219
+    {0xE2A0B5DC971F303A, 0x2E44AE64840FD61D}, // 1e220
+    {0x8DA471A9DE737E24, 0x5CEAECFED289E5D2}, // 1e221
+    {0xB10D8E1456105DAD, 0x7425A83E872C5F47}, // 1e222
+    {0xDD50F1996B947518, 0xD12F124E28F77719}, // 1e223
+    {0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F}, // 1e224
+    {0xACE73CBFDC0BFB7B, 0x636CC64D1001550B}, // 1e225
+    {0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E}, // 1e226
+    {0x8714A775E3E95C78, 0x65ACFAEC34810A71}, // 1e227
+    {0xA8D9D1535CE3B396, 0x7F1839A741A14D0D}, // 1e228
+    {0xD31045A8341CA07C, 0x1EDE48111209A050}, // 1e229
+    {0x83EA2B892091E44D, 0x934AED0AAB460432}, // 1e230
+    {0xA4E4B66B68B65D60, 0xF81DA84D5617853F}, // 1e231
+    {0xCE1DE40642E3F4B9, 0x36251260AB9D668E}, // 1e232
+    {0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019}, // 1e233
+    {0xA1075A24E4421730, 0xB24CF65B8612F81F}, // 1e234
+    {0xC94930AE1D529CFC, 0xDEE033F26797B627}, // 1e235
+    {0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1}, // 1e236
+    {0x9D412E0806E88AA5, 0x8E1F289560EE864E}, // 1e237
+    {0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2}, // 1e238
+    {0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB}, // 1e239
+    {0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29}, // 1e240
+    {0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3}, // 1e241
+    {0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0}, // 1e242
+    {0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E}, // 1e243
+    {0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1}, // 1e244
+    {0xEA53DF5FD18D5513, 0x84C86189216DC5ED}, // 1e245
+    {0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4}, // 1e246
+    {0xB7118682DBB66A77, 0x3FBC8C33221DC2A1}, // 1e247
+    {0xE4D5E82392A40515, 0x0FABAF3FEAA5334A}, // 1e248
+    {0x8F05B1163BA6832D, 0x29CB4D87F2A7400E}, // 1e249
+    {0xB2C71D5BCA9023F8, 0x743E20E9EF511012}, // 1e250
+    {0xDF78E4B2BD342CF6, 0x914DA9246B255416}, // 1e251
+    {0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E}, // 1e252
+    {0xAE9672ABA3D0C320, 0xA184AC2473B529B1}, // 1e253
+    {0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E}, // 1e254
+    {0x8865899617FB1871, 0x7E2FA67C7A658892}, // 1e255
+    {0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7}, // 1e256
+    {0xD51EA6FA85785631, 0x552A74227F3EA565}, // 1e257
+    {0x8533285C936B35DE, 0xD53A88958F87275F}, // 1e258
+    {0xA67FF273B8460356, 0x8A892ABAF368F137}, // 1e259
+    {0xD01FEF10A657842C, 0x2D2B7569B0432D85}, // 1e260
+    {0x8213F56A67F6B29B, 0x9C3B29620E29FC73}, // 1e261
+    {0xA298F2C501F45F42, 0x8349F3BA91B47B8F}, // 1e262
+    {0xCB3F2F7642717713, 0x241C70A936219A73}, // 1e263
+    {0xFE0EFB53D30DD4D7, 0xED238CD383AA0110}, // 1e264
+    {0x9EC95D1463E8A506, 0xF4363804324A40AA}, // 1e265
+    {0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5}, // 1e266
+    {0xF81AA16FDC1B81DA, 0xDD94B7868E94050A}, // 1e267
+    {0x9B10A4E5E9913128, 0xCA7CF2B4191C8326}, // 1e268
+    {0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0}, // 1e269
+    {0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC}, // 1e270
+    {0x976E41088617CA01, 0xD5BE0503E085D813}, // 1e271
+    {0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18}, // 1e272
+    {0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E}, // 1e273
+    {0x93E1AB8252F33B45, 0xCABB90E5C942B503}, // 1e274
+    {0xB8DA1662E7B00A17, 0x3D6A751F3B936243}, // 1e275
+    {0xE7109BFBA19C0C9D, 0x0CC512670A783AD4}, // 1e276
+    {0x906A617D450187E2, 0x27FB2B80668B24C5}, // 1e277
+    {0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6}, // 1e278
+    {0xE1A63853BBD26451, 0x5E7873F8A0396973}, // 1e279
+    {0x8D07E33455637EB2, 0xDB0B487B6423E1E8}, // 1e280
+    {0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62}, // 1e281
+    {0xDC5C5301C56B75F7, 0x7641A140CC7810FB}, // 1e282
+    {0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D}, // 1e283
+    {0xAC2820D9623BF429, 0x546345FA9FBDCD44}, // 1e284
+    {0xD732290FBACAF133, 0xA97C177947AD4095}, // 1e285
+    {0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D}, // 1e286
+    {0xA81F301449EE8C70, 0x5C68F256BFFF5A74}, // 1e287
+    {0xD226FC195C6A2F8C, 0x73832EEC6FFF3111}, // 1e288
+    {0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB}, // 1e289
+    {0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55}, // 1e290
+    {0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB}, // 1e291
+    {0x80444B5E7AA7CF85, 0x7980D163CF5B81B3}, // 1e292
+    {0xA0555E361951C366, 0xD7E105BCC332621F}, // 1e293
+    {0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7}, // 1e294
+    {0xFA856334878FC150, 0xB14F98F6F0FEB951}, // 1e295
+    {0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3}, // 1e296
+    {0xC3B8358109E84F07, 0x0A862F80EC4700C8}, // 1e297
+    {0xF4A642E14C6262C8, 0xCD27BB612758C0FA}, // 1e298
+    {0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C}, // 1e299
+    {0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3}, // 1e300
+    {0xEEEA5D5004981478, 0x1858CCFCE06CAC74}, // 1e301
+    {0x95527A5202DF0CCB, 0x0F37801E0C43EBC8}, // 1e302
+    {0xBAA718E68396CFFD, 0xD30560258F54E6BA}, // 1e303
+    {0xE950DF20247C83FD, 0x47C6B82EF32A2069}, // 1e304
+    {0x91D28B7416CDD27E, 0x4CDC331D57FA5441}, // 1e305
+    {0xB6472E511C81471D, 0xE0133FE4ADF8E952}, // 1e306
+    {0xE3D8F9E563A198E5, 0x58180FDDD97723A6}, // 1e307
+    {0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648}, // 1e308
+    {0xB201833B35D63F73, 0x2CD2CC6551E513DA}, // 1e309
+    {0xDE81E40A034BCF4F, 0xF8077F7EA65E58D1}, // 1e310
+    {0x8B112E86420F6191, 0xFB04AFAF27FAF782}, // 1e311
+    {0xADD57A27D29339F6, 0x79C5DB9AF1F9B563}, // 1e312
+    {0xD94AD8B1C7380874, 0x18375281AE7822BC}, // 1e313
+    {0x87CEC76F1C830548, 0x8F2293910D0B15B5}, // 1e314
+    {0xA9C2794AE3A3C69A, 0xB2EB3875504DDB22}, // 1e315
+    {0xD433179D9C8CB841, 0x5FA60692A46151EB}, // 1e316
+    {0x849FEEC281D7F328, 0xDBC7C41BA6BCD333}, // 1e317
+    {0xA5C7EA73224DEFF3, 0x12B9B522906C0800}, // 1e318
+    {0xCF39E50FEAE16BEF, 0xD768226B34870A00}, // 1e319
+    {0x81842F29F2CCE375, 0xE6A1158300D46640}, // 1e320
+    {0xA1E53AF46F801C53, 0x60495AE3C1097FD0}, // 1e321
+    {0xCA5E89B18B602368, 0x385BB19CB14BDFC4}, // 1e322
+    {0xFCF62C1DEE382C42, 0x46729E03DD9ED7B5}, // 1e323
+    {0x9E19DB92B4E31BA9, 0x6C07A2C26A8346D1}, // 1e324
+};
+
+result(json_element) json_parse(typed(json_string) json_str) {
+  if (json_str == NULL) {
+    return result_err(json_element)(JSON_ERROR_EMPTY);
+  }
+
+  return json_parse_n(json_str, strlen(json_str));
+}
+
+result(json_element) json_parse_n(typed(json_string) json_str,
+                                  typed(size) len) {
+  return json_parse_with_options(json_str, len, NULL);
+}
+
+result(json_element)
+    json_parse_with_options(typed(json_string) json_str, typed(size) len,
+                            const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_element)(JSON_ERROR_EMPTY);
+  }
+
+  typed(json_parser) parser;
+  json_parser_init(&parser, json_str, len, options, NULL);
+
+  result(json_element) root_result = json_parse_root(&parser, json_str);
+  json_parser_finish(&parser);
+
+  return root_result;
+}
+
+result(json_document) json_parse_document(typed(json_string) json_str) {
+  if (json_str == NULL) {
+    return result_err(json_document)(JSON_ERROR_EMPTY);
+  }
+
+  return json_parse_document_n(json_str, strlen(json_str));
+}
+
+result(json_document) json_parse_document_n(typed(json_string) json_str,
+                                            typed(size) len) {
+  return json_parse_document_with_options(json_str, len, NULL);
+}
+
+result(json_document)
+    json_parse_document_with_options(typed(json_string) json_str,
+                                     typed(size) len,
+                                     const typed(json_parse_options) *
+                                         options) {
+  return json_parse_document_into(json_str, len, options, false);
+}
+
+result(json_document)
+    json_parse_document_in_situ(char *json_str, typed(size) len,
+                                const typed(json_parse_options) * options) {
+  return json_parse_document_into(json_str, len, options, true);
+}
+
+result(json_document)
+    json_parse_document_into(typed(json_string) json_str, typed(size) len,
+                             const typed(json_parse_options) * options,
+                             bool in_situ) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_document)(JSON_ERROR_EMPTY);
+  }
+
+  typed(json_parser) parser;
+  json_parser_init(&parser, json_str, len, options, json_arena_new(len));
+  parser.in_situ = in_situ;
+
+  result(json_element) root_result = json_parse_root(&parser, json_str);
+  json_parser_finish(&parser);
+  if (result_is_err(json_element)(&root_result)) {
+    json_arena_free(parser.arena);
+    return result_map_err(json_document, json_element, &root_result);
+  }
+
+  const typed(json_document) document = {
+      .root = result_unwrap(json_element)(&root_result),
+      .arena = parser.arena,
+  };
+
+  return result_ok(json_document)(document);
+}
+
+void json_parser_init(typed(json_parser) * parser, typed(json_string) json_str,
+                      typed(size) len,
+                      const typed(json_parse_options) * options,
+                      typed(json_arena) * arena) {
+  parser->arena = arena;
+  parser->end = json_str + len;
+  parser->stack = NULL;
+  parser->stack_size = 0;
+  parser->stack_capacity = 0;
+  parser->frame = 0;
+  parser->depth = 0;
+  parser->max_depth = options != NULL && options->max_depth != 0
+                          ? options->max_depth
+                          : JSON_DEFAULT_MAX_DEPTH;
+  parser->skip_whitespace = options != NULL ? options->skip_whitespace
+                                            : JSON_DEFAULT_SKIP_WHITESPACE;
+  parser->index.positions = NULL;
+  parser->index.sizes = NULL;
+  parser->in_situ = false;
+  // Strings of a tree are freed one by one, so only documents hold views
+  parser->string_views =
+      options != NULL && options->string_views && arena != NULL;
+  // Shared keys and shapes too would be freed once for every object of
+  // a tree
+  bool share_shapes =
+      options != NULL && options->share_shapes && arena != NULL;
+  bool intern_keys =
+      options != NULL && options->intern_keys && arena != NULL;
+  parser->keys.slots = NULL;
+  if (intern_keys || share_shapes) {
+    parser->keys.count = 0;
+    parser->keys.capacity = JSON_KEY_TABLE_INITIAL_CAPACITY;
+    parser->keys.slots =
+        allocN(typed(json_key_table_slot), parser->keys.capacity);
+    for (typed(size) i = 0; i < parser->keys.capacity; i++)
+      parser->keys.slots[i].key = NULL;
+  }
+  parser->shapes.slots = NULL;
+  if (share_shapes) {
+    parser->shapes.count = 0;
+    parser->shapes.capacity = JSON_SHAPE_TABLE_INITIAL_CAPACITY;
+    parser->shapes.slots =
+        allocN(typed(json_shape_table_slot), parser->shapes.capacity);
+    for (typed(size) i = 0; i < parser->shapes.capacity; i++)
+      parser->shapes.slots[i].shape = NULL;
+  }
+
+  if (options != NULL && options->structural_index)
+    json_index_build(parser, &parser->index, json_str, len);
+}
+
+void json_parser_finish(typed(json_parser) * parser) {
+  free(parser->stack);
+  free(parser->keys.slots);
+  free(parser->shapes.slots);
+  json_index_free(&parser->index);
+}
+
+result(json_element) json_parse_root(typed(json_parser) * parser,
+                                     typed(json_string) json_str) {
+  json_skip_whitespace(parser, &json_str);
+
+  result_try(json_element, json_element_type, type,
+             json_guess_element_type(parser, json_str));
+  result_try(json_element, json_element_value, value,
+             json_parse_element_value(parser, &json_str, type));
+
+  const typed(json_element) element = {
+      .type = type,
+      .value = value,
+  };
+
+  return result_ok(json_element)(element);
+}
+
+result(json_element_type) json_guess_element_type(typed(json_parser) * parser,
+                                                  typed(json_string) str) {
+  const char ch = json_peek(parser, str);
+  typed(json_element_type) type;
+
+  if (json_is_string(ch))
+    type = JSON_ELEMENT_TYPE_STRING;
+  else if (json_is_object(ch))
+    type = JSON_ELEMENT_TYPE_OBJECT;
+  else if (json_is_array(ch))
+    type = JSON_ELEMENT_TYPE_ARRAY;
+  else if (json_is_null(ch))
+    type = JSON_ELEMENT_TYPE_NULL;
+  else if (json_is_number(ch))
+    type = JSON_ELEMENT_TYPE_NUMBER;
+  else if (json_is_boolean(ch))
+    type = JSON_ELEMENT_TYPE_BOOLEAN;
+  else
+    return result_err(json_element_type)(JSON_ERROR_INVALID_TYPE);
+
+  return result_ok(json_element_type)(type);
+}
+
+bool json_is_string(char ch) { return ch == '"'; }
+
+bool json_is_number(char ch) {
+  return (ch >= '0' && ch <= '9') || ch == '+' || ch == '-' || ch == '.' ||
+         ch == 'e' || ch == 'E';
+}
+
+bool json_is_object(char ch) { return ch == '{'; }
+
+bool json_is_array(char ch) { return ch == '['; }
+
+bool json_is_boolean(char ch) { return ch == 't' || ch == 'f'; }
+
+bool json_is_null(char ch) { return ch == 'n'; }
+
+result(json_element_value)
+    json_parse_element_value(typed(json_parser) * parser,
+                             typed(json_string) * str_ptr,
+                             typed(json_element_type) type) {
+  // Strings and containers jump along the structural index if there is
+  // one. Scalars hold no structural characters
+  bool indexed = parser->index.positions != NULL;
+
+  switch (type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    return indexed ? json_parse_string_indexed(parser, str_ptr, NULL)
+                   : json_parse_string(parser, str_ptr, NULL);
+  case JSON_ELEMENT_TYPE_NUMBER:
+    return json_parse_number(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_OBJECT:
+  case JSON_ELEMENT_TYPE_ARRAY:
+    return json_parse_container(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_BOOLEAN:
+    return json_parse_boolean(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_NULL:
+    json_skip_null(parser, str_ptr);
+    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+  default:
+    return result_err(json_element_value)(JSON_ERROR_INVALID_TYPE);
+  }
+}
+
+result(json_element_value) json_parse_string(typed(json_parser) * parser,
+                                             typed(json_string) * str_ptr,
+                                             typed(uint64) * key_hash) {
+  // Skip the first '"' character
+  (*str_ptr)++;
+
+  bool escaped;
+  typed(size) len = json_string_len(parser, *str_ptr, &escaped);
+  if (len == 0) {
+    // Skip the end quote
+    json_skip_char(parser, str_ptr);
+    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+  }
+
+  typed(json_string) str = *str_ptr;
+
+  // Skip to beyond the string, even if it turns out to be malformed
+  (*str_ptr) += len + 1;
+
+  if (key_hash != NULL)
+    return json_key_value(parser, str, len, escaped, key_hash);
+
+  return json_string_value(parser, str, len, escaped);
+}
+
+result(json_element_value)
+    json_string_value(typed(json_parser) * parser, typed(json_string) str,
+                      typed(size) len, bool escaped) {
+  typed(json_element_value) retval = {0};
+  char *output;
+
+  if (parser->in_situ) {
+    // The caller handed the input over as mutable
+    output = (char *)str;
+  } else if (!escaped && parser->string_views) {
+    retval.as_view.data = str;
+    retval.as_view.len = len;
+    return result_ok(json_element_value)(retval);
+  } else {
+    output = parser_allocN(parser, char, len + 1);
+  }
+
+  // Most strings have no escapes at all and need no second scan
+  if (!escaped) {
+    if (output != str)
+      memcpy(output, str, len);
+    output[len] = '\0';
+    retval.as_view.data = output;
+    retval.as_view.len = len;
+    return result_ok(json_element_value)(retval);
+  }
+
+  result(size) len_result = json_unescape_string(str, len, output);
+  if (result_is_err(size)(&len_result)) {
+    if (output != str)
+      json_parser_free(parser, output);
+    return result_map_err(json_element_value, size, &len_result);
+  }
+
+  retval.as_view.data = output;
+  retval.as_view.len = result_unwrap(size)(&len_result);
+
+  return result_ok(json_element_value)(retval);
+}
+
+result(json_element_value)
+    json_key_value(typed(json_parser) * parser, typed(json_string) str,
+                   typed(size) len, bool escaped, typed(uint64) * hash) {
+  typed(json_key_table) *keys = &parser->keys;
+
+  if (keys->slots == NULL) {
+    result_try(json_element_value, json_element_value, key,
+               json_string_value(parser, str, len, escaped));
+    *hash = json_key_hash(key.as_view.data, key.as_view.len);
+    return result_ok(json_element_value)(key);
+  }
+
+  // A key with escapes is looked up unescaped, from the scratch stack
+  typed(size) mark = parser->stack_size;
+  typed(json_string) key = str;
+  typed(size) key_len = len;
+
+  if (escaped) {
+    char *unescaped = (char *)json_parser_stack_push(parser, len + 1);
+    result(size) len_result = json_unescape_string(str, len, unescaped);
+    if (result_is_err(size)(&len_result)) {
+      parser->stack_size = mark;
+      return result_map_err(json_element_value, size, &len_result);
+    }
+
+    key = unescaped;
+    key_len = result_unwrap(size)(&len_result);
+  }
+
+  *hash = json_key_hash(key, key_len);
+  typed(json_key_table_slot) *slot =
+      json_key_table_find(keys, key, key_len, *hash);
+  parser->stack_size = mark;
+
+  if (slot->key == NULL) {
+    // Met for the first time, so made like any string
+    result_try(json_element_value, json_element_value, value,
+               json_string_value(parser, str, len, escaped));
+
+    slot->hash = *hash;
+    slot->key = value.as_view.data;
+    slot->key_len = value.as_view.len;
+
+    if (++keys->count > keys->capacity / 2)
+      json_key_table_grow(keys);
+
+    return result_ok(json_element_value)(value);
+  }
+
+  typed(json_element_value) retval = {0};
+  retval.as_view.data = slot->key;
+  retval.as_view.len = slot->key_len;
+
+  return result_ok(json_element_value)(retval);
+}
+
+typed(json_key_table_slot) *
+    json_key_table_find(typed(json_key_table) * keys, typed(json_string) key,
+                        typed(size) len, typed(uint64) hash) {
+  typed(size) mask = keys->capacity - 1;
+
+  for (typed(size) bucket = hash & mask;; bucket = (bucket + 1) & mask) {
+    typed(json_key_table_slot) *slot = &keys->slots[bucket];
+
+    if (slot->key == NULL ||
+        (slot->hash == hash && slot->key_len == len &&
+         memcmp(slot->key, key, len) == 0))
+      return slot;
+  }
+}
+
+void json_key_table_grow(typed(json_key_table) * keys) {
+  typed(json_key_table_slot) *old_slots = keys->slots;
+  typed(size) old_capacity = keys->capacity;
+
+  keys->capacity *= 2;
+  keys->slots = allocN(typed(json_key_table_slot), keys->capacity);
+  for (typed(size) i = 0; i < keys->capacity; i++)
+    keys->slots[i].key = NULL;
+
+  // Keys are distinct, so each goes to the first empty slot of its chain
+  typed(size) mask = keys->capacity - 1;
+  for (typed(size) i = 0; i < old_capacity; i++) {
+    if (old_slots[i].key == NULL)
+      continue;
+
+    typed(size) bucket = old_slots[i].hash & mask;
+    while (keys->slots[bucket].key != NULL)
+      bucket = (bucket + 1) & mask;
+
+    keys->slots[bucket] = old_slots[i];
+  }
+
+  free(old_slots);
+}
+
+result(json_element_value)
+    json_parse_string_indexed(typed(json_parser) * parser,
+                              typed(json_string) * str_ptr,
+                              typed(uint64) * key_hash) {
+  typed(json_index) *index = &parser->index;
+
+  // The opening quote has to be the next position, or the string is
+  // out of place, e.g. following a scalar without a ','
+  if (index->next >= index->count ||
+      index->begin + index->positions[index->next] != *str_ptr)
+    return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+
+  // Quotes always come in pairs and nothing in between is indexed
+  typed(json_string) str = *str_ptr + 1;
+  typed(json_string) close = index->begin + index->positions[index->next + 1];
+  typed(size) len = close - str;
+  bool escaped = index->sizes[index->next + 1];
+
+  index->next += 2;
+  *str_ptr = close + 1;
+
+  if (len == 0)
+    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+
+  if (key_hash != NULL)
+    return json_key_value(parser, str, len, escaped, key_hash);
+
+  return json_string_value(parser, str, len, escaped);
+}
+
+result(json_element_value) json_parse_number(typed(json_parser) * parser,
+                                             typed(json_string) * str_ptr) {
+  typed(json_string) start = *str_ptr;
+  typed(json_string) iter = start;
+  typed(json_string) end = parser->end;
+  bool negative = false;
+
+  if (iter < end && (*iter == '-' || *iter == '+')) {
+    negative = *iter == '-';
+    iter++;
+  }
+
+  // The first 19 significant digits make the mantissa. Leading zeros are
+  // not significant, digits after the 19th only move the exponent
+  typed(uint64) mantissa = 0;
+  typed(int64) exponent = 0;
+  int digits = 0;
+  bool truncated = false;
+  bool has_digits = false;
+  bool is_double = false;
+
+  for (; iter < end && is_digit(*iter); iter++) {
+    has_digits = true;
+    if (digits < JSON_MANTISSA_DIGITS) {
+      mantissa = mantissa * 10 + (typed(uint64))(*iter - '0');
+      digits += mantissa != 0;
+    } else {
+      exponent++;
+      truncated |= *iter != '0';
+    }
+  }
+
+  if (iter < end && *iter == '.') {
+    is_double = true;
+    iter++;
+
+    for (; iter < end && is_digit(*iter); iter++) {
+      has_digits = true;
+      if (digits < JSON_MANTISSA_DIGITS) {
+        mantissa = mantissa * 10 + (typed(uint64))(*iter - '0');
+        digits += mantissa != 0;
+        exponent--;
+      } else {
+        truncated |= *iter != '0';
+      }
+    }
+  }
+
+  if (!has_digits) {
+    json_skip_number(parser, str_ptr);
+    return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+  }
+
+  // An exponent without digits is not part of the number, as in `strtod`
+  if (iter < end && (*iter == 'e' || *iter == 'E')) {
+    typed(json_string) exponent_iter = iter + 1;
+    bool exponent_negative = false;
+
+    if (exponent_iter < end &&
+        (*exponent_iter == '-' || *exponent_iter == '+')) {
+      exponent_negative = *exponent_iter == '-';
+      exponent_iter++;
+    }
+
+    if (exponent_iter < end && is_digit(*exponent_iter)) {
+      // Exponents this large already give a zero or an infinite double
+      typed(int64) explicit_exponent = 0;
+      for (; exponent_iter < end && is_digit(*exponent_iter); exponent_iter++)
+        if (explicit_exponent < 100000)
+          explicit_exponent = explicit_exponent * 10 + (*exponent_iter - '0');
+
+      exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+      is_double = true;
+      iter = exponent_iter;
+    }
+  }
+
+  *str_ptr = iter;
+
+  typed(json_element_value) retval = {0};
+
+  if (!is_double) {
+    // Integers must fit a long, any digit after the 19th overflows it
+    typed(uint64) limit = (typed(uint64))LONG_MAX + negative;
+    if (exponent > 0 || mantissa > limit)
+      return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+
+    retval.as_number.type = JSON_NUMBER_TYPE_LONG;
+    if (!negative)
+      retval.as_number.value.as_long = (typed(json_number_long))mantissa;
+    else if (mantissa == limit)
+      retval.as_number.value.as_long = LONG_MIN;
+    else
+      retval.as_number.value.as_long = -(typed(json_number_long))mantissa;
+
+    return result_ok(json_element_value)(retval);
+  }
+
+  double value;
+  if (!json_decimal_to_double(mantissa, exponent, negative, truncated,
+                              &value) &&
+      !json_strtod(start, iter, &value))
+    return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+
+  retval.as_number.type = JSON_NUMBER_TYPE_DOUBLE;
+  retval.as_number.value.as_double = value;
+
+  return result_ok(json_element_value)(retval);
+}
+
+bool json_decimal_to_double(typed(uint64) mantissa, typed(int64) exponent,
+                            bool negative, bool truncated, double *out) {
+  if (mantissa == 0) {
+    *out = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+  // Both the mantissa and the power of ten are exact doubles, so one
+  // correctly rounded operation gives the correctly rounded result
+#if FLT_EVAL_METHOD == 0
+  if (!truncated && mantissa <= (typed(uint64))1 << 53 && exponent >= -22 &&
+      exponent <= 22) {
+    double value = (double)mantissa;
+    if (exponent < 0)
+      value /= json_exact_powers_of_ten[-exponent];
+    else
+      value *= json_exact_powers_of_ten[exponent];
+
+    *out = negative ? -value : value;
+    return true;
+  }
+#endif
+
+  if (!json_eisel_lemire(mantissa, exponent, negative, out))
+    return false;
+
+  // The digits dropped put the number between the mantissa and the next
+  // one up, both of which must round to the same double
+  double upper;
+  return !truncated ||
+         (json_eisel_lemire(mantissa + 1, exponent, negative, &upper) &&
+          upper == *out);
+}
+
+bool json_eisel_lemire(typed(uint64) mantissa, typed(int64) exponent,
+                       bool negative, double *out) {
+  if (exponent < JSON_POWER_OF_TEN_MIN || exponent > JSON_POWER_OF_TEN_MAX)
+    return false;
+
+  const typed(uint64) *power =
+      json_powers_of_ten[exponent - JSON_POWER_OF_TEN_MIN];
+
+  // Normalize the mantissa so that its top bit is set
+  int leading_zeros = 0;
+  while ((mantissa & ((typed(uint64))1 << 63)) == 0) {
+    mantissa <<= 1;
+    leading_zeros++;
+  }
+
+  // 217706 / 2^16 approximates log2(10) closely enough over the table
+  typed(int64) binary_exponent =
+      ((217706 * exponent) >> 16) + 64 + 1023 - leading_zeros;
+
+  typed(uint64) high;
+  typed(uint64) low = json_multiply_128(mantissa, power[0], &high);
+
+  // The truncated low half of the power of ten may still carry into the
+  // 9 bits below the mantissa of the result
+  if ((high & 0x1FF) == 0x1FF && low + mantissa < mantissa) {
+    typed(uint64) extra_high;
+    typed(uint64) extra_low =
+        json_multiply_128(mantissa, power[1], &extra_high);
+
+    typed(uint64) merged_high = high;
+    typed(uint64) merged_low = low + extra_high;
+    if (merged_low < low)
+      merged_high++;
+
+    if ((merged_high & 0x1FF) == 0x1FF && merged_low + 1 == 0 &&
+        extra_low + mantissa < mantissa)
+      return false;
+
+    high = merged_high;
+    low = merged_low;
+  }
+
+  // Keep 54 bits, one more than the mantissa of a double to round with
+  typed(uint64) top = high >> 63;
+  typed(uint64) result_mantissa = high >> (top + 9);
+  binary_exponent -= 1 ^ top;
+
+  // Exactly halfway between two doubles, which the rounding below would
+  // resolve away from even
+  if (low == 0 && (high & 0x1FF) == 0 && (result_mantissa & 3) == 1)
+    return false;
+
+  result_mantissa += result_mantissa & 1;
+  result_mantissa >>= 1;
+  if (result_mantissa >> 53 > 0) {
+    result_mantissa >>= 1;
+    binary_exponent++;
+  }
+
+  // Subnormals, infinities and their range errors are left to `strtod`
+  if (binary_exponent <= 0 || binary_exponent >= 0x7FF)
+    return false;
+
+  typed(uint64) bits = (typed(uint64))binary_exponent << 52 |
+                       (result_mantissa & (((typed(uint64))1 << 52) - 1));
+  if (negative)
+    bits |= (typed(uint64))1 << 63;
+
+  memcpy(out, &bits, sizeof(bits));
+  return true;
+}
+
+typed(uint64) json_multiply_128(typed(uint64) a, typed(uint64) b,
+                                typed(uint64) * high) {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 product = (unsigned __int128)a * b;
+  *high = (typed(uint64))(product >> 64);
+  return (typed(uint64))product;
+#else
+  typed(uint64) a_low = a & 0xFFFFFFFF, a_high = a >> 32;
+  typed(uint64) b_low = b & 0xFFFFFFFF, b_high = b >> 32;
+
+  typed(uint64) low_low = a_low * b_low;
+  typed(uint64) high_low = a_high * b_low;
+  typed(uint64) low_high = a_low * b_high;
+  typed(uint64) high_high = a_high * b_high;
+
+  typed(uint64) middle =
+      (low_low >> 32) + (high_low & 0xFFFFFFFF) + (low_high & 0xFFFFFFFF);
+
+  *high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+  return (middle << 32) | (low_low & 0xFFFFFFFF);
+#endif
+}
+
+bool json_strtod(typed(json_string) str, typed(json_string) end,
+                 double *out) {
+  // `strtod` needs a NUL-terminated string, which the input need not be,
+  // and reads the decimal point of the current locale
+  typed(size) len = end - str;
+  char buffer[JSON_NUMBER_BUFFER_SIZE];
+  char *number_str = len < sizeof(buffer) ? buffer : allocN(char, len + 1);
+  memcpy(number_str, str, len);
+  number_str[len] = '\0';
+
+  char decimal_point = localeconv()->decimal_point[0];
+  if (decimal_point != '.') {
+    char *point = (char *)memchr(number_str, '.', len);
+    if (point != NULL)
+      *point = decimal_point;
+  }
+
+  errno = 0;
+  *out = strtod(number_str, NULL);
+
+  // Subnormal results and underflows to zero set `ERANGE` too, but are
+  // still the correctly rounded value. Only overflows are rejected
+  bool in_range = errno != ERANGE || (*out != HUGE_VAL && *out != -HUGE_VAL);
+
+  if (number_str != buffer)
+    free(number_str);
+
+  return in_range;
+}
+
+result(json_element_value)
+    json_parse_container(typed(json_parser) * parser,
+                         typed(json_string) * str_ptr) {
+  bool indexed = parser->index.positions != NULL;
+  typed(json_index) *index = &parser->index;
+  typed(size) depth = parser->depth;
+
+  // Every turn opens the container at the string pointer
+  for (;;) {
+    if (parser->depth >= parser->max_depth)
+      return json_frame_unwind(parser, depth);
+
+    typed(json_element_type) type = **str_ptr == '{'
+                                        ? JSON_ELEMENT_TYPE_OBJECT
+                                        : JSON_ELEMENT_TYPE_ARRAY;
+    result(json_element_value) value_result =
+        result_err(json_element_value)(JSON_ERROR_EMPTY);
+
+    if (indexed &&
+        (index->next >= index->count ||
+         index->begin + index->positions[index->next] != *str_ptr)) {
+      value_result = result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+    } else if (indexed ? json_frame_open_indexed(parser, str_ptr)
+                       : json_frame_open(parser, str_ptr)) {
+      if (indexed ? json_frame_items_indexed(parser, str_ptr, false)
+                  : json_frame_items(parser, str_ptr, false))
+        continue;
+
+      value_result = json_frame_close(parser, &type);
+    }
+
+    // Hand each complete container to the one it is nested in, which
+    // goes on with its items until one more has to be opened
+    for (;;) {
+      if (parser->depth == depth)
+        return value_result;
+
+      json_frame_add(parser, type, value_result);
+
+      if (indexed ? json_frame_items_indexed(parser, str_ptr, true)
+                  : json_frame_items(parser, str_ptr, true))
+        break;
+
+      value_result = json_frame_close(parser, &type);
+    }
+  }
+}
+
+bool json_frame_open(typed(json_parser) * parser,
+                     typed(json_string) * str_ptr) {
+  char bracket = **str_ptr;
+
+  // Skip the opening bracket
+  (*str_ptr)++;
+
+  json_skip_whitespace(parser, str_ptr);
+
+  if (json_peek(parser, *str_ptr) == (bracket == '{' ? '}' : ']')) {
+    // Skip the closing bracket
+    (*str_ptr)++;
+    return false;
+  }
+
+  json_frame_push(parser, bracket, 0, NULL);
+
+  return true;
+}
+
+bool json_frame_open_indexed(typed(json_parser) * parser,
+                             typed(json_string) * str_ptr) {
+  typed(json_index) *index = &parser->index;
+  char bracket = **str_ptr;
+  typed(size) capacity = index->sizes[index->next++];
+
+  // An empty container holds nothing but whitespace before its closing
+  // bracket
+  if (capacity == 0) {
+    *str_ptr = index->begin + index->positions[index->next++] + 1;
+    return false;
+  }
+
+  if (bracket == '[') {
+    // The size is known up front, so the elements are parsed right into
+    // their final buffer
+    json_frame_push(parser, bracket, capacity,
+                    parser_allocN(parser, typed(json_element), capacity));
+  } else {
+    // Reserve room for every entry at once, nested containers using the
+    // stack above it
+    json_frame_push(parser, bracket, capacity, NULL);
+    json_parser_stack_push(parser,
+                           capacity * sizeof(typed(json_parsed_entry)));
+  }
+
+  return true;
+}
+
+void json_frame_push(typed(json_parser) * parser, char bracket,
+                     typed(size) capacity, typed(json_element) * elements) {
+  typed(size) offset = parser->stack_size;
+  typed(json_frame) *frame = parser_stack_push(parser, typed(json_frame));
+
+  frame->parent = parser->frame;
+  frame->bracket = bracket;
+  frame->count = 0;
+  frame->capacity = capacity;
+  frame->elements = elements;
+  frame->key.data = NULL;
+  frame->key.len = 0;
+  frame->hash = 0;
+
+  parser->frame = offset;
+  parser->depth++;
+}
+
+bool json_frame_items(typed(json_parser) * parser,
+                      typed(json_string) * str_ptr, bool resume) {
+  bool is_object = parser_frame(parser)->bracket == '{';
+  char close = is_object ? '}' : ']';
+
+  // A nested container is followed by whitespace like any other item
+  if (resume)
+    json_skip_whitespace(parser, str_ptr);
+
+  for (bool first = !resume;; first = false) {
+    if (!first) {
+      if (json_peek(parser, *str_ptr) == close)
+        break;
+
+      // Skip the ',' to move to the next item
+      json_skip_char(parser, str_ptr);
+    }
+
+    if (*str_ptr >= parser->end)
+      break;
+
+    // Skip any accidental whitespace
+    json_skip_whitespace(parser, str_ptr);
+
+    if (json_frame_item(parser, str_ptr, is_object))
+      return true;
+  }
+
+  // Skip the closing bracket
+  json_skip_char(parser, str_ptr);
+
+  return false;
+}
+
+bool json_frame_items_indexed(typed(json_parser) * parser,
+                              typed(json_string) * str_ptr, bool resume) {
+  typed(json_index) *index = &parser->index;
+  bool is_object = parser_frame(parser)->bracket == '{';
+  char close = is_object ? '}' : ']';
+
+  // Brackets are balanced, so the closing one is always reached
+  for (bool first = !resume;; first = false) {
+    if (!first) {
+      // Drop whatever is left of a malformed item
+      char delimiter = index->begin[index->positions[index->next]];
+      if (delimiter != ',' && delimiter != close) {
+        json_index_skip_item(index);
+        delimiter = index->begin[index->positions[index->next]];
+      }
+
+      if (delimiter == close)
+        break;
+
+      // Skip the ','
+      index->next++;
+    }
+
+    if (json_frame_item_indexed(parser, str_ptr, is_object))
+      return true;
+  }
+
+  // Skip the closing bracket
+  *str_ptr = index->begin + index->positions[index->next++] + 1;
+
+  return false;
+}
+
+bool json_frame_item(typed(json_parser) * parser,
+                     typed(json_string) * str_ptr, bool is_object) {
+  typed(json_string_view) key = {0};
+  typed(uint64) hash = 0;
+
+  if (is_object) {
+    result(json_element_value) key_result =
+        json_parse_string(parser, str_ptr, &hash);
+    if (result_is_err(json_element_value)(&key_result)) {
+      // Drop the value along with the key, as the indexed path does, so
+      // that it is not read as the next key
+      json_skip_entry_value(parser, str_ptr);
+      json_skip_whitespace(parser, str_ptr);
+      return false;
+    }
+    key = result_unwrap(json_element_value)(&key_result).as_view;
+
+    json_skip_whitespace(parser, str_ptr);
+
+    // Skip the ':' delimiter
+    json_skip_char(parser, str_ptr);
+
+    json_skip_whitespace(parser, str_ptr);
+  }
+
+  result(json_element_type) type_result =
+      json_guess_element_type(parser, *str_ptr);
+  if (result_is_err(json_element_type)(&type_result)) {
+    if (is_object) {
+      json_parser_free(parser, (void *)key.data);
+      json_skip_whitespace(parser, str_ptr);
+    }
+    return false;
+  }
+  typed(json_element_type) type =
+      result_unwrap(json_element_type)(&type_result);
+
+  typed(json_frame) *frame = parser_frame(parser);
+  frame->key = key;
+  frame->hash = hash;
+
+  if (type == JSON_ELEMENT_TYPE_OBJECT || type == JSON_ELEMENT_TYPE_ARRAY)
+    return true;
+
+  json_frame_add(parser, type, json_parse_element_value(parser, str_ptr, type));
+  json_skip_whitespace(parser, str_ptr);
+
+  return false;
+}
+
+bool json_frame_item_indexed(typed(json_parser) * parser,
+                             typed(json_string) * str_ptr, bool is_object) {
+  typed(json_index) *index = &parser->index;
+  typed(json_string_view) key = {0};
+  typed(uint64) hash = 0;
+  typed(json_string) str;
+
+  if (is_object) {
+    str = index->begin + index->positions[index->next];
+
+    // Anything but a key is dropped along with the rest of the entry
+    if (*str != '"')
+      return false;
+
+    result(json_element_value) key_result =
+        json_parse_string_indexed(parser, &str, &hash);
+    if (result_is_err(json_element_value)(&key_result))
+      return false;
+    key = result_unwrap(json_element_value)(&key_result).as_view;
+
+    // The key has to be followed by the ':' delimiter
+    if (index->begin[index->positions[index->next]] != ':') {
+      json_parser_free(parser, (void *)key.data);
+      return false;
+    }
+
+    str = index->begin + index->positions[index->next++] + 1;
+  } else {
+    // Every element follows the '[' or a ','. Scalars are not indexed,
+    // so the element after the last ',' is only found here
+    str = index->begin + index->positions[index->next - 1] + 1;
+  }
+
+  json_skip_whitespace(parser, &str);
+
+  result(json_element_type) type_result = json_guess_element_type(parser, str);
+  if (result_is_err(json_element_type)(&type_result)) {
+    json_parser_free(parser, (void *)key.data);
+    return false;
+  }
+  typed(json_element_type) type =
+      result_unwrap(json_element_type)(&type_result);
+
+  typed(json_frame) *frame = parser_frame(parser);
+  frame->key = key;
+  frame->hash = hash;
+
+  if (type == JSON_ELEMENT_TYPE_OBJECT || type == JSON_ELEMENT_TYPE_ARRAY) {
+    *str_ptr = str;
+    return true;
+  }
+
+  json_frame_add(parser, type, json_parse_element_value(parser, &str, type));
+
+  return false;
+}
+
+void json_frame_add(typed(json_parser) * parser, typed(json_element_type) type,
+                    result(json_element_value) value_result) {
+  typed(json_frame) *frame = parser_frame(parser);
+  typed(json_string_view) key = frame->key;
+  typed(uint64) hash = frame->hash;
+  typed(size) count = frame->count;
+
+  frame->key.data = NULL;
+
+  if (result_is_err(json_element_value)(&value_result)) {
+    json_parser_free(parser, (void *)key.data);
+    return;
+  }
+
+  typed(json_element) element = {
+      .type = type,
+      .value = result_unwrap(json_element_value)(&value_result),
+  };
+
+  if (frame->elements != NULL) {
+    if (count < frame->capacity) {
+      frame->elements[count] = element;
+      frame->count++;
+    }
+    return;
+  }
+
+  // Pushing may move the stack, frame included
+  frame->count++;
+
+  if (frame->bracket == '[') {
+    *parser_stack_push(parser, typed(json_element)) = element;
+    return;
+  }
+
+  // Room was made for the first `capacity` entries, which the stack then
+  // goes on from
+  typed(json_parsed_entry) *parsed =
+      count < frame->capacity
+          ? parser_stack_at(parser, typed(json_parsed_entry),
+                            parser_frame_items(parser)) +
+                count
+          : parser_stack_push(parser, typed(json_parsed_entry));
+  parsed->entry.key = key.data;
+  parsed->entry.key_len = key.len;
+  parsed->entry.element = element;
+  parsed->hash = hash;
+}
+
+result(json_element_value)
+    json_frame_close(typed(json_parser) * parser,
+                     typed(json_element_type) * type) {
+  typed(size) offset = parser->frame;
+  typed(size) mark = parser_frame_items(parser);
+  typed(json_frame) *frame = parser_frame(parser);
+  typed(size) count = frame->count;
+  typed(json_element) *elements = frame->elements;
+  bool is_object = frame->bracket == '{';
+
+  parser->frame = frame->parent;
+  parser->depth--;
+  *type = is_object ? JSON_ELEMENT_TYPE_OBJECT : JSON_ELEMENT_TYPE_ARRAY;
+
+  typed(json_element_value) retval = {0};
+
+  if (count == 0) {
+    json_parser_free(parser, elements);
+    parser->stack_size = offset;
+    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+  }
+
+  if (is_object) {
+    retval.as_object = json_object_build(
+        parser, parser_stack_at(parser, typed(json_parsed_entry), mark),
+        count);
+  } else {
+    if (elements == NULL) {
+      // Copy the elements off the scratch stack into an exactly sized
+      // buffer
+      elements = parser_allocN(parser, typed(json_element), count);
+      memcpy(elements, parser_stack_at(parser, typed(json_element), mark),
+             count * sizeof(typed(json_element)));
+    }
+
+    typed(json_array) *array = parser_alloc(parser, typed(json_array));
+    array->count = count;
+    array->elements = elements;
+    retval.as_array = array;
+  }
+
+  // Pop the frame along with its items
+  parser->stack_size = offset;
+
+  return result_ok(json_element_value)(retval);
+}
+
+result(json_element_value) json_frame_unwind(typed(json_parser) * parser,
+                                             typed(size) depth) {
+  while (parser->depth > depth) {
+    typed(json_frame) *frame = parser_frame(parser);
+    typed(size) mark = parser_frame_items(parser);
+
+    // The items of a document go with its arena
+    if (parser->arena == NULL) {
+      free((void *)frame->key.data);
+
+      for (typed(size) i = 0; i < frame->count; i++) {
+        if (frame->bracket == '{') {
+          typed(json_parsed_entry) *parsed =
+              parser_stack_at(parser, typed(json_parsed_entry), mark) + i;
+          free((void *)parsed->entry.key);
+          json_free(&parsed->entry.element);
+        } else if (frame->elements != NULL) {
+          json_free(&frame->elements[i]);
+        } else {
+          json_free(parser_stack_at(parser, typed(json_element), mark) + i);
+        }
+      }
+
+      free(frame->elements);
+    }
+
+    parser->stack_size = parser->frame;
+    parser->frame = frame->parent;
+    parser->depth--;
+  }
+
+  return result_err(json_element_value)(JSON_ERROR_TOO_DEEP);
+}
+
+typed(json_object) *
+    json_object_build(typed(json_parser) * parser,
+                      typed(json_parsed_entry) * parsed, typed(size) count) {
+  typed(json_shape_table) *shapes = &parser->shapes;
+  typed(json_shape_table_slot) *shared = NULL;
+  typed(uint64) signature = 0;
+
+  if (shapes->slots != NULL) {
+    signature = json_shape_signature(parsed, count);
+    shared = json_shape_table_find(shapes, parsed, count, signature);
+  }
+
+  // The object and its values share a single allocation, along with
+  // its shape unless an earlier object made it, each part being a whole
+  // number of pointers long
+  bool new_shape = shared == NULL || shared->shape == NULL;
+  typed(size) capacity = new_shape ? json_shape_capacity(count) : 0;
+  typed(size) size =
+      sizeof(typed(json_object)) + count * sizeof(typed(json_element));
+  if (new_shape)
+    size += sizeof(typed(json_shape)) +
+            count * sizeof(typed(json_string_view)) +
+            capacity * sizeof(typed(json_shape_slot));
+
+  typed(json_object) *object =
+      (typed(json_object) *)json_parser_alloc(parser, size);
+  typed(json_element) *values = (typed(json_element) *)(object + 1);
+
+  for (size_t i = 0; i < count; i++)
+    values[i] = parsed[i].entry.element;
+
+  typed(json_shape) *shape;
+  if (new_shape) {
+    shape = (typed(json_shape) *)(values + count);
+    shape->keys = (typed(json_string_view) *)(shape + 1);
+    shape->capacity = capacity;
+    shape->slots = (typed(json_shape_slot) *)(shape->keys + count);
+    json_shape_index(shape, parsed, count);
+
+    if (shared != NULL) {
+      shared->hash = signature;
+      shared->shape = shape;
+
+      if (++shapes->count > shapes->capacity / 2)
+        json_shape_table_grow(shapes);
+    }
+  } else {
+    shape = shared->shape;
+  }
+
+  object->count = count;
+  object->shape = shape;
+  object->values = values;
+
+  return object;
+}
+
+void json_shape_index(typed(json_shape) * shape,
+                      typed(json_parsed_entry) * parsed, typed(size) count) {
+  // The closing '}' has been reached, so the index is sized once
+  typed(json_shape_slot) *slots = shape->slots;
+  typed(size) mask = shape->capacity - 1;
+
+  for (size_t i = 0; i < shape->capacity; i++)
+    slots[i].key_len = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    typed(json_entry) *entry = &parsed[i].entry;
+    typed(uint64) hash = parsed[i].hash;
+
+    shape->keys[i].data = entry->key;
+    shape->keys[i].len = entry->key_len;
+
+    // At most 3/4 of the slots are taken, so an empty one comes soon.
+    // Duplicate keys are found in the order of the input
+    typed(size) bucket = hash & mask;
+    while (slots[bucket].key_len != 0)
+      bucket = (bucket + 1) & mask;
+
+    slots[bucket].hash = (typed(uint32))(hash >> 32);
+    slots[bucket].key_len = json_slot_key_len(entry->key_len);
+    slots[bucket].index = i;
+  }
+
+  shape->count = count;
+}
+
+typed(uint64) json_shape_signature(typed(json_parsed_entry) * parsed,
+                                   typed(size) count) {
+  typed(uint64) signature = count;
+
+  // Multiplying after every key makes the signature depend on the order
+  for (size_t i = 0; i < count; i++) {
+    signature = (signature ^ parsed[i].hash) * 0x9E3779B97F4A7C15ULL;
+    signature ^= signature >> 29;
+  }
+
+  return signature;
+}
+
+typed(json_shape_table_slot) *
+    json_shape_table_find(typed(json_shape_table) * shapes,
+                          typed(json_parsed_entry) * parsed,
+                          typed(size) count, typed(uint64) hash) {
+  typed(size) mask = shapes->capacity - 1;
+
+  for (typed(size) bucket = hash & mask;; bucket = (bucket + 1) & mask) {
+    typed(json_shape_table_slot) *slot = &shapes->slots[bucket];
+    typed(json_shape) *shape = slot->shape;
+
+    if (shape == NULL)
+      return slot;
+    if (slot->hash != hash || shape->count != count)
+      continue;
+
+    // Keys are interned, so equal keys are the same pointer
+    typed(size) i = 0;
+    while (i < count && shape->keys[i].data == parsed[i].entry.key)
+      i++;
+    if (i == count)
+      return slot;
+  }
+}
+
+void json_shape_table_grow(typed(json_shape_table) * shapes) {
+  typed(json_shape_table_slot) *old_slots = shapes->slots;
+  typed(size) old_capacity = shapes->capacity;
+
+  shapes->capacity *= 2;
+  shapes->slots = allocN(typed(json_shape_table_slot), shapes->capacity);
+  for (typed(size) i = 0; i < shapes->capacity; i++)
+    shapes->slots[i].shape = NULL;
+
+  // Shapes are distinct, so each goes to the first empty slot of its
+  // chain
+  typed(size) mask = shapes->capacity - 1;
+  for (typed(size) i = 0; i < old_capacity; i++) {
+    if (old_slots[i].shape == NULL)
+      continue;
+
+    typed(size) bucket = old_slots[i].hash & mask;
+    while (shapes->slots[bucket].shape != NULL)
+      bucket = (bucket + 1) & mask;
+    shapes->slots[bucket] = old_slots[i];
+  }
+
+  free(old_slots);
+}
+
+typed(size) json_shape_capacity(typed(size) count) {
+  typed(size) capacity = 2;
+
+  // Lookups stop at an empty slot, so there is always at least one
+  while (capacity - capacity / 4 < count || capacity <= count)
+    capacity *= 2;
+
+  return capacity;
+}
+
+result(json_element_value) json_parse_boolean(typed(json_parser) * parser,
+                                              typed(json_string) * str_ptr) {
+  typed(size) len = json_boolean_len(parser, *str_ptr);
+  if (len == 0)
+    return result_err(json_element_value)(JSON_ERROR_INVALID_VALUE);
+
+  typed(json_boolean) output = **str_ptr == 't';
+  (*str_ptr) += len;
+
+  typed(json_element_value) retval = {0};
+  retval.as_boolean = output;
+
+  return result_ok(json_element_value)(retval);
+}
+
+result(json_element)
+    json_object_find(typed(json_object) * obj, typed(json_string) key) {
+  typed(size) len = key != NULL ? strlen(key) : 0;
+  if (len == 0)
+    return result_err(json_element)(JSON_ERROR_INVALID_KEY);
+
+  typed(json_shape_slot) *slot =
+      json_shape_lookup(obj->shape, key, len, json_key_hash(key, len));
+  if (slot == NULL)
+    return result_err(json_element)(JSON_ERROR_INVALID_KEY);
+
+  return result_ok(json_element)(obj->values[slot->index]);
+}
+
+result(json_element) json_object_find_key(typed(json_object) * obj,
+                                          const typed(json_key) * key) {
+  if (key->len == 0)
+    return result_err(json_element)(JSON_ERROR_INVALID_KEY);
+
+  typed(json_shape_slot) *slot =
+      json_shape_lookup(obj->shape, key->data, key->len, key->hash);
+  if (slot == NULL)
+    return result_err(json_element)(JSON_ERROR_INVALID_KEY);
+
+  return result_ok(json_element)(obj->values[slot->index]);
+}
+
+result(size)
+    json_shape_find(typed(json_shape) * shape, typed(json_string) key) {
+  typed(size) len = key != NULL ? strlen(key) : 0;
+  if (len == 0)
+    return result_err(size)(JSON_ERROR_INVALID_KEY);
+
+  typed(json_shape_slot) *slot =
+      json_shape_lookup(shape, key, len, json_key_hash(key, len));
+  if (slot == NULL)
+    return result_err(size)(JSON_ERROR_INVALID_KEY);
+
+  return result_ok(size)(slot->index);
+}
+
+result(size) json_shape_find_key(typed(json_shape) * shape,
+                                 const typed(json_key) * key) {
+  if (key->len == 0)
+    return result_err(size)(JSON_ERROR_INVALID_KEY);
+
+  typed(json_shape_slot) *slot =
+      json_shape_lookup(shape, key->data, key->len, key->hash);
+  if (slot == NULL)
+    return result_err(size)(JSON_ERROR_INVALID_KEY);
+
+  return result_ok(size)(slot->index);
+}
+
+typed(json_shape_slot) *
+    json_shape_lookup(typed(json_shape) * shape, typed(json_string) key,
+                      typed(size) len, typed(uint64) hash) {
+  typed(uint32) high = (typed(uint32))(hash >> 32);
+  typed(uint32) slot_key_len = json_slot_key_len(len);
+  typed(size) mask = shape->capacity - 1;
+
+  // The index always has an empty slot to stop at
+  for (typed(size) bucket = hash & mask;; bucket = (bucket + 1) & mask) {
+    typed(json_shape_slot) *slot = &shape->slots[bucket];
+    if (slot->key_len == 0)
+      return NULL;
+
+    typed(json_string_view) *found = &shape->keys[slot->index];
+    if (slot->hash == high && slot->key_len == slot_key_len &&
+        found->len == len &&
+        (found->data == key || memcmp(key, found->data, len) == 0))
+      return slot;
+  }
+}
+
+result(json_tape)
+    json_parse_tape(typed(json_string) json_str, typed(size) len,
+                    const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0)
+    return result_err(json_tape)(JSON_ERROR_EMPTY);
+
+  // A tape is always built straight from the input, with every string
+  // copied
+  typed(json_parse_options) tape_options = {0};
+  if (options != NULL) {
+    tape_options.skip_whitespace = options->skip_whitespace;
+    tape_options.max_depth = options->max_depth;
+  } else {
+    tape_options.skip_whitespace = JSON_DEFAULT_SKIP_WHITESPACE;
+  }
+
+  typed(json_tape_builder) builder;
+  json_parser_init(&builder.parser, json_str, len, &tape_options, NULL);
+
+  // Most inputs take a word for every few characters and hold strings in
+  // about half of them, so the tape seldom grows more than once or twice
+  builder.capacity = len / 8 + 4;
+  builder.strings_capacity = len / 2 + 8;
+  builder.tape.words = allocN(typed(uint64), builder.capacity);
+  builder.tape.count = 0;
+  builder.tape.strings = allocN(char, builder.strings_capacity);
+  builder.tape.strings_len = 0;
+
+  typed(json_string) str = json_str;
+  json_skip_whitespace(&builder.parser, &str);
+
+  result(json_element_type) type_result =
+      json_guess_element_type(&builder.parser, str);
+  result(json_boolean) root_result =
+      result_is_err(json_element_type)(&type_result)
+          ? result_map_err(json_boolean, json_element_type, &type_result)
+          : json_tape_element_value(
+                &builder, &str, result_unwrap(json_element_type)(&type_result));
+  json_parser_finish(&builder.parser);
+
+  if (result_is_err(json_boolean)(&root_result)) {
+    json_tape_free(&builder.tape);
+    return result_map_err(json_tape, json_boolean, &root_result);
+  }
+
+  // Give back the room the tape did not take
+  builder.tape.words =
+      reallocN(builder.tape.words, typed(uint64), builder.tape.count);
+  if (builder.tape.strings_len == 0) {
+    free(builder.tape.strings);
+    builder.tape.strings = NULL;
+  } else {
+    builder.tape.strings =
+        reallocN(builder.tape.strings, char, builder.tape.strings_len);
+  }
+
+  return result_ok(json_tape)(builder.tape);
+}
+
+result(json_boolean)
+    json_tape_container(typed(json_tape_builder) * builder,
+                        typed(json_string) * str_ptr) {
+  typed(json_parser) *parser = &builder->parser;
+  typed(size) depth = parser->depth;
+
+  // Every turn opens the container at the string pointer
+  for (;;) {
+    // The whole tape is thrown away, frames included
+    if (parser->depth >= parser->max_depth)
+      return result_err(json_boolean)(JSON_ERROR_TOO_DEEP);
+
+    result(json_boolean) value_result =
+        result_err(json_boolean)(JSON_ERROR_EMPTY);
+
+    if (json_tape_open(builder, str_ptr)) {
+      if (json_tape_items(builder, str_ptr, false))
+        continue;
+
+      value_result = json_tape_close(builder);
+    }
+
+    // Count each complete container in the one it is nested in, which
+    // goes on with its items until one more has to be opened
+    for (;;) {
+      if (parser->depth == depth)
+        return value_result;
+
+      json_tape_add(builder, value_result);
+
+      if (json_tape_items(builder, str_ptr, true))
+        break;
+
+      value_result = json_tape_close(builder);
+    }
+  }
+}
+
+bool json_tape_open(typed(json_tape_builder) * builder,
+                    typed(json_string) * str_ptr) {
+  typed(json_parser) *parser = &builder->parser;
+  char bracket = **str_ptr;
+
+  // Skip the opening bracket
+  (*str_ptr)++;
+
+  json_skip_whitespace(parser, str_ptr);
+
+  if (json_peek(parser, *str_ptr) == (bracket == '{' ? '}' : ']')) {
+    // Skip the closing bracket
+    (*str_ptr)++;
+    return false;
+  }
+
+  typed(size) offset = parser->stack_size;
+  typed(json_tape_frame) *frame =
+      parser_stack_push(parser, typed(json_tape_frame));
+
+  frame->parent = parser->frame;
+  frame->bracket = bracket;
+  frame->count = 0;
+  frame->open = builder->tape.count;
+
+  parser->frame = offset;
+  parser->depth++;
+
+  // Filled in once the end of the container is known
+  json_tape_push(builder, tape_word(bracket, 0));
+
+  return true;
+}
+
+bool json_tape_items(typed(json_tape_builder) * builder,
+                     typed(json_string) * str_ptr, bool resume) {
+  typed(json_parser) *parser = &builder->parser;
+  bool is_object = tape_frame(builder)->bracket == '{';
+  char close = is_object ? '}' : ']';
+
+  // A nested container is followed by whitespace like any other item
+  if (resume)
+    json_skip_whitespace(parser, str_ptr);
+
+  for (bool first = !resume;; first = false) {
+    if (!first) {
+      if (json_peek(parser, *str_ptr) == close)
+        break;
+
+      // Skip the ',' to move to the next item
+      json_skip_char(parser, str_ptr);
+    }
+
+    if (*str_ptr >= parser->end)
+      break;
+
+    // Skip any accidental whitespace
+    json_skip_whitespace(parser, str_ptr);
+
+    if (json_tape_item(builder, str_ptr, is_object))
+      return true;
+  }
+
+  // Skip the closing bracket
+  json_skip_char(parser, str_ptr);
+
+  return false;
+}
+
+bool json_tape_item(typed(json_tape_builder) * builder,
+                    typed(json_string) * str_ptr, bool is_object) {
+  typed(json_parser) *parser = &builder->parser;
+  typed(json_tape_frame) *frame = tape_frame(builder);
+
+  frame->item_words = builder->tape.count;
+  frame->item_strings = builder->tape.strings_len;
+
+  if (is_object) {
+    result(json_boolean) key_result =
+        json_tape_string(builder, str_ptr, JSON_TAPE_TAG_KEY);
+    if (result_is_err(json_boolean)(&key_result)) {
+      // Nothing is on the tape yet, but the value must not be read as the
+      // next key
+      json_skip_entry_value(parser, str_ptr);
+      json_skip_whitespace(parser, str_ptr);
+      return false;
+    }
+
+    json_skip_whitespace(parser, str_ptr);
+
+    // Skip the ':' delimiter
+    json_skip_char(parser, str_ptr);
+
+    json_skip_whitespace(parser, str_ptr);
+  }
+
+  result(json_element_type) type_result =
+      json_guess_element_type(parser, *str_ptr);
+  if (result_is_err(json_element_type)(&type_result)) {
+    if (is_object) {
+      // Drop the key written for the entry
+      json_tape_add(builder, result_map_err(json_boolean, json_element_type,
+                                            &type_result));
+      json_skip_whitespace(parser, str_ptr);
+    }
+    return false;
+  }
+  typed(json_element_type) type =
+      result_unwrap(json_element_type)(&type_result);
+
+  if (type == JSON_ELEMENT_TYPE_OBJECT || type == JSON_ELEMENT_TYPE_ARRAY)
+    return true;
+
+  json_tape_add(builder, json_tape_element_value(builder, str_ptr, type));
+  json_skip_whitespace(parser, str_ptr);
+
+  return false;
+}
+
+void json_tape_add(typed(json_tape_builder) * builder,
+                   result(json_boolean) value_result) {
+  typed(json_tape_frame) *frame = tape_frame(builder);
+
+  if (result_is_err(json_boolean)(&value_result)) {
+    // Cut the tape back to the start of the item, key included
+    builder->tape.count = frame->item_words;
+    builder->tape.strings_len = frame->item_strings;
+    return;
+  }
+
+  frame->count++;
+}
+
+result(json_boolean) json_tape_close(typed(json_tape_builder) * builder) {
+  typed(json_parser) *parser = &builder->parser;
+  typed(json_tape) *tape = &builder->tape;
+  typed(json_tape_frame) *frame = tape_frame(builder);
+  typed(size) open = frame->open;
+  typed(size) count = frame->count;
+  char bracket = frame->bracket;
+
+  // Pop the frame
+  parser->stack_size = parser->frame;
+  parser->frame = frame->parent;
+  parser->depth--;
+
+  if (count == 0) {
+    // Every item was cut back, leaving nothing but the opening word
+    tape->count = open;
+    return result_err(json_boolean)(JSON_ERROR_EMPTY);
+  }
+
+  json_tape_push(builder, tape_word(bracket == '{' ? '}' : ']', open));
+
+  typed(uint64) saturated =
+      count < JSON_TAPE_COUNT_MAX ? count : JSON_TAPE_COUNT_MAX;
+  tape->words[open] =
+      tape_word(bracket, (saturated << JSON_TAPE_END_BITS) | tape->count);
+
+  return result_ok(json_boolean)(true);
+}
+
+result(json_boolean)
+    json_tape_element_value(typed(json_tape_builder) * builder,
+                            typed(json_string) * str_ptr,
+                            typed(json_element_type) type) {
+  typed(json_parser) *parser = &builder->parser;
+
+  switch (type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    return json_tape_string(builder, str_ptr, JSON_TAPE_TAG_STRING);
+  case JSON_ELEMENT_TYPE_NUMBER: {
+    result_try(json_boolean, json_element_value, value,
+               json_parse_number(parser, str_ptr));
+
+    // The number takes the whole word after its tag
+    typed(json_number) number = value.as_number;
+    typed(uint64) bits;
+    if (number.type == JSON_NUMBER_TYPE_LONG) {
+      json_tape_push(builder, tape_word(JSON_TAPE_TAG_LONG, 0));
+      bits = (typed(uint64))number.value.as_long;
+    } else {
+      json_tape_push(builder, tape_word(JSON_TAPE_TAG_DOUBLE, 0));
+      memcpy(&bits, &number.value.as_double, sizeof(bits));
+    }
+    json_tape_push(builder, bits);
+
+    return result_ok(json_boolean)(true);
+  }
+  case JSON_ELEMENT_TYPE_OBJECT:
+  case JSON_ELEMENT_TYPE_ARRAY:
+    return json_tape_container(builder, str_ptr);
+  case JSON_ELEMENT_TYPE_BOOLEAN: {
+    result_try(json_boolean, json_element_value, value,
+               json_parse_boolean(parser, str_ptr));
+    json_tape_push(builder, tape_word(value.as_boolean ? JSON_TAPE_TAG_TRUE
+                                                       : JSON_TAPE_TAG_FALSE,
+                                      0));
+
+    return result_ok(json_boolean)(true);
+  }
+  case JSON_ELEMENT_TYPE_NULL:
+    json_skip_null(parser, str_ptr);
+    return result_err(json_boolean)(JSON_ERROR_EMPTY);
+  default:
+    return result_err(json_boolean)(JSON_ERROR_INVALID_TYPE);
+  }
+}
+
+result(json_boolean) json_tape_string(typed(json_tape_builder) * builder,
+                                      typed(json_string) * str_ptr,
+                                      typed(json_tape_tag) tag) {
+  typed(json_parser) *parser = &builder->parser;
+  typed(json_tape) *tape = &builder->tape;
+
+  // Skip the first '"' character
+  (*str_ptr)++;
+
+  bool escaped;
+  typed(size) len = json_string_len(parser, *str_ptr, &escaped);
+  if (len == 0) {
+    // Skip the end quote
+    json_skip_char(parser, str_ptr);
+    return result_err(json_boolean)(JSON_ERROR_EMPTY);
+  }
+
+  typed(json_string) str = *str_ptr;
+
+  // Skip to beyond the string, even if it turns out to be malformed
+  (*str_ptr) += len + 1;
+
+  // The length is kept in 4 bytes
+  if (len > UINT32_MAX)
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  // Unescaping never lengthens a string, so its length in the input
+  // along with the NUL always fits
+  typed(size) needed = tape->strings_len + sizeof(typed(uint32)) + len + 1;
+  if (needed > builder->strings_capacity) {
+    builder->strings_capacity *= 2;
+    if (builder->strings_capacity < needed)
+      builder->strings_capacity = needed;
+    tape->strings =
+        reallocN(tape->strings, char, builder->strings_capacity);
+  }
+
+  char *output = tape->strings + tape->strings_len + sizeof(typed(uint32));
+  typed(uint32) output_len = (typed(uint32))len;
+
+  // Most strings have no escapes at all and need no second scan
+  if (escaped) {
+    result_try(json_boolean, size, unescaped_len,
+               json_unescape_string(str, len, output));
+    output_len = (typed(uint32))unescaped_len;
+  } else {
+    memcpy(output, str, len);
+    output[len] = '\0';
+  }
+
+  memcpy(tape->strings + tape->strings_len, &output_len, sizeof(output_len));
+  json_tape_push(builder, tape_word(tag, tape->strings_len));
+  tape->strings_len += sizeof(output_len) + output_len + 1;
+
+  return result_ok(json_boolean)(true);
+}
+
+void json_tape_push(typed(json_tape_builder) * builder, typed(uint64) word) {
+  typed(json_tape) *tape = &builder->tape;
+
+  if (tape->count == builder->capacity) {
+    builder->capacity *= 2;
+    tape->words = reallocN(tape->words, typed(uint64), builder->capacity);
+  }
+
+  tape->words[tape->count++] = word;
+}
+
+typed(json_tape_value) json_tape_root(const typed(json_tape) * tape) {
+  const typed(json_tape_value) root = {tape, 0};
+  return root;
+}
+
+typed(json_element_type) json_tape_type(typed(json_tape_value) value) {
+  switch (tape_word_tag(value.tape->words[value.index])) {
+  case JSON_TAPE_TAG_OBJECT:
+    return JSON_ELEMENT_TYPE_OBJECT;
+  case JSON_TAPE_TAG_ARRAY:
+    return JSON_ELEMENT_TYPE_ARRAY;
+  case JSON_TAPE_TAG_KEY:
+  case JSON_TAPE_TAG_STRING:
+    return JSON_ELEMENT_TYPE_STRING;
+  case JSON_TAPE_TAG_LONG:
+  case JSON_TAPE_TAG_DOUBLE:
+    return JSON_ELEMENT_TYPE_NUMBER;
+  case JSON_TAPE_TAG_TRUE:
+  case JSON_TAPE_TAG_FALSE:
+    return JSON_ELEMENT_TYPE_BOOLEAN;
+  default:
+    return JSON_ELEMENT_TYPE_NULL;
+  }
+}
+
+typed(size) json_tape_count(typed(json_tape_value) value) {
+  typed(uint64) word = value.tape->words[value.index];
+  typed(json_tape_tag) tag = tape_word_tag(word);
+  if (tag != JSON_TAPE_TAG_OBJECT && tag != JSON_TAPE_TAG_ARRAY)
+    return 0;
+
+  typed(size) count = tape_word_payload(word) >> JSON_TAPE_END_BITS;
+  if (count < JSON_TAPE_COUNT_MAX)
+    return count;
+
+  // Too many to be held in the word, so they are counted one by one
+  count = 0;
+  for (typed(json_tape_value) item = json_tape_first(value);
+       !json_tape_is_end(item); item = json_tape_next(item))
+    count++;
+
+  return count;
+}
+
+result(json_tape_value)
+    json_tape_object_find(typed(json_tape_value) object,
+                          typed(json_string) key) {
+  typed(size) len = key != NULL ? strlen(key) : 0;
+  return json_tape_find(object, key, len);
+}
+
+result(json_tape_value)
+    json_tape_object_find_key(typed(json_tape_value) object,
+                              const typed(json_key) * key) {
+  return json_tape_find(object, key->data, key->len);
+}
+
+result(json_tape_value) json_tape_find(typed(json_tape_value) object,
+                                       typed(json_string) key,
+                                       typed(size) len) {
+  const typed(json_tape) *tape = object.tape;
+  if (tape_word_tag(tape->words[object.index]) != JSON_TAPE_TAG_OBJECT)
+    return result_err(json_tape_value)(JSON_ERROR_INVALID_TYPE);
+
+  if (len == 0)
+    return result_err(json_tape_value)(JSON_ERROR_INVALID_KEY);
+
+  // Each key is stored right after its length, which is compared first.
+  // Duplicate keys are found in the order of the input
+  for (typed(json_tape_value) entry = json_tape_first(object);
+       !json_tape_is_end(entry); entry = json_tape_next(entry)) {
+    typed(json_string) stored =
+        tape->strings + tape_word_payload(tape->words[entry.index]);
+    typed(uint32) stored_len;
+    memcpy(&stored_len, stored, sizeof(stored_len));
+
+    if (stored_len == len &&
+        memcmp(stored + sizeof(stored_len), key, len) == 0)
+      return result_ok(json_tape_value)(json_tape_key_value(entry));
+  }
+
+  return result_err(json_tape_value)(JSON_ERROR_INVALID_KEY);
+}
+
+result(json_tape_value) json_tape_array_get(typed(json_tape_value) array,
+                                            typed(size) index) {
+  if (tape_word_tag(array.tape->words[array.index]) != JSON_TAPE_TAG_ARRAY)
+    return result_err(json_tape_value)(JSON_ERROR_INVALID_TYPE);
+
+  typed(size) count =
+      tape_word_payload(array.tape->words[array.index]) >> JSON_TAPE_END_BITS;
+  if (count < JSON_TAPE_COUNT_MAX && index >= count)
+    return result_err(json_tape_value)(JSON_ERROR_INVALID_KEY);
+
+  // Nested containers are skipped in one step each
+  typed(json_tape_value) element = json_tape_first(array);
+  for (typed(size) i = 0; i < index && !json_tape_is_end(element); i++)
+    element = json_tape_next(element);
+
+  if (json_tape_is_end(element))
+    return result_err(json_tape_value)(JSON_ERROR_INVALID_KEY);
+
+  return result_ok(json_tape_value)(element);
+}
+
+typed(json_tape_value) json_tape_first(typed(json_tape_value) container) {
+  container.index++;
+  return container;
+}
+
+typed(json_tape_value) json_tape_next(typed(json_tape_value) item) {
+  // Move from a key to its value first
+  if (tape_word_tag(item.tape->words[item.index]) == JSON_TAPE_TAG_KEY)
+    item.index++;
+
+  item.index = json_tape_skip(item.tape, item.index);
+  return item;
+}
+
+typed(json_boolean) json_tape_is_end(typed(json_tape_value) item) {
+  typed(json_tape_tag) tag = tape_word_tag(item.tape->words[item.index]);
+  return tag == JSON_TAPE_TAG_OBJECT_END || tag == JSON_TAPE_TAG_ARRAY_END;
+}
+
+typed(json_tape_value) json_tape_key_value(typed(json_tape_value) key) {
+  key.index++;
+  return key;
+}
+
+typed(size) json_tape_skip(const typed(json_tape) * tape, typed(size) index) {
+  typed(uint64) word = tape->words[index];
+
+  switch (tape_word_tag(word)) {
+  case JSON_TAPE_TAG_OBJECT:
+  case JSON_TAPE_TAG_ARRAY:
+    return word & ((1ULL << JSON_TAPE_END_BITS) - 1);
+  case JSON_TAPE_TAG_LONG:
+  case JSON_TAPE_TAG_DOUBLE:
+    return index + 2;
+  default:
+    return index + 1;
+  }
+}
+
+result(json_string_view) json_tape_get_string(typed(json_tape_value) value) {
+  typed(uint64) word = value.tape->words[value.index];
+  typed(json_tape_tag) tag = tape_word_tag(word);
+  if (tag != JSON_TAPE_TAG_STRING && tag != JSON_TAPE_TAG_KEY)
+    return result_err(json_string_view)(JSON_ERROR_INVALID_TYPE);
+
+  typed(json_string) stored = value.tape->strings + tape_word_payload(word);
+  typed(uint32) len;
+  memcpy(&len, stored, sizeof(len));
+
+  typed(json_string_view) view = {stored + sizeof(len), len};
+
+  return result_ok(json_string_view)(view);
+}
+
+result(json_number) json_tape_get_number(typed(json_tape_value) value) {
+  typed(json_tape_tag) tag = tape_word_tag(value.tape->words[value.index]);
+  if (tag != JSON_TAPE_TAG_LONG && tag != JSON_TAPE_TAG_DOUBLE)
+    return result_err(json_number)(JSON_ERROR_INVALID_TYPE);
+
+  typed(uint64) bits = value.tape->words[value.index + 1];
+  typed(json_number) number;
+
+  if (tag == JSON_TAPE_TAG_LONG) {
+    number.type = JSON_NUMBER_TYPE_LONG;
+    number.value.as_long = (typed(json_number_long))bits;
+  } else {
+    number.type = JSON_NUMBER_TYPE_DOUBLE;
+    memcpy(&number.value.as_double, &bits, sizeof(bits));
+  }
+
+  return result_ok(json_number)(number);
+}
+
+result(json_boolean) json_tape_get_boolean(typed(json_tape_value) value) {
+  typed(json_tape_tag) tag = tape_word_tag(value.tape->words[value.index]);
+  if (tag != JSON_TAPE_TAG_TRUE && tag != JSON_TAPE_TAG_FALSE)
+    return result_err(json_boolean)(JSON_ERROR_INVALID_TYPE);
+
+  return result_ok(json_boolean)(tag == JSON_TAPE_TAG_TRUE);
+}
+
+result(json_boolean)
+    json_parse_events(typed(json_string) json_str, typed(size) len,
+                      const typed(json_callbacks) * callbacks, void *userdata) {
+  return json_parse_events_with_options(json_str, len, callbacks, userdata,
+                                        NULL);
+}
+
+result(json_boolean) json_parse_events_with_options(
+    typed(json_string) json_str, typed(size) len,
+    const typed(json_callbacks) * callbacks, void *userdata,
+    const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_boolean)(JSON_ERROR_EMPTY);
+  }
+
+  // Nothing is made, so neither an index nor a table of keys would help
+  typed(json_parse_options) event_options = {0};
+  if (options != NULL) {
+    event_options.skip_whitespace = options->skip_whitespace;
+    event_options.max_depth = options->max_depth;
+  } else {
+    event_options.skip_whitespace = JSON_DEFAULT_SKIP_WHITESPACE;
+  }
+
+  typed(json_parser) parser;
+  json_parser_init(&parser, json_str, len, &event_options, NULL);
+
+  result(json_boolean) events_result =
+      json_emit_element(&parser, &json_str, callbacks, userdata);
+  json_parser_finish(&parser);
+
+  return events_result;
+}
+
+result(json_boolean) json_emit_element(typed(json_parser) * parser,
+                                       typed(json_string) * str_ptr,
+                                       const typed(json_callbacks) * callbacks,
+                                       void *userdata) {
+  typed(size) depth = parser->depth;
+
+  // Every turn reports a value, opening the container if it is one
+  for (;;) {
+    typed(size) open = parser->depth;
+    result_try(json_boolean, json_boolean, go_on,
+               json_emit_value(parser, str_ptr, callbacks, userdata));
+    if (!go_on)
+      return result_ok(json_boolean)(false);
+
+    // A container that was just opened goes on with its first item
+    if (parser->depth > open)
+      continue;
+
+    // Close every container ending here, then go on with the next item
+    // of the innermost one left open
+    for (;;) {
+      if (parser->depth == depth)
+        return result_ok(json_boolean)(true);
+
+      json_skip_whitespace(parser, str_ptr);
+
+      // Each bracket takes an aligned slot like any item of the stack
+      typed(size) slot = json_arena_align(sizeof(char));
+      char bracket = *parser_stack_at(parser, char, parser->stack_size - slot);
+      char next = json_peek(parser, *str_ptr);
+      // '{' and '[' are two below their closing counterparts
+      if (next == bracket + 2) {
+        // Skip the closing bracket
+        (*str_ptr)++;
+        parser->stack_size -= slot;
+        parser->depth--;
+
+        bool closed = bracket == '{'
+                          ? json_emit(callbacks, on_object_end, userdata)
+                          : json_emit(callbacks, on_array_end, userdata);
+        if (!closed)
+          return result_ok(json_boolean)(false);
+
+        continue;
+      }
+
+      if (next != ',')
+        return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+      // Skip the ',' to move to the next item
+      (*str_ptr)++;
+
+      if (bracket == '{') {
+        result_try(json_boolean, json_boolean, key_go_on,
+                   json_emit_key(parser, str_ptr, callbacks, userdata));
+        if (!key_go_on)
+          return result_ok(json_boolean)(false);
+      }
+
+      break;
+    }
+  }
+}
+
+result(json_boolean) json_emit_value(typed(json_parser) * parser,
+                                     typed(json_string) * str_ptr,
+                                     const typed(json_callbacks) * callbacks,
+                                     void *userdata) {
+  json_skip_whitespace(parser, str_ptr);
+
+  char ch = json_peek(parser, *str_ptr);
+  switch (ch) {
+  case '{':
+  case '[': {
+    if (parser->depth >= parser->max_depth)
+      return result_err(json_boolean)(JSON_ERROR_TOO_DEEP);
+
+    // Skip the opening bracket
+    (*str_ptr)++;
+
+    bool opened = ch == '{' ? json_emit(callbacks, on_object_start, userdata)
+                            : json_emit(callbacks, on_array_start, userdata);
+    if (!opened)
+      return result_ok(json_boolean)(false);
+
+    json_skip_whitespace(parser, str_ptr);
+
+    if (json_peek(parser, *str_ptr) == ch + 2) {
+      // Skip the closing bracket
+      (*str_ptr)++;
+      return result_ok(json_boolean)(
+          ch == '{' ? json_emit(callbacks, on_object_end, userdata)
+                    : json_emit(callbacks, on_array_end, userdata));
+    }
+
+    *parser_stack_push(parser, char) = ch;
+    parser->depth++;
+
+    if (ch == '{')
+      return json_emit_key(parser, str_ptr, callbacks, userdata);
+
+    return result_ok(json_boolean)(true);
+  }
+  case '"':
+    return json_emit_string(parser, str_ptr, callbacks, userdata, false);
+  case 't':
+  case 'f': {
+    typed(size) len = json_boolean_len(parser, *str_ptr);
+    if (len == 0)
+      return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+    (*str_ptr) += len;
+    return result_ok(json_boolean)(
+        json_emit(callbacks, on_boolean, userdata, ch == 't'));
+  }
+  case 'n':
+    if (parser->end - *str_ptr < 4 || memcmp(*str_ptr, "null", 4) != 0)
+      return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+    (*str_ptr) += 4;
+    return result_ok(json_boolean)(json_emit(callbacks, on_null, userdata));
+
+  default:
+    break;
+  }
+
+  if (!json_is_number(ch))
+    return result_err(json_boolean)(JSON_ERROR_INVALID_TYPE);
+
+  result_try(json_boolean, json_element_value, value,
+             json_parse_number(parser, str_ptr));
+
+  return result_ok(json_boolean)(
+      json_emit(callbacks, on_number, userdata, value.as_number));
+}
+
+result(json_boolean) json_emit_key(typed(json_parser) * parser,
+                                   typed(json_string) * str_ptr,
+                                   const typed(json_callbacks) * callbacks,
+                                   void *userdata) {
+  json_skip_whitespace(parser, str_ptr);
+
+  if (json_peek(parser, *str_ptr) != '"')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_KEY);
+
+  result_try(json_boolean, json_boolean, go_on,
+             json_emit_string(parser, str_ptr, callbacks, userdata, true));
+  if (!go_on)
+    return result_ok(json_boolean)(false);
+
+  json_skip_whitespace(parser, str_ptr);
+
+  if (json_peek(parser, *str_ptr) != ':')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  // Skip the ':' delimiter
+  (*str_ptr)++;
+
+  return result_ok(json_boolean)(true);
+}
+
+result(json_boolean) json_emit_string(typed(json_parser) * parser,
+                                      typed(json_string) * str_ptr,
+                                      const typed(json_callbacks) * callbacks,
+                                      void *userdata, bool is_key) {
+  // Skip the starting '"' character
+  typed(json_string) str = *str_ptr + 1;
+
+  bool escaped;
+  typed(size) len = json_string_len(parser, str, &escaped);
+  if (len == 0 && json_peek(parser, str) != '"')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  // Skip the string along with its closing '"'
+  *str_ptr = str + len + 1;
+
+  return json_emit_string_chars(parser, str, len, escaped, callbacks,
+                                userdata, is_key);
+}
+
+result(json_boolean)
+    json_emit_string_chars(typed(json_parser) * parser, typed(json_string) str,
+                           typed(size) len, bool escaped,
+                           const typed(json_callbacks) * callbacks,
+                           void *userdata, bool is_key) {
+  typed(json_string_view) view = {str, len};
+  typed(size) mark = parser->stack_size;
+
+  if (escaped) {
+    char *unescaped = (char *)json_parser_stack_push(parser, len + 1);
+    result(size) len_result = json_unescape_string(str, len, unescaped);
+    if (result_is_err(size)(&len_result)) {
+      parser->stack_size = mark;
+      return result_map_err(json_boolean, size, &len_result);
+    }
+
+    view.data = unescaped;
+    view.len = result_unwrap(size)(&len_result);
+  }
+
+  bool go_on = is_key ? json_emit(callbacks, on_key, userdata, view)
+                      : json_emit(callbacks, on_string, userdata, view);
+  parser->stack_size = mark;
+
+  return result_ok(json_boolean)(go_on);
+}
+
+typed(json_push_parser) *
+    json_push_parser_new(const typed(json_callbacks) * callbacks,
+                         void *userdata,
+                         const typed(json_parse_options) * options) {
+  typed(json_push_parser) *push = alloc(typed(json_push_parser));
+
+  // As for events, nothing is made that an index or a key table helps
+  typed(json_parse_options) push_options = {0};
+  if (options != NULL) {
+    push_options.skip_whitespace = options->skip_whitespace;
+    push_options.max_depth = options->max_depth;
+  } else {
+    push_options.skip_whitespace = JSON_DEFAULT_SKIP_WHITESPACE;
+  }
+
+  json_parser_init(&push->parser, NULL, 0, &push_options, NULL);
+  push->callbacks = callbacks;
+  push->userdata = userdata;
+  push->state = JSON_PUSH_STATE_VALUE;
+  push->error = JSON_ERROR_EMPTY;
+  push->containers = NULL;
+  push->depth = 0;
+  push->containers_capacity = 0;
+  push->token = JSON_PUSH_TOKEN_NONE;
+  push->buffer = NULL;
+  push->buffer_len = 0;
+  push->buffer_capacity = 0;
+
+  return push;
+}
+
+result(json_boolean) json_push_feed(typed(json_push_parser) * push,
+                                    typed(json_string) chunk, typed(size) len) {
+  if (push->state == JSON_PUSH_STATE_FAILED)
+    return result_err(json_boolean)(push->error);
+  if (push->state == JSON_PUSH_STATE_STOPPED)
+    return result_ok(json_boolean)(false);
+  if (len == 0)
+    return result_ok(json_boolean)(true);
+
+  push->parser.end = chunk + len;
+
+  return json_push_settle(push, json_push_run(push, chunk));
+}
+
+result(json_boolean) json_push_finish(typed(json_push_parser) * push) {
+  if (push->state == JSON_PUSH_STATE_FAILED)
+    return result_err(json_boolean)(push->error);
+  if (push->state == JSON_PUSH_STATE_STOPPED)
+    return result_ok(json_boolean)(false);
+
+  // Only numbers and literals end with the input, a string needs its '"'
+  if (push->token == JSON_PUSH_TOKEN_NUMBER ||
+      push->token == JSON_PUSH_TOKEN_LITERAL) {
+    result(json_boolean) token_result =
+        json_push_settle(push, json_push_token_end(push, NULL, NULL));
+    if (result_is_err(json_boolean)(&token_result) ||
+        !result_unwrap(json_boolean)(&token_result))
+      return token_result;
+  }
+
+  if (push->state == JSON_PUSH_STATE_DONE)
+    return result_ok(json_boolean)(true);
+
+  // Nothing but whitespace was ever fed
+  bool empty = push->state == JSON_PUSH_STATE_VALUE && push->depth == 0 &&
+               push->token == JSON_PUSH_TOKEN_NONE;
+  return json_push_settle(
+      push, result_err(json_boolean)(empty ? JSON_ERROR_EMPTY
+                                           : JSON_ERROR_INVALID_VALUE));
+}
+
+void json_push_parser_free(typed(json_push_parser) * push) {
+  json_parser_finish(&push->parser);
+  free(push->containers);
+  free(push->buffer);
+  free(push);
+}
+
+result(json_boolean) json_push_settle(typed(json_push_parser) * push,
+                                      result(json_boolean) run_result) {
+  if (result_is_err(json_boolean)(&run_result)) {
+    push->state = JSON_PUSH_STATE_FAILED;
+    push->error = result_unwrap_err(json_boolean)(&run_result);
+  } else if (!result_unwrap(json_boolean)(&run_result)) {
+    push->state = JSON_PUSH_STATE_STOPPED;
+  }
+
+  return run_result;
+}
+
+result(json_boolean) json_push_run(typed(json_push_parser) * push,
+                                   typed(json_string) str) {
+  typed(json_parser) *parser = &push->parser;
+  const typed(json_callbacks) *callbacks = push->callbacks;
+  void *userdata = push->userdata;
+
+  // The token split by the end of the previous chunk goes on here
+  if (push->token != JSON_PUSH_TOKEN_NONE) {
+    result_try(json_boolean, json_boolean, go_on, json_push_token(push, &str));
+    if (!go_on)
+      return result_ok(json_boolean)(false);
+  }
+
+  while (push->state != JSON_PUSH_STATE_DONE) {
+    json_skip_whitespace(parser, &str);
+    if (str == parser->end)
+      break;
+
+    char ch = *str;
+    bool go_on = true;
+
+    switch (push->state) {
+    case JSON_PUSH_STATE_VALUE_OR_END:
+      if (ch == ']') {
+        // Skip the ']' closing the empty array
+        str++;
+        go_on = json_push_close(push);
+        break;
+      }
+      push->state = JSON_PUSH_STATE_VALUE;
+      continue;
+
+    case JSON_PUSH_STATE_VALUE:
+      if (ch == '{' || ch == '[') {
+        if (push->depth >= parser->max_depth)
+          return result_err(json_boolean)(JSON_ERROR_TOO_DEEP);
+
+        // Skip the opening bracket
+        str++;
+        json_push_open(push, ch);
+        go_on = ch == '{' ? json_emit(callbacks, on_object_start, userdata)
+                          : json_emit(callbacks, on_array_start, userdata);
+        break;
+      }
+
+      if (ch == '"') {
+        // Skip the starting '"' character
+        str++;
+        push->token = JSON_PUSH_TOKEN_STRING;
+        push->is_key = false;
+      } else if (json_is_number(ch)) {
+        push->token = JSON_PUSH_TOKEN_NUMBER;
+      } else if (json_is_boolean(ch) || json_is_null(ch)) {
+        push->token = JSON_PUSH_TOKEN_LITERAL;
+      } else {
+        return result_err(json_boolean)(JSON_ERROR_INVALID_TYPE);
+      }
+      break;
+
+    case JSON_PUSH_STATE_KEY_OR_END:
+      if (ch == '}') {
+        // Skip the '}' closing the empty object
+        str++;
+        go_on = json_push_close(push);
+        break;
+      }
+      push->state = JSON_PUSH_STATE_KEY;
+      continue;
+
+    case JSON_PUSH_STATE_KEY:
+      if (ch != '"')
+        return result_err(json_boolean)(JSON_ERROR_INVALID_KEY);
+
+      // Skip the starting '"' character
+      str++;
+      push->token = JSON_PUSH_TOKEN_STRING;
+      push->is_key = true;
+      break;
+
+    case JSON_PUSH_STATE_COLON:
+      if (ch != ':')
+        return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+      // Skip the ':' delimiter
+      str++;
+      push->state = JSON_PUSH_STATE_VALUE;
+      break;
+
+    case JSON_PUSH_STATE_COMMA_OR_END: {
+      char container = push->containers[push->depth - 1];
+      char close = container == '{' ? '}' : ']';
+
+      if (ch == close) {
+        // Skip the closing bracket
+        str++;
+        go_on = json_push_close(push);
+      } else if (ch == ',') {
+        // Skip the ',' to move to the next item
+        str++;
+        push->state = container == '{' ? JSON_PUSH_STATE_KEY
+                                       : JSON_PUSH_STATE_VALUE;
+      } else {
+        return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+      }
+      break;
+    }
+
+    default:
+      break;
+    }
+
+    if (push->token != JSON_PUSH_TOKEN_NONE) {
+      push->escaped = false;
+      push->escape_pending = false;
+      result_try(json_boolean, json_boolean, token_go_on,
+                 json_push_token(push, &str));
+      go_on = token_go_on;
+    }
+
+    if (!go_on)
+      return result_ok(json_boolean)(false);
+  }
+
+  return result_ok(json_boolean)(true);
+}
+
+result(json_boolean) json_push_token(typed(json_push_parser) * push,
+                                     typed(json_string) * str_ptr) {
+  typed(json_string) start = *str_ptr;
+  typed(json_string) end = push->parser.end;
+  typed(json_string) token_end;
+
+  switch (push->token) {
+  case JSON_PUSH_TOKEN_STRING:
+    token_end = json_push_scan_string(push, start, end);
+    break;
+  case JSON_PUSH_TOKEN_NUMBER:
+    token_end = start;
+    while (token_end < end && json_push_is_number_char(*token_end))
+      token_end++;
+    break;
+  default:
+    token_end = start;
+    while (token_end < end && *token_end >= 'a' && *token_end <= 'z')
+      token_end++;
+    break;
+  }
+
+  if (token_end == end) {
+    // The token goes on in the next chunk, which this one may not outlive
+    json_push_buffer(push, start, end - start);
+    *str_ptr = end;
+    return result_ok(json_boolean)(true);
+  }
+
+  // Skip the token, along with the closing '"' of a string
+  *str_ptr = token_end + (push->token == JSON_PUSH_TOKEN_STRING);
+
+  return json_push_token_end(push, start, token_end);
+}
+
+result(json_boolean) json_push_token_end(typed(json_push_parser) * push,
+                                         typed(json_string) start,
+                                         typed(json_string) end) {
+  typed(json_parser) *parser = &push->parser;
+  const typed(json_callbacks) *callbacks = push->callbacks;
+  void *userdata = push->userdata;
+
+  // A token met whole is read from the chunk, any other from the buffer
+  typed(json_string) str = start;
+  typed(size) len = end - start;
+  if (push->buffer_len != 0) {
+    json_push_buffer(push, start, len);
+    str = push->buffer;
+    len = push->buffer_len;
+  }
+
+  typed(json_push_token) token = push->token;
+  push->token = JSON_PUSH_TOKEN_NONE;
+  push->buffer_len = 0;
+
+  if (token == JSON_PUSH_TOKEN_STRING) {
+    bool is_key = push->is_key;
+    push->state = is_key ? JSON_PUSH_STATE_COLON : json_push_next_state(push);
+
+    return json_emit_string_chars(parser, str, len, push->escaped, callbacks,
+                                  userdata, is_key);
+  }
+
+  push->state = json_push_next_state(push);
+
+  if (token == JSON_PUSH_TOKEN_LITERAL) {
+    if (len == 4 && memcmp(str, "null", 4) == 0)
+      return result_ok(json_boolean)(json_emit(callbacks, on_null, userdata));
+
+    bool is_true = len == 4 && memcmp(str, "true", 4) == 0;
+    if (!is_true && (len != 5 || memcmp(str, "false", 5) != 0))
+      return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+    return result_ok(json_boolean)(
+        json_emit(callbacks, on_boolean, userdata, is_true));
+  }
+
+  // The number has to span the whole token
+  typed(json_string) chunk_end = parser->end;
+  typed(json_string) number_end = str;
+  parser->end = str + len;
+  result(json_element_value) number_result =
+      json_parse_number(parser, &number_end);
+  parser->end = chunk_end;
+
+  if (result_is_err(json_element_value)(&number_result))
+    return result_map_err(json_boolean, json_element_value, &number_result);
+  if (number_end != str + len)
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  typed(json_number) number =
+      result_unwrap(json_element_value)(&number_result).as_number;
+  return result_ok(json_boolean)(
+      json_emit(callbacks, on_number, userdata, number));
+}
+
+typed(json_string) json_push_scan_string(typed(json_push_parser) * push,
+                                         typed(json_string) str,
+                                         typed(json_string) end) {
+  // The previous chunk ended right after a '\\'
+  if (push->escape_pending && str < end) {
+    push->escape_pending = false;
+    str++;
+  }
+
+  while (str < end) {
+    // Jump over everything that is neither a '"' nor a '\\'
+    str = json_scan_string(str, end);
+    if (str == end || *str == '"')
+      return str;
+
+    push->escaped = true;
+    if (end - str < 2) {
+      push->escape_pending = true;
+      return end;
+    }
+
+    // Skip the escaped character, which may well be another '\\' or '"'
+    str += 2;
+  }
+
+  return end;
+}
+
+bool json_push_is_number_char(char ch) {
+  return is_digit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' ||
+         ch == 'E';
+}
+
+void json_push_buffer(typed(json_push_parser) * push, typed(json_string) str,
+                      typed(size) len) {
+  if (push->buffer_capacity - push->buffer_len < len) {
+    typed(size) capacity = push->buffer_capacity == 0
+                               ? JSON_PUSH_BUFFER_INITIAL_CAPACITY
+                               : push->buffer_capacity * 2;
+    while (capacity - push->buffer_len < len)
+      capacity *= 2;
+
+    push->buffer = reallocN(push->buffer, char, capacity);
+    push->buffer_capacity = capacity;
+  }
+
+  if (len != 0)
+    memcpy(push->buffer + push->buffer_len, str, len);
+  push->buffer_len += len;
+}
+
+void json_push_open(typed(json_push_parser) * push, char container) {
+  if (push->depth == push->containers_capacity) {
+    push->containers_capacity = push->containers_capacity == 0
+                                    ? JSON_PUSH_CONTAINERS_INITIAL_CAPACITY
+                                    : push->containers_capacity * 2;
+    push->containers =
+        reallocN(push->containers, char, push->containers_capacity);
+  }
+
+  push->containers[push->depth++] = container;
+  push->state = container == '{' ? JSON_PUSH_STATE_KEY_OR_END
+                                 : JSON_PUSH_STATE_VALUE_OR_END;
+}
+
+bool json_push_close(typed(json_push_parser) * push) {
+  char container = push->containers[--push->depth];
+  push->state = json_push_next_state(push);
+
+  return container == '{'
+             ? json_emit(push->callbacks, on_object_end, push->userdata)
+             : json_emit(push->callbacks, on_array_end, push->userdata);
+}
+
+typed(json_push_state) json_push_next_state(typed(json_push_parser) * push) {
+  return push->depth == 0 ? JSON_PUSH_STATE_DONE
+                          : JSON_PUSH_STATE_COMMA_OR_END;
+}
+
+result(json_lines)
+    json_parse_lines(typed(json_string) json_str, typed(size) len,
+                     typed(size) threads,
+                     const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_lines)(JSON_ERROR_EMPTY);
+  }
+
+  typed(json_lines_job) job;
+  job.count = json_lines_split(json_str, len, &job.spans);
+  job.results = allocN(result(json_element), job.count);
+  job.options = options;
+  job.next = 0;
+
+  // More workers than batches would only sit idle
+  typed(size) batch_count = job.count / JSON_LINES_BATCH_SIZE + 1;
+  typed(size) worker_count = threads != 0 ? threads : json_processor_count();
+#ifdef JSON_NO_THREADS
+  worker_count = 1;
+#endif
+  if (worker_count > batch_count)
+    worker_count = batch_count;
+
+  typed(json_lines_worker) *workers =
+      allocN(typed(json_lines_worker), worker_count);
+  for (typed(size) i = 0; i < worker_count; i++) {
+    workers[i].job = &job;
+    workers[i].arena = json_arena_new(len / worker_count);
+  }
+
+#ifndef JSON_NO_THREADS
+  pthread_mutex_init(&job.lock, NULL);
+#endif
+  json_run_workers(json_lines_work, workers, sizeof(typed(json_lines_worker)),
+                   worker_count);
+#ifndef JSON_NO_THREADS
+  pthread_mutex_destroy(&job.lock);
+#endif
+
+  typed(json_lines) lines = {
+      .count = job.count,
+      .lines = job.results,
+      .arenas = allocN(typed(json_arena) *, worker_count),
+      .arena_count = worker_count,
+  };
+  for (typed(size) i = 0; i < worker_count; i++)
+    lines.arenas[i] = workers[i].arena;
+
+  free(workers);
+  free(job.spans);
+
+  return result_ok(json_lines)(lines);
+}
+
+void json_lines_free(typed(json_lines) * lines) {
+  for (typed(size) i = 0; i < lines->arena_count; i++)
+    json_arena_free(lines->arenas[i]);
+
+  free(lines->arenas);
+  free(lines->lines);
+  lines->count = 0;
+  lines->lines = NULL;
+  lines->arenas = NULL;
+  lines->arena_count = 0;
+}
+
+result(json_document)
+    json_parse_document_parallel(typed(json_string) json_str, typed(size) len,
+                                 typed(size) threads,
+                                 const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_document)(JSON_ERROR_EMPTY);
+  }
+
+  typed(size) slice_count = threads != 0 ? threads : json_processor_count();
+#ifdef JSON_NO_THREADS
+  slice_count = 1;
+#endif
+  if (slice_count > len / JSON_PARALLEL_MIN_SLICE_SIZE)
+    slice_count = len / JSON_PARALLEL_MIN_SLICE_SIZE;
+
+  bool skip_whitespace = options != NULL ? options->skip_whitespace
+                                         : JSON_DEFAULT_SKIP_WHITESPACE;
+  typed(json_string) str = json_str;
+  typed(json_string) end = json_str + len;
+  while (skip_whitespace && str < end && is_whitespace(*str))
+    str++;
+
+  if (slice_count < 2 || str == end || *str != '[')
+    return json_parse_document_with_options(json_str, len, options);
+
+  // Skip the starting '[' character
+  str++;
+
+  typed(json_string) *bounds = allocN(typed(json_string), slice_count + 1);
+  slice_count = json_array_split(str, end, slice_count, bounds);
+  if (slice_count == 0) {
+    // Let the sequential parse tell what is wrong with the array
+    free(bounds);
+    return json_parse_document_with_options(json_str, len, options);
+  }
+
+  // Only the whole input could be indexed
+  typed(json_parse_options) slice_options = {0};
+  if (options != NULL)
+    slice_options = *options;
+  slice_options.skip_whitespace = skip_whitespace;
+  slice_options.structural_index = false;
+
+  typed(json_array_slice) *slices =
+      allocN(typed(json_array_slice), slice_count);
+  for (typed(size) i = 0; i < slice_count; i++) {
+    typed(size) slice_len = bounds[i + 1] - bounds[i];
+    json_parser_init(&slices[i].parser, bounds[i], slice_len, &slice_options,
+                     json_arena_new(slice_len));
+    // The elements are nested in the root array
+    slices[i].parser.depth = 1;
+    slices[i].begin = bounds[i];
+    slices[i].count = 0;
+    slices[i].too_deep = false;
+  }
+  free(bounds);
+
+  json_run_workers(json_array_slice_work, slices,
+                   sizeof(typed(json_array_slice)), slice_count);
+
+  typed(size) count = 0;
+  bool too_deep = false;
+  for (typed(size) i = 0; i < slice_count; i++) {
+    count += slices[i].count;
+    too_deep |= slices[i].too_deep;
+  }
+
+  // The array and its elements are the only allocations of their own,
+  // the values live in the arenas of the ranges
+  typed(json_arena) *arena = json_arena_new(
+      sizeof(typed(json_array)) + count * sizeof(typed(json_element)));
+  typed(json_element) *elements = (typed(json_element) *)json_arena_alloc(
+      arena, count * sizeof(typed(json_element)));
+
+  typed(size) offset = 0;
+  for (typed(size) i = 0; i < slice_count; i++) {
+    typed(json_parser) *parser = &slices[i].parser;
+    if (slices[i].count != 0)
+      memcpy(elements + offset, parser_stack_at(parser, typed(json_element), 0),
+             slices[i].count * sizeof(typed(json_element)));
+    offset += slices[i].count;
+
+    json_arena_adopt(arena, parser->arena);
+    json_parser_finish(parser);
+  }
+  free(slices);
+
+  if (too_deep || count == 0) {
+    json_arena_free(arena);
+    return result_err(json_document)(too_deep ? JSON_ERROR_TOO_DEEP
+                                              : JSON_ERROR_EMPTY);
+  }
+
+  typed(json_array) *array =
+      (typed(json_array) *)json_arena_alloc(arena, sizeof(typed(json_array)));
+  array->count = count;
+  array->elements = elements;
+
+  typed(json_document) document = {
+      .root =
+          {
+              .type = JSON_ELEMENT_TYPE_ARRAY,
+              .value = {.as_array = array},
+          },
+      .arena = arena,
+  };
+
+  return result_ok(json_document)(document);
+}
+
+typed(size) json_array_split(typed(json_string) str, typed(json_string) end,
+                             typed(size) slice_count,
+                             typed(json_string) * bounds) {
+  typed(size) len = end - str;
+  typed(size) found = 1;
+  typed(size) depth = 1;
+  typed(uint64) escape_carry = 0;
+  typed(uint64) in_string = 0;
+
+  bounds[0] = str;
+
+  for (typed(size) offset = 0; offset < len; offset += 64) {
+    typed(json_block_masks) masks;
+
+    if (len - offset >= 64) {
+      json_classify_block(str + offset, &masks);
+    } else {
+      // Pad the last block with spaces, which are never structural
+      char block[64];
+      memset(block, ' ', sizeof(block));
+      memcpy(block, str + offset, len - offset);
+      json_classify_block(block, &masks);
+    }
+
+    typed(uint64) quote =
+        masks.quote & ~json_block_escaped(masks.backslash, &escape_carry);
+    typed(uint64) inside = json_prefix_xor(quote) ^ in_string;
+    typed(uint64) structural = masks.operators & ~inside;
+    in_string = (typed(uint64))((int64_t)inside >> 63);
+
+    while (structural != 0) {
+      int bit = json_ctz64(structural);
+      structural &= structural - 1;
+
+      typed(json_string) position = str + offset + bit;
+      switch (*position) {
+      case '{':
+      case '[':
+        depth++;
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0) {
+          bounds[found] = position;
+          return found;
+        }
+        break;
+      case ',':
+        // Split at the first ',' of the root array beyond the share of
+        // every range so far
+        if (depth == 1 && found < slice_count &&
+            (typed(size))(position - str) >= found * len / slice_count) {
+          bounds[found] = position + 1;
+          found++;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  return 0;
+}
+
+void *json_array_slice_work(void *slice_ptr) {
+  typed(json_array_slice) *slice = (typed(json_array_slice) *)slice_ptr;
+  typed(json_parser) *parser = &slice->parser;
+  typed(json_string) str = slice->begin;
+
+  while (str < parser->end) {
+    json_skip_whitespace(parser, &str);
+
+    result(json_element_type) type_result =
+        json_guess_element_type(parser, str);
+    if (result_is_ok(json_element_type)(&type_result)) {
+      typed(json_element_type) type =
+          result_unwrap(json_element_type)(&type_result);
+
+      result(json_element_value) value_result =
+          json_parse_element_value(parser, &str, type);
+      if (result_is_ok(json_element_value)(&value_result)) {
+        typed(json_element) *element =
+            parser_stack_push(parser, typed(json_element));
+        element->type = type;
+        element->value = result_unwrap(json_element_value)(&value_result);
+        slice->count++;
+      } else if (result_unwrap_err(json_element_value)(&value_result) ==
+                 JSON_ERROR_TOO_DEEP) {
+        slice->too_deep = true;
+        return NULL;
+      }
+
+      json_skip_whitespace(parser, &str);
+    }
+
+    // Skip the ','
+    json_skip_char(parser, &str);
+  }
+
+  return NULL;
+}
+
+void json_run_workers(void *(*work)(void *), void *workers, typed(size) size,
+                      typed(size) count) {
+#ifndef JSON_NO_THREADS
+  // Resolved up front, the kernels are only ever read by the workers
+  json_kernels_resolve();
+
+  pthread_t *handles = allocN(pthread_t, count);
+  bool *started = allocN(bool, count);
+  for (typed(size) i = 1; i < count; i++)
+    started[i] = pthread_create(&handles[i], NULL, work,
+                                (char *)workers + i * size) == 0;
+
+  work(workers);
+
+  for (typed(size) i = 1; i < count; i++) {
+    if (started[i])
+      pthread_join(handles[i], NULL);
+    else
+      work((char *)workers + i * size);
+  }
+
+  free(started);
+  free(handles);
+#else
+  for (typed(size) i = 0; i < count; i++)
+    work((char *)workers + i * size);
+#endif
+}
+
+typed(size) json_lines_split(typed(json_string) json_str, typed(size) len,
+                             typed(json_string_view) * *spans_ptr) {
+  typed(json_string) iter = json_str;
+  typed(json_string) end = json_str + len;
+  typed(size) count = 0;
+  typed(size) capacity = JSON_LINES_BATCH_SIZE;
+  typed(json_string_view) *spans = allocN(typed(json_string_view), capacity);
+
+  // A final line break does not start another line
+  while (iter < end) {
+    typed(json_string) line_end =
+        (typed(json_string))memchr(iter, '\n', end - iter);
+    typed(json_string) next = line_end != NULL ? line_end + 1 : end;
+    if (line_end == NULL)
+      line_end = end;
+    if (line_end > iter && line_end[-1] == '\r')
+      line_end--;
+
+    if (count == capacity) {
+      capacity *= 2;
+      spans = reallocN(spans, typed(json_string_view), capacity);
+    }
+
+    spans[count].data = iter;
+    spans[count].len = line_end - iter;
+    count++;
+    iter = next;
+  }
+
+  *spans_ptr = spans;
+  return count;
+}
+
+void *json_lines_work(void *worker_ptr) {
+  typed(json_lines_worker) *worker = (typed(json_lines_worker) *)worker_ptr;
+  typed(json_lines_job) *job = worker->job;
+  typed(size) begin;
+  typed(size) end;
+
+  while (json_lines_claim(job, &begin, &end)) {
+    for (typed(size) i = begin; i < end; i++) {
+      typed(json_string_view) span = job->spans[i];
+      if (span.len == 0) {
+        job->results[i] = result_err(json_element)(JSON_ERROR_EMPTY);
+        continue;
+      }
+
+      // Every line of this worker shares its arena, so a failed line
+      // leaves behind whatever it allocated until the lines are freed
+      typed(json_parser) parser;
+      json_parser_init(&parser, span.data, span.len, job->options,
+                       worker->arena);
+      job->results[i] = json_parse_root(&parser, span.data);
+      json_parser_finish(&parser);
+    }
+  }
+
+  return NULL;
+}
+
+bool json_lines_claim(typed(json_lines_job) * job, typed(size) * begin,
+                      typed(size) * end) {
+#ifndef JSON_NO_THREADS
+  pthread_mutex_lock(&job->lock);
+#endif
+  *begin = job->next;
+  *end = job->count - *begin < JSON_LINES_BATCH_SIZE
+             ? job->count
+             : *begin + JSON_LINES_BATCH_SIZE;
+  job->next = *end;
+#ifndef JSON_NO_THREADS
+  pthread_mutex_unlock(&job->lock);
+#endif
+
+  return *begin < *end;
+}
+
+typed(size) json_processor_count(void) {
+#if !defined(JSON_NO_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  if (count > 0)
+    return (typed(size))count;
+#endif
+
+  return 1;
+}
+
+result(json_path) json_path_compile(typed(json_string) pointer) {
+  if (pointer == NULL)
+    return result_err(json_path)(JSON_ERROR_EMPTY);
+
+  typed(size) len = strlen(pointer);
+  if (len > 0 && pointer[0] != '/')
+    return result_err(json_path)(JSON_ERROR_INVALID_KEY);
+
+  typed(size) count = 0;
+  for (typed(size) i = 0; i < len; i++)
+    count += pointer[i] == '/';
+
+  // The segments and their tokens share a single allocation. Unescaping
+  // never lengthens a token, so each fits in its characters along with
+  // the '/' before it turned into a NUL
+  typed(json_path_segment) *segments = (typed(json_path_segment) *)malloc(
+      count * sizeof(typed(json_path_segment)) + len + 1);
+  char *output = (char *)(segments + count);
+  typed(json_string) iter = pointer;
+  typed(json_string) end = pointer + len;
+
+  for (typed(size) i = 0; i < count; i++) {
+    typed(json_path_segment) *segment = &segments[i];
+    segment->key = output;
+    segment->index = 0;
+
+    // Skip the '/' starting the token
+    iter++;
+
+    bool is_index = iter < end && *iter != '/' && (*iter != '0' ||
+                                                   iter + 1 == end ||
+                                                   iter[1] == '/');
+    for (; iter < end && *iter != '/'; iter++) {
+      char ch = *iter;
+
+      if (ch == '~') {
+        // Only "~0" and "~1" are escapes
+        char next = iter + 1 < end ? iter[1] : '\0';
+        if (next != '0' && next != '1') {
+          free(segments);
+          return result_err(json_path)(JSON_ERROR_INVALID_KEY);
+        }
+
+        ch = next == '0' ? '~' : '/';
+        iter++;
+      }
+
+      if (!is_digit(ch) || segment->index > (SIZE_MAX - 9) / 10)
+        is_index = false;
+      else
+        segment->index = segment->index * 10 + (typed(size))(ch - '0');
+
+      *output++ = ch;
+    }
+
+    segment->key_len = output - segment->key;
+    *output++ = '\0';
+    if (!is_index)
+      segment->index = SIZE_MAX;
+  }
+
+  const typed(json_path) path = {
+      .count = count,
+      .segments = segments,
+  };
+
+  return result_ok(json_path)(path);
+}
+
+result(json_element)
+    json_path_find(const typed(json_path) * path, typed(json_string) json_str,
+                   typed(size) len, const typed(json_parse_options) * options) {
+  if (json_str == NULL || len == 0) {
+    return result_err(json_element)(JSON_ERROR_EMPTY);
+  }
+
+  // The path is followed through the input itself, which an index would
+  // only be built for in vain
+  typed(json_parse_options) path_options = {0};
+  if (options != NULL) {
+    path_options.skip_whitespace = options->skip_whitespace;
+    path_options.max_depth = options->max_depth;
+  } else {
+    path_options.skip_whitespace = JSON_DEFAULT_SKIP_WHITESPACE;
+  }
+
+  typed(json_parser) parser;
+  json_parser_init(&parser, json_str, len, &path_options, NULL);
+
+  result(json_element) element_result;
+  typed(json_string) iter = json_str;
+  typed(size) i = 0;
+
+  for (; i < path->count; i++) {
+    result(json_string) step_result =
+        json_path_step(&parser, iter, &path->segments[i]);
+    if (result_is_err(json_string)(&step_result)) {
+      element_result = result_map_err(json_element, json_string, &step_result);
+      break;
+    }
+
+    iter = result_unwrap(json_string)(&step_result);
+  }
+
+  // Only the element found is parsed, as deep as the path is long
+  if (i == path->count) {
+    parser.depth = path->count;
+    element_result = json_parse_root(&parser, iter);
+  }
+  json_parser_finish(&parser);
+
+  return element_result;
+}
+
+void json_path_free(typed(json_path) * path) {
+  free(path->segments);
+  path->segments = NULL;
+  path->count = 0;
+}
+
+result(json_string) json_path_step(typed(json_parser) * parser,
+                                   typed(json_string) str,
+                                   const typed(json_path_segment) * segment) {
+  json_skip_whitespace(parser, &str);
+
+  switch (json_peek(parser, str)) {
+  case '{':
+    return json_path_step_object(parser, str, segment);
+  case '[':
+    return json_path_step_array(parser, str, segment);
+
+  default:
+    // Scalars have nothing inside to refer to
+    return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+  }
+}
+
+result(json_string)
+    json_path_step_object(typed(json_parser) * parser, typed(json_string) str,
+                          const typed(json_path_segment) * segment) {
+  // Skip the starting '{' character
+  str++;
+
+  json_skip_whitespace(parser, &str);
+
+  if (json_peek(parser, str) == '}')
+    return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+
+  while (str < parser->end) {
+    json_skip_whitespace(parser, &str);
+
+    if (json_peek(parser, str) != '"')
+      return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+
+    // Skip the starting '"' character
+    str++;
+
+    bool escaped;
+    typed(size) len = json_string_len(parser, str, &escaped);
+    if (len == 0 && json_peek(parser, str) != '"')
+      return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+
+    bool found = json_path_key_equals(parser, str, len, escaped, segment);
+
+    // Skip the key along with its closing '"'
+    str += len + 1;
+
+    json_skip_whitespace(parser, &str);
+
+    if (json_peek(parser, str) != ':')
+      return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+
+    // Skip the ':' delimiter
+    str++;
+
+    json_skip_whitespace(parser, &str);
+
+    typed(json_string) value = str;
+    result_try(json_string, json_element_type, type,
+               json_guess_element_type(parser, str));
+
+    // Entries of null and empty values are left out of objects, so the
+    // first of duplicate keys with a value is found, as it would be by
+    // `json_object_find`
+    if (found && json_path_holds_value(parser, value, type))
+      return result_ok(json_string)(value);
+    json_skip_element_value(parser, &str, type);
+
+    json_skip_whitespace(parser, &str);
+
+    char next = json_peek(parser, str);
+    if (next == '}')
+      return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+    if (next != ',')
+      return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+
+    // Skip the ',' to move to the next entry
+    str++;
+  }
+
+  return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+}
+
+result(json_string)
+    json_path_step_array(typed(json_parser) * parser, typed(json_string) str,
+                         const typed(json_path_segment) * segment) {
+  if (segment->index == SIZE_MAX)
+    return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+
+  // Skip the starting '[' character
+  str++;
+
+  json_skip_whitespace(parser, &str);
+
+  if (json_peek(parser, str) == ']')
+    return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+
+  typed(size) i = 0;
+  while (str < parser->end) {
+    json_skip_whitespace(parser, &str);
+
+    typed(json_string) element = str;
+    result_try(json_string, json_element_type, type,
+               json_guess_element_type(parser, str));
+
+    // Null and empty elements are left out of arrays, so they are not
+    // counted either, as in the array made by `json_parse`
+    if (i == segment->index && json_path_holds_value(parser, element, type))
+      return result_ok(json_string)(element);
+    if (json_skip_element_value(parser, &str, type))
+      i++;
+
+    json_skip_whitespace(parser, &str);
+
+    char next = json_peek(parser, str);
+    if (next == ']')
+      return result_err(json_string)(JSON_ERROR_INVALID_KEY);
+    if (next != ',')
+      return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+
+    // Skip the ','
+    str++;
+  }
+
+  return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
+}
+
+bool json_path_holds_value(typed(json_parser) * parser, typed(json_string) str,
+                           typed(json_element_type) type) {
+  switch (type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    return json_string_len(parser, str + 1, NULL) > 0;
+  case JSON_ELEMENT_TYPE_NUMBER:
+    return true;
+  case JSON_ELEMENT_TYPE_BOOLEAN:
+    return json_boolean_len(parser, str) > 0;
+  case JSON_ELEMENT_TYPE_OBJECT:
+  case JSON_ELEMENT_TYPE_ARRAY:
+    break;
+
+  default:
+    return false;
+  }
+
+  // A container is kept exactly when some value anywhere inside it is,
+  // so the brackets are only counted, however deep they nest
+  typed(size) depth = 0;
+
+  while (str < parser->end) {
+    json_skip_whitespace(parser, &str);
+
+    switch (json_peek(parser, str)) {
+    case '{':
+    case '[':
+      depth++;
+      str++;
+      continue;
+    case '}':
+    case ']':
+      str++;
+      if (--depth == 0)
+        return false;
+      continue;
+    case ',':
+      str++;
+      continue;
+    case '"': {
+      // Skip the starting '"' character
+      str++;
+
+      typed(size) len = json_string_len(parser, str, NULL);
+      if (len == 0 && json_peek(parser, str) != '"')
+        return false;
+
+      // Skip the string along with its closing '"'
+      str += len + 1;
+
+      json_skip_whitespace(parser, &str);
+
+      // Keys are followed by ':' and hold nothing themselves
+      if (json_peek(parser, str) == ':') {
+        str++;
+        continue;
+      }
+
+      if (len > 0)
+        return true;
+      continue;
+    }
+    default:
+      break;
+    }
+
+    result(json_element_type) type_result =
+        json_guess_element_type(parser, str);
+    if (result_is_err(json_element_type)(&type_result)) {
+      str++;
+      continue;
+    }
+
+    switch (result_unwrap(json_element_type)(&type_result)) {
+    case JSON_ELEMENT_TYPE_NUMBER:
+      return true;
+    case JSON_ELEMENT_TYPE_BOOLEAN:
+      if (json_skip_boolean(parser, &str))
+        return true;
+
+      // Not a literal after all
+      str++;
+      break;
+    case JSON_ELEMENT_TYPE_NULL:
+      json_skip_null(parser, &str);
+      break;
+    default:
+      str++;
+      break;
+    }
+  }
+
+  return false;
+}
+
+bool json_path_key_equals(typed(json_parser) * parser, typed(json_string) str,
+                          typed(size) len, bool escaped,
+                          const typed(json_path_segment) * segment) {
+  if (!escaped)
+    return len == segment->key_len && memcmp(str, segment->key, len) == 0;
+
+  // Unescaping never lengthens a key, so a shorter one cannot match
+  if (len < segment->key_len)
+    return false;
+
+  typed(size) mark = parser->stack_size;
+  char *unescaped = (char *)json_parser_stack_push(parser, len + 1);
+  result(size) len_result = json_unescape_string(str, len, unescaped);
+
+  bool equals = result_is_ok(size)(&len_result) &&
+                result_unwrap(size)(&len_result) == segment->key_len &&
+                memcmp(unescaped, segment->key, segment->key_len) == 0;
+  parser->stack_size = mark;
+
+  return equals;
+}
+
+typed(json_cursor)
+    json_cursor_make(typed(json_string) json_str, typed(size) len,
+                     const typed(json_parse_options) * options) {
+  const typed(json_cursor) cursor = {
+      .position = json_str,
+      .end = json_str + len,
+      .skip_whitespace = options != NULL ? options->skip_whitespace
+                                         : JSON_DEFAULT_SKIP_WHITESPACE,
+  };
+
+  return cursor;
+}
+
+result(json_element_type) json_cursor_type(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+
+  return json_guess_element_type(&parser, cursor->position);
+}
+
+typed(json_boolean) json_cursor_enter_object(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+  if (json_peek(&parser, cursor->position) != '{')
+    return false;
+
+  // Skip the starting '{' character
+  cursor->position++;
+
+  return true;
+}
+
+typed(json_boolean) json_cursor_enter_array(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+  if (json_peek(&parser, cursor->position) != '[')
+    return false;
+
+  // Skip the starting '[' character
+  cursor->position++;
+
+  return true;
+}
+
+result(json_boolean) json_cursor_next_field(typed(json_cursor) * cursor,
+                                            typed(json_string_view) * key) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  result_try(json_boolean, json_boolean, more,
+             json_cursor_next(cursor, &parser, '}'));
+  if (!more)
+    return result_ok(json_boolean)(false);
+
+  typed(json_string) str = cursor->position;
+  if (json_peek(&parser, str) != '"')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_KEY);
+
+  // Skip the starting '"' character
+  str++;
+
+  typed(size) len = json_string_len(&parser, str, NULL);
+  if (len == 0 && json_peek(&parser, str) != '"')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_KEY);
+
+  key->data = str;
+  key->len = len;
+
+  // Skip the key along with its closing '"'
+  str += len + 1;
+
+  json_skip_whitespace(&parser, &str);
+
+  if (json_peek(&parser, str) != ':')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  // Skip the ':' delimiter
+  str++;
+
+  json_skip_whitespace(&parser, &str);
+  cursor->position = str;
+
+  return result_ok(json_boolean)(true);
+}
+
+result(json_boolean) json_cursor_next_element(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  return json_cursor_next(cursor, &parser, ']');
+}
+
+result(json_string_view)
+    json_cursor_get_string(typed(json_cursor) * cursor, char *buffer,
+                           typed(size) capacity) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+  if (json_peek(&parser, cursor->position) != '"')
+    return result_err(json_string_view)(JSON_ERROR_INVALID_TYPE);
+
+  // Skip the starting '"' character
+  typed(json_string) str = cursor->position + 1;
+
+  bool escaped;
+  typed(size) len = json_string_len(&parser, str, &escaped);
+  if (len == 0 && json_peek(&parser, str) != '"')
+    return result_err(json_string_view)(JSON_ERROR_INVALID_VALUE);
+
+  typed(json_string_view) view = {str, len};
+
+  // Unescaping never lengthens a string, so the length in the input
+  // along with the NUL always fits
+  if (escaped) {
+    if (buffer == NULL || capacity <= len)
+      return result_err(json_string_view)(JSON_ERROR_INVALID_VALUE);
+
+    result_try(json_string_view, size, unescaped_len,
+               json_unescape_string(str, len, buffer));
+    view.data = buffer;
+    view.len = unescaped_len;
+  }
+
+  // Skip the string along with its closing '"'
+  cursor->position = str + len + 1;
+
+  return result_ok(json_string_view)(view);
+}
+
+result(json_number) json_cursor_get_number(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+  if (!json_is_number(json_peek(&parser, cursor->position)))
+    return result_err(json_number)(JSON_ERROR_INVALID_TYPE);
+
+  typed(json_string) str = cursor->position;
+  result_try(json_number, json_element_value, value,
+             json_parse_number(&parser, &str));
+  cursor->position = str;
+
+  return result_ok(json_number)(value.as_number);
+}
+
+result(json_boolean) json_cursor_get_boolean(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+  typed(size) len = json_boolean_len(&parser, cursor->position);
+  if (len == 0)
+    return result_err(json_boolean)(JSON_ERROR_INVALID_TYPE);
+
+  typed(json_boolean) value = *cursor->position == 't';
+  cursor->position += len;
+
+  return result_ok(json_boolean)(value);
+}
+
+typed(json_boolean) json_cursor_skip(typed(json_cursor) * cursor) {
+  typed(json_parser) parser;
+  json_cursor_parser(cursor, &parser);
+
+  json_skip_whitespace(&parser, &cursor->position);
+
+  result(json_element_type) type_result =
+      json_guess_element_type(&parser, cursor->position);
+  if (result_is_err(json_element_type)(&type_result))
+    return false;
+
+  // Whether it is kept by a parse does not matter here
+  json_skip_element_value(&parser, &cursor->position,
+                          result_unwrap(json_element_type)(&type_result));
+  json_parser_finish(&parser);
+
+  return true;
+}
+
+void json_cursor_parser(typed(json_cursor) * cursor,
+                        typed(json_parser) * parser) {
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = cursor->skip_whitespace;
+
+  // Without an index or interned keys, nothing is allocated but the
+  // scratch stack of `json_cursor_skip`
+  json_parser_init(parser, cursor->position, cursor->end - cursor->position,
+                   &options, NULL);
+}
+
+result(json_boolean) json_cursor_next(typed(json_cursor) * cursor,
+                                      typed(json_parser) * parser,
+                                      char close) {
+  json_skip_whitespace(parser, &cursor->position);
+
+  // Skip the ',' to move to the next item
+  if (json_peek(parser, cursor->position) == ',') {
+    cursor->position++;
+    json_skip_whitespace(parser, &cursor->position);
+  }
+
+  char next = json_peek(parser, cursor->position);
+  if (next == close) {
+    // Skip the closing bracket
+    cursor->position++;
+    return result_ok(json_boolean)(false);
+  }
+
+  if (next == '\0')
+    return result_err(json_boolean)(JSON_ERROR_INVALID_VALUE);
+
+  return result_ok(json_boolean)(true);
+}
+
+bool json_skip_entry_value(typed(json_parser) * parser,
+                           typed(json_string) * str_ptr) {
+  json_skip_whitespace(parser, str_ptr);
+
+  // Skip the ':' delimiter
+  json_skip_char(parser, str_ptr);
+
+  json_skip_whitespace(parser, str_ptr);
+
+  result(json_element_type) type_result =
+      json_guess_element_type(parser, *str_ptr);
+  if (result_is_err(json_element_type)(&type_result))
+    return false;
+
+  typed(json_element_type) type =
+      result_unwrap(json_element_type)(&type_result);
+
+  return json_skip_element_value(parser, str_ptr, type);
+}
+
+bool json_skip_element_value(typed(json_parser) * parser,
+                             typed(json_string) * str_ptr,
+                             typed(json_element_type) type) {
+  switch (type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    return json_skip_string(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_NUMBER:
+    return json_skip_number(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_OBJECT:
+  case JSON_ELEMENT_TYPE_ARRAY:
+    return json_skip_container(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_BOOLEAN:
+    return json_skip_boolean(parser, str_ptr);
+  case JSON_ELEMENT_TYPE_NULL:
+    json_skip_null(parser, str_ptr);
+    return false;
+
+  default:
+    return false;
+  }
+}
+
+bool json_skip_string(typed(json_parser) * parser,
+                      typed(json_string) * str_ptr) {
+  // Skip the initial '"'
+  (*str_ptr)++;
+
+  // Find the length till the last '"'
+  typed(size) len = json_string_len(parser, *str_ptr, NULL);
+  if (len == 0) {
+    // Skip the end quote
+    json_skip_char(parser, str_ptr);
+    return false;
+  }
+
+  // Skip till the end of the string
+  (*str_ptr) += len + 1;
+
+  return true;
+}
+
+bool json_skip_number(typed(json_parser) * parser,
+                      typed(json_string) * str_ptr) {
+  while (*str_ptr < parser->end && json_is_number(**str_ptr)) {
+    (*str_ptr)++;
+  }
+
+  return true;
+}
+
+bool json_skip_container(typed(json_parser) * parser,
+                         typed(json_string) * str_ptr) {
+  typed(size) depth = parser->depth;
+  bool kept = false;
+
+  // Every turn opens the container at the string pointer
+  for (;;) {
+    char bracket = **str_ptr;
+
+    if (parser->depth >= parser->max_depth) {
+      // Such a container would fail to parse, so it holds no value
+      json_skip_brackets(parser, str_ptr);
+    } else {
+      // Skip the opening bracket
+      (*str_ptr)++;
+
+      json_skip_whitespace(parser, str_ptr);
+
+      // '{' and '[' are two below their closing counterparts
+      if (json_peek(parser, *str_ptr) == bracket + 2) {
+        // Skip the closing bracket
+        (*str_ptr)++;
+      } else {
+        *parser_stack_push(parser, char) = bracket;
+        parser->depth++;
+
+        if (json_skip_items(parser, str_ptr, false, &kept))
+          continue;
+      }
+    }
+
+    // Go on with the items of the container it is nested in, until one
+    // more has to be opened
+    for (;;) {
+      if (parser->depth == depth)
+        return kept;
+
+      if (json_skip_items(parser, str_ptr, true, &kept))
+        break;
+    }
+  }
+}
+
+bool json_skip_items(typed(json_parser) * parser, typed(json_string) * str_ptr,
+                     bool resume, bool *kept) {
+  // Each bracket takes an aligned slot like any item of the stack
+  typed(size) slot = json_arena_align(sizeof(char));
+  char bracket = *parser_stack_at(parser, char, parser->stack_size - slot);
+  char close = bracket + 2;
+
+  // A nested container is followed by whitespace like any other item
+  if (resume)
+    json_skip_whitespace(parser, str_ptr);
+
+  for (bool first = !resume;; first = false) {
+    if (!first) {
+      if (json_peek(parser, *str_ptr) == close)
+        break;
+
+      // Skip the ',' to move to the next item
+      json_skip_char(parser, str_ptr);
+    }
+
+    if (*str_ptr >= parser->end)
+      break;
+
+    // Skip any accidental whitespace
+    json_skip_whitespace(parser, str_ptr);
+
+    if (bracket == '{') {
+      json_skip_string(parser, str_ptr);
+      json_skip_whitespace(parser, str_ptr);
+
+      // Skip the ':' delimiter
+      json_skip_char(parser, str_ptr);
+
+      json_skip_whitespace(parser, str_ptr);
+    }
+
+    result(json_element_type) type_result =
+        json_guess_element_type(parser, *str_ptr);
+    if (result_is_ok(json_element_type)(&type_result)) {
+      typed(json_element_type) type =
+          result_unwrap(json_element_type)(&type_result);
+      if (type == JSON_ELEMENT_TYPE_OBJECT || type == JSON_ELEMENT_TYPE_ARRAY)
+        return true;
+
+      *kept |= json_skip_element_value(parser, str_ptr, type);
+    }
+
+    json_skip_whitespace(parser, str_ptr);
+  }
+
+  // Skip the closing bracket
+  json_skip_char(parser, str_ptr);
+
+  parser->stack_size -= slot;
+  parser->depth--;
+
+  return false;
+}
+
+void json_skip_brackets(typed(json_parser) * parser,
+                        typed(json_string) * str_ptr) {
+  typed(json_string) str = *str_ptr;
+  typed(size) depth = 0;
+
+  while (str < parser->end) {
+    char ch = *str++;
+
+    if (ch == '"') {
+      // An unterminated string runs to the end of the input
+      typed(size) len = json_string_len(parser, str, NULL);
+      str = len != 0 || json_peek(parser, str) == '"' ? str + len + 1
+                                                       : parser->end;
+    } else if (ch == '{' || ch == '[') {
+      depth++;
+    } else if ((ch == '}' || ch == ']') && --depth == 0) {
+      break;
+    }
+  }
+
+  *str_ptr = str;
+}
+
+bool json_skip_boolean(typed(json_parser) * parser,
+                       typed(json_string) * str_ptr) {
+  typed(size) len = json_boolean_len(parser, *str_ptr);
+  (*str_ptr) += len;
+
+  return len > 0;
+}
+
+typed(size) json_boolean_len(typed(json_parser) * parser,
+                             typed(json_string) str) {
+  typed(size) remaining = parser->end - str;
+
+  if (remaining >= 4 && memcmp(str, "true", 4) == 0)
+    return 4;
+
+  if (remaining >= 5 && memcmp(str, "false", 5) == 0)
+    return 5;
+
+  return 0;
+}
+
+void json_skip_char(typed(json_parser) * parser, typed(json_string) * str_ptr) {
+  if (*str_ptr < parser->end)
+    (*str_ptr)++;
+}
+
+void json_skip_whitespace_run(typed(json_parser) * parser,
+                              typed(json_string) * str_ptr) {
+  // A single space, as after ':', is the most common run of all
+  (*str_ptr)++;
+  if (*str_ptr == parser->end || !is_whitespace(**str_ptr))
+    return;
+
+  // Indentation is long enough to be worth a kernel
+  *str_ptr = json_scan_whitespace(*str_ptr + 1, parser->end);
+}
+
+void json_skip_null(typed(json_parser) * parser, typed(json_string) * str_ptr) {
+  if (parser->end - *str_ptr < 4) {
+    *str_ptr = parser->end;
+    return;
+  }
+
+  (*str_ptr) += 4;
+}
 
-    // Skip any accidental whitespace
-    json_skip_whitespace(&temp_str);
+typed(json_sink)
+    json_sink_make(typed(json_boolean) (*write)(void *userdata,
+                                                typed(json_string) data,
+                                                typed(size) len),
+                   void *userdata) {
+  typed(json_sink) sink = {
+      .write = write,
+      .userdata = userdata,
+      .buffer = NULL,
+      .len = 0,
+      .capacity = 0,
+      .failed = false,
+  };
 
-    if (*temp_str == '}')
-      break;
+  return sink;
+}
 
-    // Skip the ',' to move to the next entry
-    temp_str++;
+typed(json_boolean) json_sink_write_file(void *file, typed(json_string) data,
+                                         typed(size) len) {
+  return fwrite(data, 1, len, (FILE *)file) == len;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+typed(json_boolean) json_sink_write_fd(void *fd, typed(json_string) data,
+                                       typed(size) len) {
+  while (len > 0) {
+    ssize_t written = write(*(int *)fd, data, len);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+
+    data += written;
+    len -= written;
   }
 
-  if (count == 0)
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+  return true;
+}
+#endif
 
-  // ******* Initialize the hash map *******
-  // Now we have a perfectly sized hash map
-  typed(json_entry) **entries = allocN(typed(json_entry) *, count);
-  for (size_t i = 0; i < count; i++)
-    entries[i] = NULL;
+typed(json_boolean) json_sink_flush(typed(json_sink) * sink) {
+  if (sink->write == NULL)
+    return !sink->failed;
 
-  // Skip the first '{' character
-  (*str_ptr)++;
+  // Once the callback fails the output has a hole in it, so the rest is
+  // dropped rather than written
+  if (sink->len != 0 && !sink->failed)
+    sink->failed = !sink->write(sink->userdata, sink->buffer, sink->len);
 
-  json_skip_whitespace(str_ptr);
+  sink->len = 0;
+  return !sink->failed;
+}
 
-  while (**str_ptr != '\0') {
-    // Skip any accidental whitespace
-    json_skip_whitespace(str_ptr);
-    result(json_entry) entry_result = json_parse_entry(str_ptr);
-
-    if (result_is_ok(json_entry)(&entry_result)) {
-      typed(json_entry) entry = result_unwrap(json_entry)(&entry_result);
-      typed(uint64) bucket = json_key_hash(entry.key) % count;
-
-      // Bucket size is exactly count. So there will be at max
-      // count misses in the worst case
-      for (size_t i = 0; i < count; i++) {
-        if (entries[bucket] == NULL) {
-          typed(json_entry) *temp_entry = alloc(typed(json_entry));
-          memcpy(temp_entry, &entry, sizeof(typed(json_entry)));
-          entries[bucket] = temp_entry;
-          break;
-        }
+void json_sink_free(typed(json_sink) * sink) {
+  free(sink->buffer);
+  sink->buffer = NULL;
+  sink->len = 0;
+  sink->capacity = 0;
+}
 
-        bucket = (bucket + 1) % count;
-      }
+void json_sink_grow(typed(json_sink) * sink, typed(size) len) {
+  if (sink->write != NULL) {
+    json_sink_flush(sink);
+    if (sink->capacity >= len)
+      return;
+  }
+
+  typed(size) capacity =
+      sink->capacity == 0 ? JSON_SINK_BUFFER_SIZE : sink->capacity * 2;
+  while (capacity - sink->len < len)
+    capacity *= 2;
+
+  sink->buffer = reallocN(sink->buffer, char, capacity);
+  sink->capacity = capacity;
+}
+
+void json_sink_put(typed(json_sink) * sink, typed(json_string) data,
+                   typed(size) len) {
+  // Runs as long as the whole buffer go to the callback as they are,
+  // rather than being copied into it first
+  if (sink->write != NULL && len >= JSON_SINK_BUFFER_SIZE) {
+    if (json_sink_flush(sink))
+      sink->failed = !sink->write(sink->userdata, data, len);
+    return;
+  }
+
+  memcpy(json_sink_reserve(sink, len), data, len);
+  sink->len += len;
+}
+
+typed(json_boolean) json_serialize(const typed(json_element) * element,
+                                   int indent, typed(json_sink) * sink) {
+  typed(json_writer) writer = json_writer_make(sink, indent);
+  json_writer_element(&writer, element);
+  return json_writer_finish(&writer);
+}
+
+void json_print(typed(json_element) * element, int indent) {
+  typed(json_sink) sink = json_sink_make(json_sink_write_file, stdout);
+  json_serialize(element, indent, &sink);
+  json_sink_free(&sink);
+}
+
+typed(json_writer) json_writer_make(typed(json_sink) * sink, int indent) {
+  typed(json_writer) writer = {
+      .sink = sink,
+      .indent = indent < 0 ? 0 : indent,
+      .depth = 0,
+      .has_values = false,
+      .after_key = false,
+  };
+
+  return writer;
+}
+
+void json_writer_prepare(typed(json_writer) * writer) {
+  if (writer->after_key) {
+    writer->after_key = false;
+    return;
+  }
+
+  if (writer->has_values)
+    json_sink_put(writer->sink, ",", 1);
+  if (writer->indent > 0 && writer->depth > 0)
+    json_serialize_newline(writer->sink, writer->indent * writer->depth);
+
+  writer->has_values = true;
+}
+
+void json_writer_begin_object(typed(json_writer) * writer) {
+  json_writer_prepare(writer);
+  json_sink_put(writer->sink, "{", 1);
+  writer->depth++;
+  writer->has_values = false;
+}
+
+void json_writer_end_object(typed(json_writer) * writer) {
+  writer->depth--;
+  // Empty objects are closed on the line they are opened on
+  if (writer->indent > 0 && writer->has_values)
+    json_serialize_newline(writer->sink, writer->indent * writer->depth);
+  json_sink_put(writer->sink, "}", 1);
+  writer->has_values = true;
+}
+
+void json_writer_begin_array(typed(json_writer) * writer) {
+  json_writer_prepare(writer);
+  json_sink_put(writer->sink, "[", 1);
+  writer->depth++;
+  writer->has_values = false;
+}
+
+void json_writer_end_array(typed(json_writer) * writer) {
+  writer->depth--;
+  if (writer->indent > 0 && writer->has_values)
+    json_serialize_newline(writer->sink, writer->indent * writer->depth);
+  json_sink_put(writer->sink, "]", 1);
+  writer->has_values = true;
+}
+
+void json_writer_key(typed(json_writer) * writer, typed(json_string) key) {
+  json_writer_key_n(writer, key, strlen(key));
+}
+
+void json_writer_key_n(typed(json_writer) * writer, typed(json_string) key,
+                       typed(size) len) {
+  json_writer_prepare(writer);
+  json_serialize_string(writer->sink, key, len);
+  json_sink_put(writer->sink, ": ", writer->indent > 0 ? 2 : 1);
+  writer->after_key = true;
+}
+
+void json_writer_string(typed(json_writer) * writer, typed(json_string) str) {
+  json_writer_string_n(writer, str, strlen(str));
+}
+
+void json_writer_string_n(typed(json_writer) * writer, typed(json_string) str,
+                          typed(size) len) {
+  json_writer_prepare(writer);
+  json_serialize_string(writer->sink, str, len);
+}
+
+void json_writer_number(typed(json_writer) * writer,
+                        typed(json_number) number) {
+  json_writer_prepare(writer);
+  json_serialize_number(writer->sink, number);
+}
+
+void json_writer_long(typed(json_writer) * writer,
+                      typed(json_number_long) value) {
+  json_writer_prepare(writer);
+  char *out = json_sink_reserve(writer->sink, JSON_NUMBER_BUFFER_SIZE);
+  writer->sink->len += json_format_long(out, value);
+}
+
+void json_writer_double(typed(json_writer) * writer,
+                        typed(json_number_double) value) {
+  json_writer_prepare(writer);
+  char *out = json_sink_reserve(writer->sink, JSON_NUMBER_BUFFER_SIZE);
+  writer->sink->len += json_format_double(out, value);
+}
+
+void json_writer_boolean(typed(json_writer) * writer,
+                         typed(json_boolean) value) {
+  json_writer_prepare(writer);
+  if (value)
+    json_sink_put(writer->sink, "true", 4);
+  else
+    json_sink_put(writer->sink, "false", 5);
+}
+
+void json_writer_null(typed(json_writer) * writer) {
+  json_writer_prepare(writer);
+  json_sink_put(writer->sink, "null", 4);
+}
+
+void json_writer_element(typed(json_writer) * writer,
+                         const typed(json_element) * element) {
+  typed(json_writer_frame) initial[JSON_WRITER_STACK_INITIAL_CAPACITY];
+  typed(json_writer_frame) *frames = initial;
+  typed(size) capacity = JSON_WRITER_STACK_INITIAL_CAPACITY;
+  typed(size) depth = json_writer_open(writer, &frames[0], element) ? 1 : 0;
+
+  // Walk the containers on a stack of their own rather than recursively,
+  // so that any depth the parser allows can be written
+  while (depth > 0) {
+    typed(json_writer_frame) *frame = &frames[depth - 1];
+
+    if (frame->next == frame->count) {
+      if (frame->is_object)
+        json_writer_end_object(writer);
+      else
+        json_writer_end_array(writer);
+      depth--;
+      continue;
     }
 
-    // Skip any accidental whitespace
-    json_skip_whitespace(str_ptr);
+    typed(size) i = frame->next++;
+    const typed(json_element) *value = &frame->values[i];
+    if (frame->is_object)
+      json_writer_key_n(writer, frame->keys[i].data, frame->keys[i].len);
+
+    if (depth == capacity) {
+      typed(json_writer_frame) *grown =
+          allocN(typed(json_writer_frame), capacity * 2);
+      memcpy(grown, frames, capacity * sizeof(typed(json_writer_frame)));
+      if (frames != initial)
+        free(frames);
+
+      frames = grown;
+      capacity *= 2;
+    }
+
+    if (json_writer_open(writer, &frames[depth], value))
+      depth++;
+  }
+
+  if (frames != initial)
+    free(frames);
+}
+
+bool json_writer_open(typed(json_writer) * writer,
+                      typed(json_writer_frame) * frame,
+                      const typed(json_element) * element) {
+  switch (element->type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    json_writer_string_n(writer, element->value.as_view.data,
+                         element->value.as_view.len);
+    return false;
+  case JSON_ELEMENT_TYPE_NUMBER:
+    json_writer_number(writer, element->value.as_number);
+    return false;
+  case JSON_ELEMENT_TYPE_OBJECT: {
+    const typed(json_object) *object = element->value.as_object;
+    json_writer_begin_object(writer);
+
+    frame->values = object->values;
+    frame->keys = object->count != 0 ? object->shape->keys : NULL;
+    frame->count = object->count;
+    frame->next = 0;
+    frame->is_object = true;
+    return true;
+  }
+  case JSON_ELEMENT_TYPE_ARRAY: {
+    const typed(json_array) *array = element->value.as_array;
+    json_writer_begin_array(writer);
+
+    frame->values = array->elements;
+    frame->keys = NULL;
+    frame->count = array->count;
+    frame->next = 0;
+    frame->is_object = false;
+    return true;
+  }
+  case JSON_ELEMENT_TYPE_BOOLEAN:
+    json_writer_boolean(writer, element->value.as_boolean);
+    return false;
+  case JSON_ELEMENT_TYPE_NULL:
+    json_writer_null(writer);
+    return false;
+  }
 
-    if (**str_ptr == '}')
+  return false;
+}
+
+typed(json_boolean) json_writer_finish(typed(json_writer) * writer) {
+  return json_sink_flush(writer->sink);
+}
+
+void json_serialize_string(typed(json_sink) * sink, typed(json_string) str,
+                           typed(size) len) {
+  typed(json_string) end = str + len;
+
+  json_sink_put(sink, "\"", 1);
+  while (str < end) {
+    typed(json_string) run_end = json_scan_escape(str, end);
+    json_sink_put(sink, str, run_end - str);
+    if (run_end == end)
       break;
 
-    // Skip the ',' to move to the next entry
-    (*str_ptr)++;
+    char *out = json_sink_reserve(sink, 6);
+    sink->len += json_escape_char(out, (unsigned char)*run_end);
+    str = run_end + 1;
   }
+  json_sink_put(sink, "\"", 1);
+}
 
-  // Skip the '}' closing brace
-  (*str_ptr)++;
+typed(size) json_escape_char(char *out, unsigned char ch) {
+  static const char hex_digits[] = "0123456789ABCDEF";
+
+  out[0] = '\\';
+  switch (ch) {
+  case '"':
+    out[1] = '"';
+    return 2;
+  case '\\':
+    out[1] = '\\';
+    return 2;
+  case '\b':
+    out[1] = 'b';
+    return 2;
+  case '\f':
+    out[1] = 'f';
+    return 2;
+  case '\n':
+    out[1] = 'n';
+    return 2;
+  case '\r':
+    out[1] = 'r';
+    return 2;
+  case '\t':
+    out[1] = 't';
+    return 2;
+  }
 
-  typed(json_object) *object = alloc(typed(json_object));
-  object->count = count;
-  object->entries = entries;
+  memcpy(out + 1, "u00", 3);
+  out[4] = hex_digits[ch >> 4];
+  out[5] = hex_digits[ch & 0xF];
+  return 6;
+}
 
-  typed(json_element_value) retval = {0};
-  retval.as_object = object;
+void json_serialize_number(typed(json_sink) * sink, typed(json_number) number) {
+  char *out = json_sink_reserve(sink, JSON_NUMBER_BUFFER_SIZE);
 
-  return result_ok(json_element_value)(retval);
+  switch (number.type) {
+  case JSON_NUMBER_TYPE_DOUBLE:
+    sink->len += json_format_double(out, number.value.as_double);
+    break;
+
+  case JSON_NUMBER_TYPE_LONG:
+    sink->len += json_format_long(out, number.value.as_long);
+    break;
+  }
 }
 
-typed(uint64) json_key_hash(typed(json_string) str) {
-  typed(uint64) hash = 0;
+void json_serialize_newline(typed(json_sink) * sink, typed(size) spaces) {
+  char *out = json_sink_reserve(sink, spaces + 1);
+
+  out[0] = '\n';
+  memset(out + 1, ' ', spaces);
+  sink->len += spaces + 1;
+}
+
+typed(size) json_format_digits(char *out, typed(uint64) value) {
+  // Written backwards from the last digit, two at a time
+  char digits[20];
+  char *first = digits + sizeof(digits);
+
+  while (value >= 100) {
+    first -= 2;
+    memcpy(first, &json_digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
 
-  while (*str != '\0')
-    hash += (hash * 31) + *str++;
+  if (value >= 10) {
+    first -= 2;
+    memcpy(first, &json_digit_pairs[value * 2], 2);
+  } else {
+    *--first = (char)('0' + value);
+  }
 
-  return hash;
+  typed(size) len = digits + sizeof(digits) - first;
+  memcpy(out, first, len);
+  return len;
 }
 
-result(json_element_value) json_parse_array(typed(json_string) * str_ptr) {
-  // Skip the starting '[' character
-  (*str_ptr)++;
+typed(size) json_format_long(char *out, long value) {
+  if (value >= 0)
+    return json_format_digits(out, (typed(uint64))value);
 
-  json_skip_whitespace(str_ptr);
+  // Negated as unsigned so that the smallest `long` does not overflow
+  out[0] = '-';
+  return 1 + json_format_digits(out + 1, -(typed(uint64))value);
+}
 
-  // Unfortunately the array is empty
-  if (**str_ptr == ']') {
-    // Skip the end ']'
-    (*str_ptr)++;
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+typed(size) json_format_double(char *out, double value) {
+  if (isnan(value) || isinf(value)) {
+    memcpy(out, "null", 4);
+    return 4;
   }
 
-  typed(size) count = 0;
-  typed(json_element) *elements = NULL;
+  char *start = out;
+  if (signbit(value)) {
+    *out++ = '-';
+    value = -value;
+  }
 
-  while (**str_ptr != '\0') {
-    json_skip_whitespace(str_ptr);
+  // Written with a fraction so that it reads back as a double
+  if (value == 0) {
+    memcpy(out, "0.0", 3);
+    return out + 3 - start;
+  }
 
-    // Guess the type
-    result(json_element_type) type_result = json_guess_element_type(*str_ptr);
-    if (result_is_ok(json_element_type)(&type_result)) {
-      typed(json_element_type) type =
-          result_unwrap(json_element_type)(&type_result);
+  int exponent;
+  typed(uint64) significand = json_shortest_decimal(value, &exponent);
+  while (significand % 10 == 0) {
+    significand /= 10;
+    exponent++;
+  }
 
-      // Parse the value based on guessed type
-      result(json_element_value) value_result =
-          json_parse_element_value(str_ptr, type);
-      if (result_is_ok(json_element_value)(&value_result)) {
-        typed(json_element_value) value =
-            result_unwrap(json_element_value)(&value_result);
+  char digits[20];
+  int count = (int)json_format_digits(digits, significand);
+  // The exponent of the first digit, as in scientific notation
+  int point = exponent + count - 1;
+
+  if (point < -4 || point >= 16) {
+    *out++ = digits[0];
+    if (count > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, count - 1);
+      out += count - 1;
+    }
+
+    *out++ = 'e';
+    out += json_format_long(out, point);
+  } else if (point < 0) {
+    memcpy(out, "0.", 2);
+    memset(out + 2, '0', -point - 1);
+    out += 1 - point;
+    memcpy(out, digits, count);
+    out += count;
+  } else if (exponent < 0) {
+    memcpy(out, digits, point + 1);
+    out[point + 1] = '.';
+    memcpy(out + point + 2, digits + point + 1, count - point - 1);
+    out += count + 1;
+  } else {
+    memcpy(out, digits, count);
+    memset(out + count, '0', exponent);
+    out += count + exponent;
+    memcpy(out, ".0", 2);
+    out += 2;
+  }
+
+  return out - start;
+}
+
+typed(uint64) json_shortest_decimal(double value, int *exponent) {
+  typed(uint64) bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  typed(uint64) fraction = bits & (((typed(uint64))1 << 52) - 1);
+  int biased_exponent = (int)(bits >> 52);
+
+  if (biased_exponent == 0) {
+    // Subnormals with too few bits for the precision of the algorithm
+    // are scaled up by ten first
+    if (fraction < 3)
+      return json_schubfach(10 * fraction, -1074, -1, exponent);
+
+    return json_schubfach(fraction, -1074, 0, exponent);
+  }
+
+  typed(uint64) significand = ((typed(uint64))1 << 52) | fraction;
+  int binary_exponent = biased_exponent - 1075;
+
+  // Integers below 2^53 are their own shortest decimal
+  if (binary_exponent < 0 && binary_exponent > -53 &&
+      (significand & (((typed(uint64))1 << -binary_exponent) - 1)) == 0) {
+    *exponent = 0;
+    return significand >> -binary_exponent;
+  }
+
+  return json_schubfach(significand, binary_exponent, 0, exponent);
+}
+
+typed(uint64) json_schubfach(typed(uint64) c, int q, int dk, int *exponent) {
+  // Doubles with an even significand round the bounds of their interval
+  // to themselves
+  typed(uint64) out = c & 1;
+  typed(uint64) cb = c << 2;
+  typed(uint64) cbr = cb + 2;
+  typed(uint64) cbl;
+  int k;
+
+  // The interval is narrower below a power of two, whose predecessor is
+  // closer than its successor
+  if (c != (typed(uint64))1 << 52 || q == -1074) {
+    cbl = cb - 2;
+    k = (int)(((typed(int64))q * 661971961083) >> 41);
+  } else {
+    cbl = cb - 1;
+    k = (int)(((typed(int64))q * 661971961083 - 274743187321) >> 41);
+  }
+
+  int h = q + (int)((-(typed(int64))k * 913124641741) >> 38) + 2;
+
+  // The table holds 10^-k rounded down to 128 bits, while Schubfach
+  // wants it to 126 bits rounded up, split in two 63-bit halves
+  const typed(uint64) *power = json_powers_of_ten[-k - JSON_POWER_OF_TEN_MIN];
+  typed(uint64) high = power[0] >> 2;
+  typed(uint64) low = (power[0] << 62) | (power[1] >> 2);
+  if (++low == 0)
+    high++;
+
+  typed(uint64) g1 = (high << 1) | (low >> 63);
+  typed(uint64) g0 = low & (((typed(uint64))1 << 63) - 1);
+
+  typed(uint64) vb = json_round_to_odd(g1, g0, cb << h);
+  typed(uint64) vbl = json_round_to_odd(g1, g0, cbl << h);
+  typed(uint64) vbr = json_round_to_odd(g1, g0, cbr << h);
+
+  typed(uint64) s = vb >> 2;
+  *exponent = k + dk;
+  if (s >= 10) {
+    // One digit less, if either multiple of ten around is in the interval
+    typed(uint64) sp10 = s / 10 * 10;
+    typed(uint64) tp10 = sp10 + 10;
+    bool upin = vbl + out <= sp10 << 2;
+    bool wpin = (tp10 << 2) + out <= vbr;
+    if (upin != wpin)
+      return upin ? sp10 : tp10;
+
+    // Only the intervals of the smallest subnormals, scaled up by ten,
+    // are wide enough to hold both
+    if (upin) {
+      typed(int64) cmp = (typed(int64))(vb - ((sp10 + tp10) << 1));
+      return cmp < 0 || (cmp == 0 && (sp10 / 10 & 1) == 0) ? sp10 : tp10;
+    }
+  }
+
+  typed(uint64) t = s + 1;
+  bool uin = vbl + out <= s << 2;
+  bool win = (t << 2) + out <= vbr;
+  if (uin != win)
+    return uin ? s : t;
+
+  // Both are in the interval, so the closest wins, the even one on a tie
+  typed(int64) cmp = (typed(int64))(vb - ((s + t) << 1));
+  return cmp < 0 || (cmp == 0 && (s & 1) == 0) ? s : t;
+}
+
+typed(uint64) json_round_to_odd(typed(uint64) g1, typed(uint64) g0,
+                                typed(uint64) cp) {
+  typed(uint64) x1;
+  json_multiply_128(g0, cp, &x1);
+
+  typed(uint64) y1;
+  typed(uint64) y0 = json_multiply_128(g1, cp, &y1);
+
+  typed(uint64) z = (y0 >> 1) + x1;
+  typed(uint64) vbp = y1 + (z >> 63);
+  return vbp | (((z & (((typed(uint64))1 << 63) - 1)) +
+                 (((typed(uint64))1 << 63) - 1)) >>
+                63);
+}
+
+void json_free(typed(json_element) * element) {
+  typed(json_free_frame) initial[JSON_FREE_STACK_INITIAL_CAPACITY];
+  typed(json_free_frame) *frames = initial;
+  typed(size) capacity = JSON_FREE_STACK_INITIAL_CAPACITY;
+  typed(size) depth = json_free_open(&frames[0], element) ? 1 : 0;
+
+  // Walk the containers on a stack of their own rather than recursively,
+  // so that any depth the parser allows can be freed
+  while (depth > 0) {
+    typed(json_free_frame) *frame = &frames[depth - 1];
+
+    if (frame->next == frame->count) {
+      free(frame->elements);
+      free(frame->container);
+      depth--;
+      continue;
+    }
+
+    typed(json_element) *value = &frame->values[frame->next++];
+
+    if (depth == capacity) {
+      typed(json_free_frame) *grown =
+          allocN(typed(json_free_frame), capacity * 2);
+      memcpy(grown, frames, capacity * sizeof(typed(json_free_frame)));
+      if (frames != initial)
+        free(frames);
+
+      frames = grown;
+      capacity *= 2;
+    }
+
+    if (json_free_open(&frames[depth], value))
+      depth++;
+  }
+
+  if (frames != initial)
+    free(frames);
+}
+
+bool json_free_open(typed(json_free_frame) * frame,
+                    typed(json_element) * element) {
+  switch (element->type) {
+  case JSON_ELEMENT_TYPE_STRING:
+    json_free_string(element->value.as_string);
+    return false;
+
+  case JSON_ELEMENT_TYPE_OBJECT: {
+    typed(json_object) *object = element->value.as_object;
+    if (object == NULL)
+      return false;
+
+    // Objects of a tree never share their shape, so their keys go at
+    // once. The values and the shape are part of the object
+    for (size_t i = 0; i < object->count; i++)
+      free((void *)object->shape->keys[i].data);
+
+    frame->values = object->values;
+    frame->count = object->count;
+    frame->container = object;
+    frame->elements = NULL;
+    break;
+  }
+
+  case JSON_ELEMENT_TYPE_ARRAY: {
+    typed(json_array) *array = element->value.as_array;
+    if (array == NULL)
+      return false;
 
-        count++;
-        elements = reallocN(elements, typed(json_element), count);
-        elements[count - 1].type = type;
-        elements[count - 1].value = value;
+    frame->values = array->elements;
+    frame->count = array->count;
+    frame->container = array;
+    frame->elements = array->count != 0 ? array->elements : NULL;
+    break;
+  }
+
+  case JSON_ELEMENT_TYPE_NUMBER:
+  case JSON_ELEMENT_TYPE_BOOLEAN:
+  case JSON_ELEMENT_TYPE_NULL:
+    // Do nothing
+    return false;
+  }
+
+  frame->next = 0;
+
+  return true;
+}
+
+void json_free_string(typed(json_string) string) { free((void *)string); }
+
+void json_document_free(typed(json_document) * document) {
+  json_arena_free(document->arena);
+  document->arena = NULL;
+}
+
+void json_tape_free(typed(json_tape) * tape) {
+  free(tape->words);
+  free(tape->strings);
+  tape->words = NULL;
+  tape->count = 0;
+  tape->strings = NULL;
+  tape->strings_len = 0;
+}
+
+typed(json_string) json_error_to_string(typed(json_error) error) {
+  switch (error) {
+  case JSON_ERROR_EMPTY:
+    return "Empty";
+  case JSON_ERROR_INVALID_KEY:
+    return "Invalid key";
+  case JSON_ERROR_INVALID_TYPE:
+    return "Invalid type";
+  case JSON_ERROR_INVALID_VALUE:
+    return "Invalid value";
+  case JSON_ERROR_TOO_DEEP:
+    return "Too deep";
+
+  default:
+    return "Unknown error";
+  }
+}
+
+typed(size) json_string_len(typed(json_parser) * parser,
+                            typed(json_string) str, bool *escaped) {
+  typed(json_string) iter = str;
+
+  if (escaped != NULL)
+    *escaped = false;
+
+  while (iter < parser->end) {
+    // Jump over everything that is neither a '"' nor a '\\'
+    iter = json_scan_string(iter, parser->end);
+    if (iter == parser->end)
+      break;
+
+    // Skip the escaped character, which may well be another '\\' or '"'
+    if (*iter == '\\') {
+      if (escaped != NULL)
+        *escaped = true;
+
+      iter += 2;
+      continue;
+    }
+
+    return iter - str;
+  }
+
+  // Unterminated string
+  return 0;
+}
+
+result(size) json_unescape_string(typed(json_string) str, typed(size) len,
+                                  char *output) {
+  // An escape never expands, so the output never overtakes the input
+  // even when it is the input
+  char *offset = output;
+  typed(json_string) iter = str;
+  typed(json_string) end = str + len;
+
+  while (iter < end) {
+    // Copy the whole run up to the next escape at once
+    typed(json_string) run_end = json_scan_string(iter, end);
+    memmove(offset, iter, run_end - iter);
+    offset += run_end - iter;
+    iter = run_end;
+
+    if (iter == end)
+      break;
+
+    // Skip the '\\' to the escaped character
+    iter++;
+    if (iter == end) {
+      return result_err(size)(JSON_ERROR_INVALID_VALUE);
+    }
+
+    switch (*iter) {
+    case 'b':
+      *offset++ = '\b';
+      break;
+    case 'f':
+      *offset++ = '\f';
+      break;
+    case 'n':
+      *offset++ = '\n';
+      break;
+    case 'r':
+      *offset++ = '\r';
+      break;
+    case 't':
+      *offset++ = '\t';
+      break;
+    case '"':
+      *offset++ = '"';
+      break;
+    case '\\':
+      *offset++ = '\\';
+      break;
+    case '/':
+      *offset++ = '/';
+      break;
+    case 'u': {
+      long code = json_unescape_code_point(&iter, end);
+      if (code < 0) {
+        return result_err(size)(JSON_ERROR_INVALID_VALUE);
       }
 
-      json_skip_whitespace(str_ptr);
-    }
-
-    // Reached the end
-    if (**str_ptr == ']')
+      offset += json_utf8_encode((typed(uint32))code, offset);
       break;
+    }
+    default:
+      return result_err(size)(JSON_ERROR_INVALID_VALUE);
+    }
 
-    // Skip the ','
-    (*str_ptr)++;
+    iter++;
   }
 
-  // Skip the ']' closing array
-  (*str_ptr)++;
+  *offset = '\0';
+  return result_ok(size)(offset - output);
+}
 
-  if (count == 0)
-    return result_err(json_element_value)(JSON_ERROR_EMPTY);
+long json_unescape_code_point(typed(json_string) * str_ptr,
+                              typed(json_string) end) {
+  typed(json_string) iter = *str_ptr;
 
-  typed(json_array) *array = alloc(typed(json_array));
-  array->count = count;
-  array->elements = elements;
+  long code = end - iter > 4 ? json_hex4(iter + 1) : -1;
+  iter += 4;
 
-  typed(json_element_value) retval = {0};
-  retval.as_array = array;
+  // A lone low surrogate is not a character
+  if (code < 0 || (code >= 0xDC00 && code <= 0xDFFF))
+    return -1;
 
-  return result_ok(json_element_value)(retval);
-}
+  // A high surrogate must be followed by an escaped low surrogate
+  if (code >= 0xD800 && code <= 0xDBFF) {
+    long low = end - iter > 6 && iter[1] == '\\' && iter[2] == 'u'
+                   ? json_hex4(iter + 3)
+                   : -1;
+    if (low < 0xDC00 || low > 0xDFFF)
+      return -1;
 
-result(json_element_value) json_parse_boolean(typed(json_string) * str_ptr) {
-  typed(json_boolean) output;
+    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    iter += 6;
+  }
 
-  switch (**str_ptr) {
-  case 't':
-    output = true;
-    (*str_ptr) += 4;
-    break;
+  *str_ptr = iter;
+  return code;
+}
 
-  case 'f':
-    output = false;
-    (*str_ptr) += 5;
-    break;
+long json_hex4(typed(json_string) str) {
+  long value = 0;
+
+  for (int i = 0; i < 4; i++) {
+    char ch = str[i];
+    value <<= 4;
+
+    if (ch >= '0' && ch <= '9')
+      value |= ch - '0';
+    else if (ch >= 'a' && ch <= 'f')
+      value |= ch - 'a' + 10;
+    else if (ch >= 'A' && ch <= 'F')
+      value |= ch - 'A' + 10;
+    else
+      return -1;
   }
-  
-  typed(json_element_value) retval = {0};
-  retval.as_boolean = output;
 
-  return result_ok(json_element_value)(retval);
+  return value;
 }
 
-result(json_element)
-    json_object_find(typed(json_object) * obj, typed(json_string) key) {
-  if (key == NULL || strlen(key) == 0)
-    return result_err(json_element)(JSON_ERROR_INVALID_KEY);
-
-  typed(uint64) bucket = json_key_hash(key) % obj->count;
+typed(size) json_utf8_encode(typed(uint32) code, char *output) {
+  if (code < 0x80) {
+    output[0] = (char)code;
+    return 1;
+  }
 
-  // Bucket size is exactly obj->count. So there will be at max
-  // obj->count misses in the worst case
-  for (size_t i = 0; i < obj->count; i++) {
-    typed(json_entry) *entry = obj->entries[bucket];
-    if (strcmp(key, entry->key) == 0)
-      return result_ok(json_element)(entry->element);
+  if (code < 0x800) {
+    output[0] = (char)(0xC0 | (code >> 6));
+    output[1] = (char)(0x80 | (code & 0x3F));
+    return 2;
+  }
 
-    bucket = (bucket + 1) % obj->count;
+  if (code < 0x10000) {
+    output[0] = (char)(0xE0 | (code >> 12));
+    output[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+    output[2] = (char)(0x80 | (code & 0x3F));
+    return 3;
   }
 
-  return result_err(json_element)(JSON_ERROR_INVALID_KEY);
+  output[0] = (char)(0xF0 | (code >> 18));
+  output[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+  output[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+  output[3] = (char)(0x80 | (code & 0x3F));
+  return 4;
 }
 
-bool json_skip_entry(typed(json_string) * str_ptr) {
-  json_skip_string(str_ptr);
+bool json_index_build(typed(json_parser) * parser, typed(json_index) * index,
+                      typed(json_string) str, typed(size) len) {
+  // Positions are 32-bit to keep the index small
+  if (len > UINT32_MAX)
+    return false;
 
-  json_skip_whitespace(str_ptr);
+  index->begin = str;
+  index->count = 0;
+  index->capacity = len / 4 + 64;
+  index->positions = allocN(typed(uint32), index->capacity);
+  index->sizes = allocN(typed(uint32), index->capacity);
+  index->next = 0;
 
-  // Skip the ':' delimiter
-  (*str_ptr)++;
+  typed(uint64) escape_carry = 0;
+  typed(uint64) in_string = 0;
+  // Whether the string still open at the end of the last block has a
+  // backslash in it
+  typed(uint32) escaped = 0;
 
-  json_skip_whitespace(str_ptr);
+  for (typed(size) offset = 0; offset < len; offset += 64) {
+    typed(json_block_masks) masks;
 
-  result(json_element_type) type_result = json_guess_element_type(*str_ptr);
-  if (result_is_err(json_element_type)(&type_result))
-    return false;
+    if (len - offset >= 64) {
+      json_classify_block(str + offset, &masks);
+    } else {
+      // Pad the last block with spaces, which are never structural
+      char block[64];
+      memset(block, ' ', sizeof(block));
+      memcpy(block, str + offset, len - offset);
+      json_classify_block(block, &masks);
+    }
 
-  typed(json_element_type) type =
-      result_unwrap(json_element_type)(&type_result);
+    typed(uint64) quote =
+        masks.quote & ~json_block_escaped(masks.backslash, &escape_carry);
+
+    // Both quotes of a string are kept, along with the operators that
+    // are outside of any string
+    typed(uint64) inside = json_prefix_xor(quote) ^ in_string;
+    typed(uint64) structural = (masks.operators & ~inside) | quote;
+    typed(uint64) closing = quote & ~inside;
+    typed(uint64) backslashes = masks.backslash & inside;
+    in_string = (typed(uint64))((int64_t)inside >> 63);
+
+    if (index->capacity - index->count < 64) {
+      index->capacity *= 2;
+      index->positions =
+          reallocN(index->positions, typed(uint32), index->capacity);
+      index->sizes = reallocN(index->sizes, typed(uint32), index->capacity);
+    }
 
-  return json_skip_element_value(str_ptr, type);
-}
+    while (structural != 0) {
+      int bit = json_ctz64(structural);
+      index->positions[index->count] = (typed(uint32))(offset + bit);
+
+      // Flag the closing quote of a string with backslashes, so that
+      // strings without any need not be scanned for them again
+      if ((closing >> bit) & 1) {
+        typed(uint64) before = (1ULL << bit) - 1;
+        index->sizes[index->count] = escaped | ((backslashes & before) != 0);
+        backslashes &= ~before;
+        escaped = 0;
+      }
 
-bool json_skip_element_value(typed(json_string) * str_ptr,
-                             typed(json_element_type) type) {
-  switch (type) {
-  case JSON_ELEMENT_TYPE_STRING:
-    return json_skip_string(str_ptr);
-  case JSON_ELEMENT_TYPE_NUMBER:
-    return json_skip_number(str_ptr);
-  case JSON_ELEMENT_TYPE_OBJECT:
-    return json_skip_object(str_ptr);
-  case JSON_ELEMENT_TYPE_ARRAY:
-    return json_skip_array(str_ptr);
-  case JSON_ELEMENT_TYPE_BOOLEAN:
-    return json_skip_boolean(str_ptr);
-  case JSON_ELEMENT_TYPE_NULL:
-    json_skip_null(str_ptr);
-    return false;
+      index->count++;
+      structural &= structural - 1;
+    }
 
-  default:
+    // What is left belongs to a string going on in the next block
+    escaped |= backslashes != 0;
+  }
+
+  // An unterminated string leaves nothing sensible to index
+  if (in_string != 0 || !json_index_measure(parser, index)) {
+    json_index_free(index);
     return false;
   }
-}
 
-bool json_skip_string(typed(json_string) * str_ptr) {
-  // Skip the initial '"'
-  (*str_ptr)++;
+  return true;
+}
 
-  // Find the length till the last '"'
-  typed(size) len = json_string_len(*str_ptr);
+bool json_index_measure(typed(json_parser) * parser,
+                        typed(json_index) * index) {
+  // The scratch stack holds the open containers
+  typed(size) mark = parser->stack_size;
+  bool balanced = true;
+
+  for (typed(size) i = 0; i < index->count && balanced; i++) {
+    char ch = index->begin[index->positions[i]];
+    typed(size) depth = (parser->stack_size - mark) / sizeof(typed(size));
+    typed(size) *top =
+        depth > 0 ? parser_stack_at(parser, typed(size), parser->stack_size) - 1
+                  : NULL;
+
+    switch (ch) {
+    case '"':
+      // Skip the closing quote
+      i++;
+      break;
+    case '{':
+    case '[':
+      *parser_stack_push(parser, typed(size)) = i;
+      index->sizes[i] = 1;
+      break;
+    case ',':
+      if (depth > 0)
+        index->sizes[*top]++;
+      break;
+    case '}':
+    case ']':
+      // '{' and '[' are two below their closing counterparts
+      if (depth == 0 || index->begin[index->positions[*top]] != ch - 2) {
+        balanced = false;
+        break;
+      }
 
-  // Skip till the end of the string
-  (*str_ptr) += len + 1;
+      // A container holding nothing but whitespace is empty
+      if (*top == i - 1) {
+        typed(json_string) inner = index->begin + index->positions[*top] + 1;
+        typed(json_string) close = index->begin + index->positions[i];
+        while (inner < close && is_whitespace(*inner))
+          inner++;
 
-  return len > 0;
-}
+        if (inner == close)
+          index->sizes[*top] = 0;
+      }
 
-bool json_skip_number(typed(json_string) * str_ptr) {
-  while (json_is_number(**str_ptr)) {
-    (*str_ptr)++;
+      parser->stack_size -= sizeof(typed(size));
+      break;
+    }
   }
 
-  return true;
+  balanced = balanced && parser->stack_size == mark;
+  parser->stack_size = mark;
+
+  return balanced;
 }
 
-bool json_skip_object(typed(json_string) * str_ptr) {
-  // Skip the first '{' character
-  (*str_ptr)++;
+void json_index_free(typed(json_index) * index) {
+  free(index->positions);
+  free(index->sizes);
+  index->positions = NULL;
+  index->sizes = NULL;
+}
 
-  json_skip_whitespace(str_ptr);
+void json_index_skip_item(typed(json_index) * index) {
+  typed(size) depth = 0;
 
-  if (**str_ptr == '}') {
-    // Skip the end '}'
-    (*str_ptr)++;
-    return false;
-  }
+  for (;;) {
+    switch (index->begin[index->positions[index->next]]) {
+    case '"':
+      index->next++;
+      break;
+    case '{':
+    case '[':
+      depth++;
+      break;
+    case '}':
+    case ']':
+      if (depth == 0)
+        return;
+      depth--;
+      break;
+    case ',':
+      if (depth == 0)
+        return;
+      break;
+    }
 
-  while (**str_ptr != '\0') {
-    // Skip any accidental whitespace
-    json_skip_whitespace(str_ptr);
+    index->next++;
+  }
+}
 
-    json_skip_entry(str_ptr);
+typed(uint64) json_block_escaped(typed(uint64) backslash,
+                                 typed(uint64) * carry) {
+  const typed(uint64) even_bits = 0x5555555555555555ULL;
 
-    // Skip any accidental whitespace
-    json_skip_whitespace(str_ptr);
+  // A backslash escaped from the previous block escapes nothing itself
+  backslash &= ~*carry;
+  typed(uint64) follows_escape = (backslash << 1) | *carry;
 
-    if (**str_ptr == '}')
-      break;
+  // Runs of backslashes starting on an odd bit are found by adding
+  // their first bit, which carries out at the end of the run
+  typed(uint64) odd_starts = backslash & ~even_bits & ~follows_escape;
+  typed(uint64) even_runs = odd_starts + backslash;
+  *carry = even_runs < backslash;
 
-    // Skip the ',' to move to the next entry
-    (*str_ptr)++;
-  }
+  // Every other character after the start of a run is escaped,
+  // counting from whether the run starts on an odd or even bit
+  return (even_bits ^ (even_runs << 1)) & follows_escape;
+}
 
-  // Skip the '}' closing brace
-  (*str_ptr)++;
+typed(uint64) json_prefix_xor(typed(uint64) bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
 
-  return true;
+  return bits;
 }
 
-bool json_skip_array(typed(json_string) * str_ptr) {
-  // Skip the starting '[' character
-  (*str_ptr)++;
+int json_ctz64(typed(uint64) bits) {
+#ifdef __GNUC__
+  return __builtin_ctzll(bits);
+#else
+  // Isolate the lowest set bit, whose product with a de Bruijn sequence
+  // has a distinct top 6 bits for every position
+  static const unsigned char positions[64] = {
+      0,  1,  48, 2,  57, 49, 28, 3,  61, 58, 50, 42, 38, 29, 17, 4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9,  13, 8,  7,  6};
+  return positions[((bits & (0 - bits)) * 0x03F79D71B4CB0A89ULL) >> 58];
+#endif
+}
 
-  json_skip_whitespace(str_ptr);
+/**
+ * @brief Marks every zero byte of a 64-bit word with its top bit. Only
+ * the lowest mark is exact, which is the only one ever used
+ */
+#define json_swar_zero(word)                                                   \
+  (((word)-0x0101010101010101ULL) & ~(word)&0x8080808080808080ULL)
 
-  // Unfortunately the array is empty
-  if (**str_ptr == ']') {
-    // Skip the end ']'
-    (*str_ptr)++;
-    return false;
+/**
+ * @brief Every byte of a 64-bit word set to `ch`
+ */
+#define json_swar_repeat(ch) (0x0101010101010101ULL * (typed(uint8))(ch))
+
+typed(json_string) json_scan_string_scalar(typed(json_string) str,
+                                           typed(json_string) end) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - str >= 8) {
+    typed(uint64) word;
+    memcpy(&word, str, 8);
+
+    typed(uint64) found = json_swar_zero(word ^ json_swar_repeat('"')) |
+                          json_swar_zero(word ^ json_swar_repeat('\\'));
+    if (found != 0)
+      return str + (__builtin_ctzll(found) >> 3);
+
+    str += 8;
   }
+#endif
 
-  while (**str_ptr != '\0') {
-    json_skip_whitespace(str_ptr);
-
-    // Guess the type
-    result(json_element_type) type_result = json_guess_element_type(*str_ptr);
-    if (result_is_ok(json_element_type)(&type_result)) {
-      typed(json_element_type) type =
-          result_unwrap(json_element_type)(&type_result);
+  while (str < end && *str != '"' && *str != '\\')
+    str++;
 
-      // Parse the value based on guessed type
-      json_skip_element_value(str_ptr, type);
+  return str;
+}
 
-      json_skip_whitespace(str_ptr);
-    }
+#ifdef JSON_SIMD_X86
+typed(json_string) json_scan_string_sse2(typed(json_string) str,
+                                         typed(json_string) end) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i escape = _mm_set1_epi8('\\');
 
-    // Reached the end
-    if (**str_ptr == ']')
-      break;
+  while (end - str >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)str);
+    int found = _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape)));
+    if (found != 0)
+      return str + __builtin_ctz(found);
 
-    // Skip the ','
-    (*str_ptr)++;
+    str += 16;
   }
 
-  // Skip the ']' closing array
-  (*str_ptr)++;
-
-  return true;
+  return json_scan_string_scalar(str, end);
 }
 
-bool json_skip_boolean(typed(json_string) * str_ptr) {
-  switch (**str_ptr) {
-  case 't':
-    (*str_ptr) += 4;
-    return true;
+__attribute__((target("avx2"))) typed(json_string)
+    json_scan_string_avx2(typed(json_string) str, typed(json_string) end) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i escape = _mm256_set1_epi8('\\');
 
-  case 'f':
-    (*str_ptr) += 5;
-    return true;
+  while (end - str >= 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)str);
+    unsigned found = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, escape)));
+    if (found != 0)
+      return str + __builtin_ctz(found);
+
+    str += 32;
   }
 
-  return false;
+  return json_scan_string_sse2(str, end);
 }
+#endif
 
-void json_skip_null(typed(json_string) * str_ptr) { (*str_ptr) += 4; }
+/**
+ * @brief Marks every byte of a 64-bit word below `n`, at most 128, with
+ * its top bit. Only the lowest mark is exact, which is the only one ever
+ * used
+ */
+#define json_swar_less(word, n)                                                \
+  (((word)-json_swar_repeat(n)) & ~(word)&0x8080808080808080ULL)
+
+typed(json_string) json_scan_escape_scalar(typed(json_string) str,
+                                           typed(json_string) end) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - str >= 8) {
+    typed(uint64) word;
+    memcpy(&word, str, 8);
+
+    typed(uint64) found = json_swar_zero(word ^ json_swar_repeat('"')) |
+                          json_swar_zero(word ^ json_swar_repeat('\\')) |
+                          json_swar_less(word, 0x20);
+    if (found != 0)
+      return str + (__builtin_ctzll(found) >> 3);
+
+    str += 8;
+  }
+#endif
 
-void json_print(typed(json_element) * element, int indent) {
-  json_print_element(element, indent, 0);
-}
+  while (str < end && *str != '"' && *str != '\\' &&
+         (unsigned char)*str >= 0x20)
+    str++;
 
-void json_print_element(typed(json_element) * element, int indent,
-                        int indent_level) {
+  return str;
+}
 
-  switch (element->type) {
-  case JSON_ELEMENT_TYPE_STRING:
-    json_print_string(element->value.as_string);
-    break;
-  case JSON_ELEMENT_TYPE_NUMBER:
-    json_print_number(element->value.as_number);
-    break;
-  case JSON_ELEMENT_TYPE_OBJECT:
-    json_print_object(element->value.as_object, indent, indent_level);
-    break;
-  case JSON_ELEMENT_TYPE_ARRAY:
-    json_print_array(element->value.as_array, indent, indent_level);
-    break;
-  case JSON_ELEMENT_TYPE_BOOLEAN:
-    json_print_boolean(element->value.as_boolean);
-    break;
-  case JSON_ELEMENT_TYPE_NULL:
-    break;
-    // Do nothing
+#ifdef JSON_SIMD_X86
+typed(json_string) json_scan_escape_sse2(typed(json_string) str,
+                                         typed(json_string) end) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i escape = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+
+  while (end - str >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)str);
+    // Only characters up to 0x1F are left as they are by the maximum
+    __m128i controls = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control);
+    int found = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                  _mm_cmpeq_epi8(chunk, escape)),
+                     controls));
+    if (found != 0)
+      return str + __builtin_ctz(found);
+
+    str += 16;
   }
+
+  return json_scan_escape_scalar(str, end);
 }
 
-void json_print_string(typed(json_string) string) { printf("\"%s\"", string); }
+__attribute__((target("avx2"))) typed(json_string)
+    json_scan_escape_avx2(typed(json_string) str, typed(json_string) end) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i escape = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+
+  while (end - str >= 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)str);
+    __m256i controls =
+        _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control);
+    unsigned found = (unsigned)_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                        _mm256_cmpeq_epi8(chunk, escape)),
+                        controls));
+    if (found != 0)
+      return str + __builtin_ctz(found);
+
+    str += 32;
+  }
 
-void json_print_number(typed(json_number) number) {
-  switch (number.type) {
-  case JSON_NUMBER_TYPE_DOUBLE:
-    printf("%f", number.value.as_double);
-    break;
+  return json_scan_escape_sse2(str, end);
+}
+#endif
 
-  case JSON_NUMBER_TYPE_LONG:
-    printf("%ld", number.value.as_long);
-    break;
+/**
+ * @brief Marks every zero byte of a 64-bit word with its top bit, with
+ * no false marks above the lowest one
+ */
+#define json_swar_zero_exact(word)                                             \
+  (~((((word)&0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | (word) |     \
+     0x7F7F7F7F7F7F7F7FULL))
+
+typed(json_string) json_scan_whitespace_scalar(typed(json_string) str,
+                                               typed(json_string) end) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) &&                           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - str >= 8) {
+    typed(uint64) word;
+    memcpy(&word, str, 8);
+
+    typed(uint64) space = json_swar_zero_exact(word ^ json_swar_repeat(' ')) |
+                          json_swar_zero_exact(word ^ json_swar_repeat('\n')) |
+                          json_swar_zero_exact(word ^ json_swar_repeat('\r')) |
+                          json_swar_zero_exact(word ^ json_swar_repeat('\t'));
+    typed(uint64) found = ~space & 0x8080808080808080ULL;
+    if (found != 0)
+      return str + (__builtin_ctzll(found) >> 3);
+
+    str += 8;
   }
-}
+#endif
 
-void json_print_object(typed(json_object) * object, int indent,
-                       int indent_level) {
-  printf("{\n");
+  while (str < end && is_whitespace(*str))
+    str++;
 
-  for (size_t i = 0; i < object->count; i++) {
-    for (int j = 0; j < indent * (indent_level + 1); j++)
-      printf(" ");
+  return str;
+}
 
-    typed(json_entry) *entry = object->entries[i];
+#ifdef JSON_SIMD_X86
+typed(json_string) json_scan_whitespace_sse2(typed(json_string) str,
+                                             typed(json_string) end) {
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i carriage = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+
+  while (end - str >= 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)str);
+    __m128i matches = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                     _mm_cmpeq_epi8(chunk, newline)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage),
+                     _mm_cmpeq_epi8(chunk, tab)));
+    int found = ~_mm_movemask_epi8(matches) & 0xFFFF;
+    if (found != 0)
+      return str + __builtin_ctz(found);
+
+    str += 16;
+  }
 
-    json_print_string(entry->key);
-    printf(": ");
-    json_print_element(&entry->element, indent, indent_level + 1);
+  return json_scan_whitespace_scalar(str, end);
+}
 
-    if (i != object->count - 1)
-      printf(",");
-    printf("\n");
+__attribute__((target("avx2"))) typed(json_string)
+    json_scan_whitespace_avx2(typed(json_string) str, typed(json_string) end) {
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i carriage = _mm256_set1_epi8('\r');
+  const __m256i tab = _mm256_set1_epi8('\t');
+
+  while (end - str >= 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)str);
+    __m256i matches = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),
+                        _mm256_cmpeq_epi8(chunk, newline)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, carriage),
+                        _mm256_cmpeq_epi8(chunk, tab)));
+    unsigned found = ~(unsigned)_mm256_movemask_epi8(matches);
+    if (found != 0)
+      return str + __builtin_ctz(found);
+
+    str += 32;
   }
 
-  for (int j = 0; j < indent * indent_level; j++)
-    printf(" ");
-  printf("}");
+  return json_scan_whitespace_sse2(str, end);
 }
+#endif
 
-void json_print_array(typed(json_array) * array, int indent, int indent_level) {
-  printf("[\n");
+#ifndef JSON_SIMD_X86
+void json_classify_block_scalar(typed(json_string) block,
+                                typed(json_block_masks) * masks) {
+  masks->quote = 0;
+  masks->backslash = 0;
+  masks->operators = 0;
 
-  for (size_t i = 0; i < array->count; i++) {
-    typed(json_element) element = array->elements[i];
-    for (int j = 0; j < indent * (indent_level + 1); j++)
-      printf(" ");
-    json_print_element(&element, indent, indent_level + 1);
+  for (int i = 0; i < 64; i++) {
+    typed(uint64) bit = 1ULL << i;
 
-    if (i != array->count - 1)
-      printf(",");
-    printf("\n");
+    switch (block[i]) {
+    case '"':
+      masks->quote |= bit;
+      break;
+    case '\\':
+      masks->backslash |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      masks->operators |= bit;
+      break;
+    }
   }
+}
+#else
+void json_classify_block_sse2(typed(json_string) block,
+                              typed(json_block_masks) * masks) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i lower = _mm_set1_epi8(0x20);
+  const __m128i open = _mm_set1_epi8('{');
+  const __m128i close = _mm_set1_epi8('}');
+  const __m128i colon = _mm_set1_epi8(':');
+  const __m128i comma = _mm_set1_epi8(',');
+
+  masks->quote = 0;
+  masks->backslash = 0;
+  masks->operators = 0;
+
+  for (int i = 0; i < 64; i += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i *)(block + i));
+
+    // '[' and ']' are '{' and '}' without the 0x20 bit
+    __m128i folded = _mm_or_si128(chunk, lower);
+    __m128i operators = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                     _mm_cmpeq_epi8(folded, close)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, colon),
+                     _mm_cmpeq_epi8(chunk, comma)));
+
+    masks->quote |=
+        (typed(uint64))(unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(chunk, quote))
+        << i;
+    masks->backslash |=
+        (typed(uint64))(unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(chunk, backslash))
+        << i;
+    masks->operators |= (typed(uint64))(unsigned)_mm_movemask_epi8(operators)
+                        << i;
+  }
+}
 
-  for (int i = 0; i < indent * indent_level; i++)
-    printf(" ");
-  printf("]");
+__attribute__((target("avx2"))) void
+json_classify_block_avx2(typed(json_string) block,
+                         typed(json_block_masks) * masks) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i lower = _mm256_set1_epi8(0x20);
+  const __m256i open = _mm256_set1_epi8('{');
+  const __m256i close = _mm256_set1_epi8('}');
+  const __m256i colon = _mm256_set1_epi8(':');
+  const __m256i comma = _mm256_set1_epi8(',');
+
+  masks->quote = 0;
+  masks->backslash = 0;
+  masks->operators = 0;
+
+  for (int i = 0; i < 64; i += 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i *)(block + i));
+
+    // '[' and ']' are '{' and '}' without the 0x20 bit
+    __m256i folded = _mm256_or_si256(chunk, lower);
+    __m256i operators = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(folded, open),
+                        _mm256_cmpeq_epi8(folded, close)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, colon),
+                        _mm256_cmpeq_epi8(chunk, comma)));
+
+    masks->quote |= (typed(uint64))(unsigned)_mm256_movemask_epi8(
+                        _mm256_cmpeq_epi8(chunk, quote))
+                    << i;
+    masks->backslash |= (typed(uint64))(unsigned)_mm256_movemask_epi8(
+                            _mm256_cmpeq_epi8(chunk, backslash))
+                        << i;
+    masks->operators |=
+        (typed(uint64))(unsigned)_mm256_movemask_epi8(operators) << i;
+  }
 }
+#endif
 
-void json_print_boolean(typed(json_boolean) boolean) {
-  printf("%s", boolean ? "true" : "false");
+void json_kernels_resolve(void) {
+  // Every thread resolves to the same kernels, so racing here is benign
+#ifdef JSON_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    json_scan_string = json_scan_string_avx2;
+    json_scan_escape = json_scan_escape_avx2;
+    json_scan_whitespace = json_scan_whitespace_avx2;
+    json_classify_block = json_classify_block_avx2;
+  } else {
+    json_scan_string = json_scan_string_sse2;
+    json_scan_escape = json_scan_escape_sse2;
+    json_scan_whitespace = json_scan_whitespace_sse2;
+    json_classify_block = json_classify_block_sse2;
+  }
+#else
+  json_scan_string = json_scan_string_scalar;
+  json_scan_escape = json_scan_escape_scalar;
+  json_scan_whitespace = json_scan_whitespace_scalar;
+  json_classify_block = json_classify_block_scalar;
+#endif
 }
 
-void json_free(typed(json_element) * element) {
-  switch (element->type) {
-  case JSON_ELEMENT_TYPE_STRING:
-    json_free_string(element->value.as_string);
-    break;
+typed(json_string) json_scan_string_resolve(typed(json_string) str,
+                                            typed(json_string) end) {
+  json_kernels_resolve();
+  return json_scan_string(str, end);
+}
 
-  case JSON_ELEMENT_TYPE_OBJECT:
-    json_free_object(element->value.as_object);
-    break;
+typed(json_string) json_scan_escape_resolve(typed(json_string) str,
+                                            typed(json_string) end) {
+  json_kernels_resolve();
+  return json_scan_escape(str, end);
+}
 
-  case JSON_ELEMENT_TYPE_ARRAY:
-    json_free_array(element->value.as_array);
-    break;
+typed(json_string) json_scan_whitespace_resolve(typed(json_string) str,
+                                                typed(json_string) end) {
+  json_kernels_resolve();
+  return json_scan_whitespace(str, end);
+}
 
-  case JSON_ELEMENT_TYPE_NUMBER:
-  case JSON_ELEMENT_TYPE_BOOLEAN:
-  case JSON_ELEMENT_TYPE_NULL:
-    // Do nothing
-    break;
-  }
+void json_classify_block_resolve(typed(json_string) block,
+                                 typed(json_block_masks) * masks) {
+  json_kernels_resolve();
+  json_classify_block(block, masks);
 }
 
-void json_free_string(typed(json_string) string) { free((void *)string); }
+typed(json_arena) * json_arena_new(typed(size) size_hint) {
+  // Reserve the first block up front so that most documents never need
+  // a second one
+  typed(size) capacity = json_arena_align(size_hint);
+  if (capacity < JSON_ARENA_MIN_BLOCK_SIZE)
+    capacity = JSON_ARENA_MIN_BLOCK_SIZE;
 
-void json_free_object(typed(json_object) * object) {
-  if (object == NULL)
-    return;
+  typed(json_arena_block) *block = (typed(json_arena_block) *)malloc(
+      JSON_ARENA_BLOCK_HEADER_SIZE + capacity);
+  block->next = NULL;
+  block->capacity = capacity;
+  block->used = 0;
 
-  if (object->count == 0) {
-    free(object);
-    return;
-  }
+  typed(json_arena) *arena = alloc(typed(json_arena));
+  arena->head = block;
 
-  for (size_t i = 0; i < object->count; i++) {
-    typed(json_entry) *entry = object->entries[i];
+  return arena;
+}
 
-    if (entry != NULL) {
-      free((void *)entry->key);
-      json_free(&entry->element);
-      free(entry);
-    }
+void *json_arena_alloc(typed(json_arena) * arena, typed(size) size) {
+  typed(json_arena_block) *block = arena->head;
+  size = json_arena_align(size);
+
+  if (block->capacity - block->used < size) {
+    // Double the block size every time so that a document needs only
+    // a logarithmic number of blocks
+    typed(size) capacity = block->capacity * 2;
+    if (capacity < size)
+      capacity = size;
+
+    typed(json_arena_block) *next = (typed(json_arena_block) *)malloc(
+        JSON_ARENA_BLOCK_HEADER_SIZE + capacity);
+    next->next = block;
+    next->capacity = capacity;
+    next->used = 0;
+    arena->head = block = next;
   }
 
-  free(object->entries);
-  free(object);
-}
+  char *ptr = (char *)block + JSON_ARENA_BLOCK_HEADER_SIZE + block->used;
+  block->used += size;
 
-void json_free_array(typed(json_array) * array) {
-  if (array == NULL)
-    return;
+  return ptr;
+}
 
-  if (array->count == 0) {
-    free(array);
+void json_arena_free(typed(json_arena) * arena) {
+  if (arena == NULL)
     return;
-  }
 
-  // Recursively free each element in the array
-  for (size_t i = 0; i < array->count; i++) {
-    typed(json_element) element = array->elements[i];
-    json_free(&element);
+  typed(json_arena_block) *block = arena->head;
+  while (block != NULL) {
+    typed(json_arena_block) *next = block->next;
+    free(block);
+    block = next;
   }
 
-  // Lastly free
-  free(array->elements);
-  free(array);
+  free(arena);
 }
 
-typed(json_string) json_error_to_string(typed(json_error) error) {
-  switch (error) {
-  case JSON_ERROR_EMPTY:
-    return "Empty";
-  case JSON_ERROR_INVALID_KEY:
-    return "Invalid key";
-  case JSON_ERROR_INVALID_TYPE:
-    return "Invalid type";
-  case JSON_ERROR_INVALID_VALUE:
-    return "Invalid value";
+void json_arena_adopt(typed(json_arena) * arena, typed(json_arena) * other) {
+  // Allocations go on in the head block of `arena`, so the blocks of
+  // `other` go at the end of its chain
+  typed(json_arena_block) *tail = arena->head;
+  while (tail->next != NULL)
+    tail = tail->next;
 
-  default:
-    return "Unknown error";
-  }
+  tail->next = other->head;
+  free(other);
 }
 
-typed(size) json_string_len(typed(json_string) str) {
-  typed(size) len = 0;
-
-  typed(json_string) iter = str;
-  while (*iter != '\0') {
-    if (*iter == '\\')
-      iter += 2;
-
-    if (*iter == '"') {
-      len = iter - str;
-      break;
-    }
-
-    iter++;
-  }
+void *json_parser_alloc(typed(json_parser) * parser, typed(size) size) {
+  if (parser->arena != NULL)
+    return json_arena_alloc(parser->arena, size);
 
-  return len;
+  return malloc(size);
 }
 
-result(json_string)
-    json_unescape_string(typed(json_string) str, typed(size) len) {
-  typed(size) count = 0;
-  typed(json_string) iter = str;
+void *json_parser_stack_push(typed(json_parser) * parser, typed(size) size) {
+  // Keep every item aligned like an arena allocation
+  size = json_arena_align(size);
 
-  while ((size_t)(iter - str) < len) {
-    if (*iter == '\\')
-      iter++;
+  if (parser->stack_capacity - parser->stack_size < size) {
+    typed(size) capacity = parser->stack_capacity == 0
+                               ? JSON_STACK_INITIAL_CAPACITY
+                               : parser->stack_capacity * 2;
+    while (capacity - parser->stack_size < size)
+      capacity *= 2;
 
-    count++;
-    iter++;
+    parser->stack = reallocN(parser->stack, char, capacity);
+    parser->stack_capacity = capacity;
   }
 
-  char *output = allocN(char, count + 1);
-  typed(size) offset = 0;
-  iter = str;
-
-  while ((size_t)(iter - str) < len) {
-    if (*iter == '\\') {
-      iter++;
-
-      switch (*iter) {
-      case 'b':
-        output[offset] = '\b';
-        break;
-      case 'f':
-        output[offset] = '\f';
-        break;
-      case 'n':
-        output[offset] = '\n';
-        break;
-      case 'r':
-        output[offset] = '\r';
-        break;
-      case 't':
-        output[offset] = '\t';
-        break;
-      case '"':
-        output[offset] = '"';
-        break;
-      case '\\':
-        output[offset] = '\\';
-        break;
-      default:
-        return result_err(json_string)(JSON_ERROR_INVALID_VALUE);
-      }
-    } else {
-      output[offset] = *iter;
-    }
+  void *ptr = parser->stack + parser->stack_size;
+  parser->stack_size += size;
 
-    offset++;
-    iter++;
-  }
+  return ptr;
+}
 
-  output[offset] = '\0';
-  return result_ok(json_string)((typed(json_string))output);
+void json_parser_free(typed(json_parser) * parser, void *ptr) {
+  // Arena memory is only ever released along with the whole document
+  if (parser->arena == NULL)
+    free(ptr);
 }
 
 define_result_type(json_element_type)
@@ -1101,4 +7829,12 @@ define_result_type(json_element)
 define_result_type(json_entry)
 define_result_type(json_string)
 define_result_type(size)
+define_result_type(json_document)
+define_result_type(json_path)
+define_result_type(json_string_view)
+define_result_type(json_number)
+define_result_type(json_boolean)
+define_result_type(json_tape)
+define_result_type(json_tape_value)
+define_result_type(json_lines)
 
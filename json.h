@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifndef __cplusplus
 typedef unsigned int bool;
@@ -10,7 +11,18 @@ typedef unsigned int bool;
 
 #define typed(name) name##_t
 
+/**
+ * @brief Functions defined in this header, so that C++ can evaluate them
+ * at compile time
+ */
+#if defined(__cplusplus) && __cplusplus >= 201402L
+#define JSON_CONSTEXPR constexpr
+#else
+#define JSON_CONSTEXPR static inline
+#endif
+
 typedef const char *typed(json_string);
+typedef struct json_string_view_s typed(json_string_view);
 typedef bool typed(json_boolean);
 
 typedef union json_number_value_u typed(json_number_value);
@@ -21,7 +33,23 @@ typedef union json_element_value_u typed(json_element_value);
 typedef struct json_element_s typed(json_element);
 typedef struct json_entry_s typed(json_entry);
 typedef struct json_object_s typed(json_object);
+typedef struct json_shape_s typed(json_shape);
+typedef struct json_shape_slot_s typed(json_shape_slot);
+typedef struct json_key_s typed(json_key);
+typedef struct json_path_segment_s typed(json_path_segment);
+typedef struct json_path_s typed(json_path);
+typedef struct json_cursor_s typed(json_cursor);
+typedef struct json_callbacks_s typed(json_callbacks);
+typedef struct json_push_parser_s typed(json_push_parser);
+typedef struct json_lines_s typed(json_lines);
+typedef struct json_sink_s typed(json_sink);
+typedef struct json_writer_s typed(json_writer);
 typedef struct json_array_s typed(json_array);
+typedef struct json_arena_s typed(json_arena);
+typedef struct json_document_s typed(json_document);
+typedef struct json_tape_s typed(json_tape);
+typedef struct json_tape_value_s typed(json_tape_value);
+typedef struct json_parse_options_s typed(json_parse_options);
 
 #define result(name) name##_result_t
 #define result_ok(name) name##_result_ok
@@ -76,8 +104,20 @@ struct json_number_s {
   typed(json_number_value) value;
 };
 
+/**
+ * @brief The characters of a string along with their number, which need
+ * not be followed by a NUL
+ */
+struct json_string_view_s {
+  typed(json_string) data;
+  typed(size) len;
+};
+
 union json_element_value_u {
+  // NUL-terminated, unless the document was parsed with string views
   typed(json_string) as_string;
+  // Valid for every string, `data` is the same pointer as `as_string`
+  typed(json_string_view) as_view;
   typed(json_number) as_number;
   typed(json_object) * as_object;
   typed(json_array) * as_array;
@@ -90,13 +130,77 @@ struct json_element_s {
 };
 
 struct json_entry_s {
+  // NUL-terminated, unless the document was parsed with string views
   typed(json_string) key;
+  typed(size) key_len;
   typed(json_element) element;
 };
 
+/**
+ * @brief The keys of an object along with their hash index. Objects
+ * with the same keys in the same order may share a single shape
+ */
+struct json_shape_s {
+  typed(size) count;
+  // The keys in the order of the input
+  typed(json_string_view) * keys;
+  // The opaque hash index of the keys, a power of two number of slots
+  // of which always more than `count`
+  typed(size) capacity;
+  typed(json_shape_slot) * slots;
+};
+
 struct json_object_s {
   typed(size) count;
-  typed(json_entry) * *entries;
+  // The keys, allocated along with the object unless it is shared
+  typed(json_shape) * shape;
+  // The value of every key of the shape, in the same order
+  typed(json_element) * values;
+};
+
+/**
+ * @brief A key along with its length and hash, made once with
+ * `json_key_make` to be looked up many times
+ */
+struct json_key_s {
+  typed(json_string) data;
+  typed(size) len;
+  typed(uint64) hash;
+};
+
+/**
+ * @brief A reference token of a compiled path {json_path_t}, naming the
+ * member of an object or, when it is a number, the element of an array
+ */
+struct json_path_segment_s {
+  // Unescaped and NUL-terminated
+  typed(json_string) key;
+  typed(size) key_len;
+  // The position of the element of an array, `SIZE_MAX` if the token is
+  // not a number
+  typed(size) index;
+};
+
+/**
+ * @brief A JSON Pointer compiled once by `json_path_compile`, to be
+ * looked up in any number of inputs
+ */
+struct json_path_s {
+  typed(size) count;
+  typed(json_path_segment) * segments;
+};
+
+/**
+ * @brief A position in a JSON buffer from which values are read one at a
+ * time, without making any element {json_element_t} or allocating any
+ * memory
+ */
+struct json_cursor_s {
+  // The next character to read
+  typed(json_string) position;
+  // One past the last character of the input
+  typed(json_string) end;
+  typed(json_boolean) skip_whitespace;
 };
 
 struct json_array_s {
@@ -104,19 +208,269 @@ struct json_array_s {
   typed(json_element) * elements;
 };
 
+struct json_document_s {
+  typed(json_element) root;
+  typed(json_arena) * arena;
+};
+
+/**
+ * @brief The tag in the top byte of every word of a tape {json_tape_t}
+ */
+typedef enum json_tape_tag_e {
+  // The rest of the word holds the position one past the matching end in
+  // its low 40 bits, and the number of items up to 0xFFFF above them
+  JSON_TAPE_TAG_OBJECT = '{',
+  JSON_TAPE_TAG_ARRAY = '[',
+  // The rest of the word holds the position of the matching start
+  JSON_TAPE_TAG_OBJECT_END = '}',
+  JSON_TAPE_TAG_ARRAY_END = ']',
+  // The rest of the word holds the offset of the characters in `strings`
+  JSON_TAPE_TAG_KEY = 'k',
+  JSON_TAPE_TAG_STRING = '"',
+  // The value is the whole next word
+  JSON_TAPE_TAG_LONG = 'l',
+  JSON_TAPE_TAG_DOUBLE = 'd',
+  JSON_TAPE_TAG_TRUE = 't',
+  JSON_TAPE_TAG_FALSE = 'f',
+} typed(json_tape_tag);
+
+/**
+ * @brief A read-only document laid out as a single tape of 8-byte words
+ * in the order of the input, along with the characters of its strings.
+ * An object is its start, each key followed by its value, and its end,
+ * and likewise for an array. The start of a container tells where it
+ * ends, so it is skipped in one step. Holds the same values as the tree
+ * `json_parse` makes
+ */
+struct json_tape_s {
+  typed(uint64) * words;
+  typed(size) count;
+  // Every string and key, each after its length as 4 bytes and followed
+  // by a NUL
+  char *strings;
+  typed(size) strings_len;
+};
+
+/**
+ * @brief A value on a tape {json_tape_t}, or a key while iterating an
+ * object
+ */
+struct json_tape_value_s {
+  const typed(json_tape) * tape;
+  // The position of its first word
+  typed(size) index;
+};
+
+/**
+ * @brief Options of a single parse. A zero-initialized struct asks for
+ * minified JSON
+ */
+struct json_parse_options_s {
+  // Skip whitespace between tokens and around the root element, as
+  // found in pretty-printed JSON
+  typed(json_boolean) skip_whitespace;
+  // Index every structural character of the input in a vectorized pass
+  // before parsing, so that containers are allocated once at their
+  // final size. Input with unbalanced brackets is parsed without it
+  typed(json_boolean) structural_index;
+  // Leave strings and keys without escapes in the input instead of
+  // copying them. Such strings are not NUL-terminated, so they must be
+  // read through `as_view` and `key_len`. Only documents hold views and
+  // their input has to outlive them
+  typed(json_boolean) string_views;
+  // Share a single copy of every distinct key among all objects of the
+  // document, so that keys repeated across records are stored once and
+  // compare by pointer. Only documents intern keys
+  typed(json_boolean) intern_keys;
+  // Let objects with the same keys in the same order share a single
+  // shape {json_shape_t} and store only their values, as records of an
+  // array do. Implies `intern_keys`. Only documents share shapes
+  typed(json_boolean) share_shapes;
+  // How deep objects and arrays may nest, the root being at depth 1.
+  // Deeper input fails with a {JSON_ERROR_TOO_DEEP} error. 0 means the
+  // default of 1024
+  typed(size) max_depth;
+};
+
 typedef enum json_error_e {
   JSON_ERROR_EMPTY = 0,
   JSON_ERROR_INVALID_TYPE,
   JSON_ERROR_INVALID_KEY,
-  JSON_ERROR_INVALID_VALUE
+  JSON_ERROR_INVALID_VALUE,
+  JSON_ERROR_TOO_DEEP
 } typed(json_error);
 
+/**
+ * @brief The callbacks events of a parse are reported to instead of
+ * making elements. Any of them may be `NULL`. Each returns false to
+ * stop the parse. Strings and keys are unescaped, but only valid until
+ * the callback returns
+ */
+struct json_callbacks_s {
+  typed(json_boolean) (*on_object_start)(void *userdata);
+  typed(json_boolean) (*on_object_end)(void *userdata);
+  typed(json_boolean) (*on_array_start)(void *userdata);
+  typed(json_boolean) (*on_array_end)(void *userdata);
+  typed(json_boolean) (*on_key)(void *userdata, typed(json_string_view) key);
+  typed(json_boolean) (*on_string)(void *userdata,
+                                   typed(json_string_view) value);
+  typed(json_boolean) (*on_number)(void *userdata, typed(json_number) value);
+  typed(json_boolean) (*on_boolean)(void *userdata,
+                                    typed(json_boolean) value);
+  typed(json_boolean) (*on_null)(void *userdata);
+};
+
+/**
+ * @brief Where serialized JSON goes. With a `write` callback, output is
+ * batched in a buffer handed to it whenever it fills, and it returns
+ * false if it could not take it. Without one, the whole output is kept
+ * in the buffer, which grows as needed
+ */
+struct json_sink_s {
+  typed(json_boolean) (*write)(void *userdata, typed(json_string) data,
+                               typed(size) len);
+  void *userdata;
+  char *buffer;
+  // The number of characters in the buffer, not yet written if there is
+  // a callback
+  typed(size) len;
+  typed(size) capacity;
+  // Whether the callback failed, after which the output is dropped
+  typed(json_boolean) failed;
+};
+
+/**
+ * @brief Writes JSON to a sink {json_sink_t} one value at a time, without
+ * making any element {json_element_t} or allocating any memory. The
+ * caller is trusted to open and close containers in a valid order and to
+ * write a key before every value of an object
+ */
+struct json_writer_s {
+  typed(json_sink) * sink;
+  // The number of spaces to indent each level by, 0 for no whitespace
+  int indent;
+  // The number of containers open
+  typed(size) depth;
+  // Whether the innermost open container holds a value yet, which the
+  // next one is separated from
+  typed(json_boolean) has_values;
+  // Whether a key was just written, which its value follows directly
+  typed(json_boolean) after_key;
+};
+
 declare_result_type(json_element_type)
 declare_result_type(json_element_value)
 declare_result_type(json_element)
 declare_result_type(json_entry)
 declare_result_type(json_string)
 declare_result_type(size)
+declare_result_type(json_document)
+declare_result_type(json_path)
+declare_result_type(json_string_view)
+declare_result_type(json_number)
+declare_result_type(json_boolean)
+declare_result_type(json_tape)
+declare_result_type(json_tape_value)
+
+/**
+ * @brief The records of a buffer of newline-delimited JSON, parsed by
+ * `json_parse_lines`
+ */
+struct json_lines_s {
+  // The number of lines, blank ones included
+  typed(size) count;
+  // For every line in input order, either its root element or why it
+  // failed to parse
+  result(json_element) * lines;
+  // The opaque arenas owning every element, one per worker
+  typed(json_arena) * *arenas;
+  typed(size) arena_count;
+};
+
+declare_result_type(json_lines)
+
+/**
+ * @brief Reads the 8 characters at `str` as a little-endian word
+ */
+JSON_CONSTEXPR typed(uint64) json_key_load64(typed(json_string) str) {
+  return (typed(uint64))(unsigned char)str[0] |
+         (typed(uint64))(unsigned char)str[1] << 8 |
+         (typed(uint64))(unsigned char)str[2] << 16 |
+         (typed(uint64))(unsigned char)str[3] << 24 |
+         (typed(uint64))(unsigned char)str[4] << 32 |
+         (typed(uint64))(unsigned char)str[5] << 40 |
+         (typed(uint64))(unsigned char)str[6] << 48 |
+         (typed(uint64))(unsigned char)str[7] << 56;
+}
+
+/**
+ * @brief Reads the 4 characters at `str` as a little-endian word
+ */
+JSON_CONSTEXPR typed(uint64) json_key_load32(typed(json_string) str) {
+  return (typed(uint64))(unsigned char)str[0] |
+         (typed(uint64))(unsigned char)str[1] << 8 |
+         (typed(uint64))(unsigned char)str[2] << 16 |
+         (typed(uint64))(unsigned char)str[3] << 24;
+}
+
+/**
+ * @brief Hashes the `len` characters of a key 8 at a time, the way
+ * objects index their keys
+ *
+ * @param str The characters of the key
+ * @param len The number of characters
+ * @return The 64-bit hash of the key
+ */
+JSON_CONSTEXPR typed(uint64) json_key_hash(typed(json_string) str,
+                                           typed(size) len) {
+  typed(uint64) hash = len * 0x9E3779B97F4A7C15ULL;
+  typed(uint64) word = 0;
+  typed(size) i = 0;
+
+  // Offsets from `str` let compilers merge the loads into single reads
+  for (; len - i >= 8; i += 8) {
+    hash = (hash ^ json_key_load64(str + i)) * 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+  }
+
+  // The rest is read with loads of a fixed size, which may overlap
+  typed(size) rest = len - i;
+  if (len >= 8) {
+    word = json_key_load64(str + (len - 8));
+  } else if (rest >= 4) {
+    word = json_key_load32(str) | json_key_load32(str + (len - 4)) << 32;
+  } else if (rest > 0) {
+    word = (typed(uint64))(unsigned char)str[0] |
+           (typed(uint64))(unsigned char)str[rest / 2] << 8 |
+           (typed(uint64))(unsigned char)str[rest - 1] << 16;
+  }
+  hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+
+  // Mix every bit into both the slot and the stored high half
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ULL;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+/**
+ * @brief Makes a key {json_key_t} to look up with `json_object_find_key`,
+ * hashing it once. In C++ it can be made at compile time
+ *
+ * @param key The NUL-terminated key, which has to outlive the handle
+ * @return The key along with its length and hash
+ */
+JSON_CONSTEXPR typed(json_key) json_key_make(typed(json_string) key) {
+  typed(size) len = 0;
+  while (key != NULL && key[len] != '\0')
+    len++;
+
+  typed(json_key) retval = {key, len, json_key_hash(key, len)};
+  return retval;
+}
 
 /**
  * @brief Parses a JSON string into a JSON element {json_element_t}
@@ -127,6 +481,109 @@ declare_result_type(size)
  */
 result(json_element) json_parse(typed(json_string) json_str);
 
+/**
+ * @brief Parses the first `len` characters of a buffer into a JSON
+ * element {json_element_t}. The buffer need not be NUL-terminated and
+ * nothing beyond its `len` characters is ever read
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @return The parsed {json_element_t} wrapped in a `result` type
+ */
+result(json_element) json_parse_n(typed(json_string) json_str,
+                                  typed(size) len);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into a JSON
+ * element {json_element_t} the way the `options` ask for
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse`
+ * @return The parsed {json_element_t} wrapped in a `result` type
+ */
+result(json_element)
+    json_parse_with_options(typed(json_string) json_str, typed(size) len,
+                            const typed(json_parse_options) * options);
+
+/**
+ * @brief Parses a JSON string into a JSON document {json_document_t}.
+ * Every string, entry, object and array of the document is placed in a
+ * single growable arena owned by the document, so it can be released
+ * with one call to `json_document_free`
+ *
+ * @param json_str The raw JSON string
+ * @return The parsed {json_document_t} wrapped in a `result` type
+ */
+result(json_document) json_parse_document(typed(json_string) json_str);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into a JSON
+ * document {json_document_t}. The buffer need not be NUL-terminated
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @return The parsed {json_document_t} wrapped in a `result` type
+ */
+result(json_document) json_parse_document_n(typed(json_string) json_str,
+                                            typed(size) len);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into a JSON
+ * document {json_document_t} the way the `options` ask for
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse_document`
+ * @return The parsed {json_document_t} wrapped in a `result` type
+ */
+result(json_document)
+    json_parse_document_with_options(typed(json_string) json_str,
+                                     typed(size) len,
+                                     const typed(json_parse_options) *
+                                         options);
+
+/**
+ * @brief Parses the first `len` characters of a mutable buffer into a
+ * JSON document {json_document_t} without copying any string. Strings
+ * and keys are unescaped and NUL-terminated in place, so the buffer is
+ * overwritten and has to outlive the document
+ *
+ * @param json_str The raw JSON buffer, modified by the parse
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse_document`
+ * @return The parsed {json_document_t} wrapped in a `result` type
+ */
+result(json_document)
+    json_parse_document_in_situ(char *json_str, typed(size) len,
+                                const typed(json_parse_options) * options);
+
+/**
+ * @brief Parses the first `len` characters of a buffer whose root is an
+ * array into a JSON document {json_document_t} on several threads. A
+ * quote-aware scan splits the elements of the root array into ranges of
+ * about the same size, parsed by every thread into an arena of its own,
+ * and the results are joined into a single array in input order. Any
+ * other root, and input too small to be worth splitting, is parsed as by
+ * `json_parse_document_with_options`
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param threads The number of threads to parse with, the calling one
+ * included, or 0 for one per online processor
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse_document`. Keys are interned and shapes
+ * shared within the range of a thread only
+ * @return The parsed {json_document_t} wrapped in a `result` type
+ */
+result(json_document)
+    json_parse_document_parallel(typed(json_string) json_str, typed(size) len,
+                                 typed(size) threads,
+                                 const typed(json_parse_options) * options);
+
 /**
  * @brief Tries to get the element by key. If not found, returns
  * a {JSON_ERROR_INVALID_KEY} error
@@ -139,8 +596,579 @@ result(json_element)
     json_object_find(typed(json_object) * object, typed(json_string) key);
 
 /**
- * @brief Prints a JSON element {json_element_t} with proper
- * indentation
+ * @brief Tries to get the element by a key made with `json_key_make`,
+ * without measuring or hashing it again. If not found, returns a
+ * {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param object The object to find the key in
+ * @param key The key of the element to be found
+ * @return Either a {json_element_t} or {json_error_t}
+ */
+result(json_element) json_object_find_key(typed(json_object) * object,
+                                          const typed(json_key) * key);
+
+/**
+ * @brief Tries to get the position of a key in a shape {json_shape_t}.
+ * Every object of the shape holds the value of the key at that position
+ * of its `values`, so siblings sharing a shape need a single lookup. If
+ * not found, returns a {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param shape The shape to find the key in
+ * @param key The key to be found
+ * @return Either the position of the key or {json_error_t}
+ */
+result(size)
+    json_shape_find(typed(json_shape) * shape, typed(json_string) key);
+
+/**
+ * @brief Tries to get the position in a shape {json_shape_t} of a key
+ * made with `json_key_make`. If not found, returns a
+ * {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param shape The shape to find the key in
+ * @param key The key to be found
+ * @return Either the position of the key or {json_error_t}
+ */
+result(size) json_shape_find_key(typed(json_shape) * shape,
+                                 const typed(json_key) * key);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into a tape
+ * {json_tape_t}. The tape holds copies of every string, so the buffer
+ * need not outlive it. Its memory is freed with `json_tape_free`
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse`. Only `skip_whitespace` and `max_depth`
+ * apply
+ * @return The parsed {json_tape_t} wrapped in a `result` type
+ */
+result(json_tape)
+    json_parse_tape(typed(json_string) json_str, typed(size) len,
+                    const typed(json_parse_options) * options);
+
+/**
+ * @brief The root value of a tape {json_tape_t}
+ */
+typed(json_tape_value) json_tape_root(const typed(json_tape) * tape);
+
+/**
+ * @brief The type of a value on a tape, `JSON_ELEMENT_TYPE_STRING` for a
+ * key
+ */
+typed(json_element_type) json_tape_type(typed(json_tape_value) value);
+
+/**
+ * @brief The number of entries of an object or elements of an array on a
+ * tape, 0 for any other value
+ */
+typed(size) json_tape_count(typed(json_tape_value) value);
+
+/**
+ * @brief Tries to get the value of an object on a tape by key, walking
+ * its entries in order. Returns a {JSON_ERROR_INVALID_TYPE} error if the
+ * value is not an object. If not found, returns a
+ * {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param object The object to find the key in
+ * @param key The key of the value to be found
+ * @return Either a {json_tape_value_t} or {json_error_t}
+ */
+result(json_tape_value)
+    json_tape_object_find(typed(json_tape_value) object,
+                          typed(json_string) key);
+
+/**
+ * @brief Tries to get the value of an object on a tape by a key made
+ * with `json_key_make`, without measuring it again
+ *
+ * @param object The object to find the key in
+ * @param key The key of the value to be found
+ * @return Either a {json_tape_value_t} or {json_error_t}
+ */
+result(json_tape_value)
+    json_tape_object_find_key(typed(json_tape_value) object,
+                              const typed(json_key) * key);
+
+/**
+ * @brief Tries to get the element of an array on a tape at a position,
+ * skipping every container before it in one step. Returns a
+ * {JSON_ERROR_INVALID_TYPE} error if the value is not an array. If out
+ * of range, returns a {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param array The array to get the element of
+ * @param index The position of the element
+ * @return Either a {json_tape_value_t} or {json_error_t}
+ */
+result(json_tape_value) json_tape_array_get(typed(json_tape_value) array,
+                                            typed(size) index);
+
+/**
+ * @brief The first element of an array, or the first key of an object,
+ * on a tape. Iteration goes on with `json_tape_next` until
+ * `json_tape_is_end`
+ */
+typed(json_tape_value) json_tape_first(typed(json_tape_value) container);
+
+/**
+ * @brief The element after an element of an array, or the key after a
+ * key of an object, on a tape
+ */
+typed(json_tape_value) json_tape_next(typed(json_tape_value) item);
+
+/**
+ * @brief Whether iterating a container on a tape went beyond its last
+ * element or key
+ */
+typed(json_boolean) json_tape_is_end(typed(json_tape_value) item);
+
+/**
+ * @brief The value of the entry of a key of an object on a tape
+ */
+typed(json_tape_value) json_tape_key_value(typed(json_tape_value) key);
+
+/**
+ * @brief Reads a string or a key on a tape, NUL-terminated. Returns a
+ * {JSON_ERROR_INVALID_TYPE} error if the value is neither
+ *
+ * @return Either a {json_string_view_t} or {json_error_t}
+ */
+result(json_string_view) json_tape_get_string(typed(json_tape_value) value);
+
+/**
+ * @brief Reads a number on a tape. Returns a {JSON_ERROR_INVALID_TYPE}
+ * error if the value is not a number
+ *
+ * @return Either a {json_number_t} or {json_error_t}
+ */
+result(json_number) json_tape_get_number(typed(json_tape_value) value);
+
+/**
+ * @brief Reads a boolean on a tape. Returns a {JSON_ERROR_INVALID_TYPE}
+ * error if the value is not a boolean
+ *
+ * @return Either a {json_boolean_t} or {json_error_t}
+ */
+result(json_boolean) json_tape_get_boolean(typed(json_tape_value) value);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into events
+ * reported to `callbacks` as they are read, without making any element.
+ * Unlike `json_parse`, null and empty values are reported too. Memory
+ * use only grows with the nesting and the longest escaped string
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param callbacks The {json_callbacks_t} to report the events to
+ * @param userdata Passed to every callback
+ * @return Either whether the whole root element was reported, false if a
+ * callback stopped the parse, or {json_error_t}
+ */
+result(json_boolean)
+    json_parse_events(typed(json_string) json_str, typed(size) len,
+                      const typed(json_callbacks) * callbacks, void *userdata);
+
+/**
+ * @brief Parses the first `len` characters of a buffer into events the
+ * way the `options` ask for
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param callbacks The {json_callbacks_t} to report the events to
+ * @param userdata Passed to every callback
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse_events`. Only whitespace skipping and the
+ * maximum depth apply
+ * @return Either whether the whole root element was reported, false if a
+ * callback stopped the parse, or {json_error_t}
+ */
+result(json_boolean) json_parse_events_with_options(
+    typed(json_string) json_str, typed(size) len,
+    const typed(json_callbacks) * callbacks, void *userdata,
+    const typed(json_parse_options) * options);
+
+/**
+ * @brief Makes a push parser {json_push_parser_t}, to which the input is
+ * fed in chunks of any size as it arrives and which reports events to
+ * callbacks {json_callbacks_t} as soon as each token is complete. A token
+ * split across chunks is carried over to the next one, so memory grows
+ * with the nesting depth and the longest token only
+ *
+ * @param callbacks The callbacks to report events to
+ * @param userdata Passed to every callback
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse_events`. Only whitespace skipping and the
+ * maximum depth apply
+ * @return The push parser, to be freed with `json_push_parser_free`
+ */
+typed(json_push_parser) *
+    json_push_parser_new(const typed(json_callbacks) * callbacks,
+                         void *userdata,
+                         const typed(json_parse_options) * options);
+
+/**
+ * @brief Feeds the next chunk of the input to a push parser. The chunk
+ * need not outlive the call. Anything after the root element is ignored
+ *
+ * @param parser The push parser
+ * @param chunk The next characters of the input
+ * @param len The number of characters in the chunk
+ * @return Either true to be fed more, false if a callback stopped the
+ * parse, or {json_error_t}. Once stopped or failed, a push parser keeps
+ * returning the same
+ */
+result(json_boolean) json_push_feed(typed(json_push_parser) * parser,
+                                    typed(json_string) chunk, typed(size) len);
+
+/**
+ * @brief Tells a push parser that the input ends, which completes a
+ * root number or literal still waiting for its next character
+ *
+ * @param parser The push parser
+ * @return Either whether the whole root element was reported, false if a
+ * callback stopped the parse, or {json_error_t}
+ */
+result(json_boolean) json_push_finish(typed(json_push_parser) * parser);
+
+/**
+ * @brief Frees a push parser {json_push_parser_t} from memory
+ *
+ * @param parser The push parser to free
+ */
+void json_push_parser_free(typed(json_push_parser) * parser);
+
+/**
+ * @brief Parses every line of a buffer of newline-delimited JSON (JSON
+ * Lines) as a record of its own, spreading the lines over a pool of
+ * threads that each allocate into an arena of their own. A line that
+ * fails to parse only fails its own result. A '\r' ending a line is
+ * ignored and a blank line results in a {JSON_ERROR_EMPTY} error
+ *
+ * @param json_str The raw buffer of lines
+ * @param len The number of characters in the buffer
+ * @param threads The number of threads to parse with, the calling one
+ * included, or 0 for one per online processor
+ * @param options The {json_parse_options_t} of every line, or `NULL` for
+ * the defaults of `json_parse`. Keys are interned and shapes shared
+ * within a line only
+ * @return Either the {json_lines_t}, to be freed with `json_lines_free`,
+ * or {json_error_t}
+ */
+result(json_lines)
+    json_parse_lines(typed(json_string) json_str, typed(size) len,
+                     typed(size) threads,
+                     const typed(json_parse_options) * options);
+
+/**
+ * @brief Frees the lines {json_lines_t} from memory, along with every
+ * element of them, with a single release per worker
+ *
+ * @param lines The lines {json_lines_t} to free
+ */
+void json_lines_free(typed(json_lines) * lines);
+
+/**
+ * @brief Compiles a JSON Pointer (RFC 6901) such as
+ * `/data/children/0/data/title` into a path {json_path_t}. The empty
+ * pointer refers to the root element. Returns a
+ * {JSON_ERROR_INVALID_KEY} error if the pointer is malformed
+ *
+ * @param pointer The NUL-terminated JSON Pointer
+ * @return Either a {json_path_t} or {json_error_t}
+ */
+result(json_path) json_path_compile(typed(json_string) pointer);
+
+/**
+ * @brief Finds the element a path {json_path_t} refers to in the first
+ * `len` characters of a buffer. Everything outside of the path is
+ * skipped over without being parsed, and only the element found is
+ * made into a JSON element {json_element_t}, to be freed with
+ * `json_free`. If not found, returns a {JSON_ERROR_INVALID_KEY} error
+ *
+ * @param path The compiled path
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of this parse, or `NULL` for
+ * the defaults of `json_parse`. The structural index is never built
+ * @return Either a {json_element_t} or {json_error_t}
+ */
+result(json_element)
+    json_path_find(const typed(json_path) * path, typed(json_string) json_str,
+                   typed(size) len, const typed(json_parse_options) * options);
+
+/**
+ * @brief Frees a path {json_path_t} from memory
+ *
+ * @param path The path {json_path_t} to free
+ */
+void json_path_free(typed(json_path) * path);
+
+/**
+ * @brief Makes a cursor {json_cursor_t} at the root element of the first
+ * `len` characters of a buffer, which has to outlive it
+ *
+ * @param json_str The raw JSON buffer
+ * @param len The number of characters in the buffer
+ * @param options The {json_parse_options_t} of the reads, or `NULL` for
+ * the defaults of `json_parse`. Only whitespace skipping applies
+ * @return The cursor
+ */
+typed(json_cursor)
+    json_cursor_make(typed(json_string) json_str, typed(size) len,
+                     const typed(json_parse_options) * options);
+
+/**
+ * @brief Tells the type of the value at a cursor without reading it
+ *
+ * @param cursor The cursor
+ * @return Either a {json_element_type_t} or {json_error_t}
+ */
+result(json_element_type) json_cursor_type(typed(json_cursor) * cursor);
+
+/**
+ * @brief Moves a cursor into the object at it, so that its entries are
+ * read with `json_cursor_next_field`
+ *
+ * @param cursor The cursor
+ * @return true If the cursor was at an object
+ * @return false If it was not (the cursor does not move)
+ */
+typed(json_boolean) json_cursor_enter_object(typed(json_cursor) * cursor);
+
+/**
+ * @brief Moves a cursor into the array at it, so that its elements are
+ * read with `json_cursor_next_element`
+ *
+ * @param cursor The cursor
+ * @return true If the cursor was at an array
+ * @return false If it was not (the cursor does not move)
+ */
+typed(json_boolean) json_cursor_enter_array(typed(json_cursor) * cursor);
+
+/**
+ * @brief Moves a cursor inside an object to the value of its next entry,
+ * or beyond the object once every entry is read. The value of the
+ * previous entry must have been read or skipped
+ *
+ * @param cursor The cursor
+ * @param key Set to the characters of the key as they are in the input,
+ * escapes included
+ * @return Either whether there was an entry or {json_error_t}
+ */
+result(json_boolean) json_cursor_next_field(typed(json_cursor) * cursor,
+                                            typed(json_string_view) * key);
+
+/**
+ * @brief Moves a cursor inside an array to its next element, or beyond
+ * the array once every element is read. The previous element must have
+ * been read or skipped
+ *
+ * @param cursor The cursor
+ * @return Either whether there was an element or {json_error_t}
+ */
+result(json_boolean) json_cursor_next_element(typed(json_cursor) * cursor);
+
+/**
+ * @brief Reads the string at a cursor and moves beyond it. A string
+ * without escapes is a view into the input, one with escapes is
+ * unescaped into `buffer` and NUL-terminated. Returns a
+ * {JSON_ERROR_INVALID_TYPE} error if the value is not a string
+ *
+ * @param cursor The cursor
+ * @param buffer Where escaped strings are unescaped, or `NULL`
+ * @param capacity The size of the buffer, which has to exceed the length
+ * of the string in the input
+ * @return Either a {json_string_view_t} or {json_error_t}
+ */
+result(json_string_view)
+    json_cursor_get_string(typed(json_cursor) * cursor, char *buffer,
+                           typed(size) capacity);
+
+/**
+ * @brief Reads the number at a cursor and moves beyond it. Returns a
+ * {JSON_ERROR_INVALID_TYPE} error if the value is not a number
+ *
+ * @param cursor The cursor
+ * @return Either a {json_number_t} or {json_error_t}
+ */
+result(json_number) json_cursor_get_number(typed(json_cursor) * cursor);
+
+/**
+ * @brief Reads the boolean at a cursor and moves beyond it. Returns a
+ * {JSON_ERROR_INVALID_TYPE} error if the value is not a boolean
+ *
+ * @param cursor The cursor
+ * @return Either a {json_boolean_t} or {json_error_t}
+ */
+result(json_boolean) json_cursor_get_boolean(typed(json_cursor) * cursor);
+
+/**
+ * @brief Moves a cursor beyond the value at it, null and containers
+ * included, without reading it
+ *
+ * @param cursor The cursor
+ * @return true If a value was skipped
+ * @return false If there was no value (the cursor does not move)
+ */
+typed(json_boolean) json_cursor_skip(typed(json_cursor) * cursor);
+
+/**
+ * @brief Makes a sink {json_sink_t} writing to a callback, or keeping
+ * its output in a growable buffer if `write` is `NULL`
+ *
+ * @param write The callback, given `userdata` and the characters
+ * @param userdata Passed to every call of `write`
+ */
+typed(json_sink)
+    json_sink_make(typed(json_boolean) (*write)(void *userdata,
+                                                typed(json_string) data,
+                                                typed(size) len),
+                   void *userdata);
+
+/**
+ * @brief A callback for `json_sink_make` writing to the `FILE *` passed
+ * as its userdata
+ */
+typed(json_boolean) json_sink_write_file(void *file, typed(json_string) data,
+                                         typed(size) len);
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief A callback for `json_sink_make` writing to the `int` file
+ * descriptor its userdata points to, retrying partial writes. Only on
+ * POSIX systems
+ */
+typed(json_boolean) json_sink_write_fd(void *fd, typed(json_string) data,
+                                       typed(size) len);
+#endif
+
+/**
+ * @brief Hands whatever is buffered to the callback of a sink
+ * {json_sink_t}. Does nothing for a sink without one
+ *
+ * @return true If everything written to the sink so far was taken
+ * @return false If the callback failed
+ */
+typed(json_boolean) json_sink_flush(typed(json_sink) * sink);
+
+/**
+ * @brief Frees the buffer of a sink {json_sink_t}, without flushing it
+ */
+void json_sink_free(typed(json_sink) * sink);
+
+/**
+ * @brief Writes a JSON element {json_element_t} to a sink {json_sink_t}
+ * and flushes it. Doubles are written with the fewest digits that read
+ * back as the same double
+ *
+ * @param indent The number of spaces to indent each level by, or 0 to
+ * write the element on one line without any whitespace
+ * @return true If the whole element was written
+ * @return false If the callback of the sink failed
+ */
+typed(json_boolean) json_serialize(const typed(json_element) * element,
+                                   int indent, typed(json_sink) * sink);
+
+/**
+ * @brief Makes a writer {json_writer_t} writing to a sink {json_sink_t}
+ *
+ * @param indent The number of spaces to indent each level by, or 0 to
+ * write everything on one line without any whitespace
+ */
+typed(json_writer) json_writer_make(typed(json_sink) * sink, int indent);
+
+/**
+ * @brief Opens an object, whose keys and values follow
+ */
+void json_writer_begin_object(typed(json_writer) * writer);
+
+/**
+ * @brief Closes the innermost open object
+ */
+void json_writer_end_object(typed(json_writer) * writer);
+
+/**
+ * @brief Opens an array, whose elements follow
+ */
+void json_writer_begin_array(typed(json_writer) * writer);
+
+/**
+ * @brief Closes the innermost open array
+ */
+void json_writer_end_array(typed(json_writer) * writer);
+
+/**
+ * @brief Writes the NUL-terminated key of the next value of an object
+ */
+void json_writer_key(typed(json_writer) * writer, typed(json_string) key);
+
+/**
+ * @brief Writes the key of the next value of an object, of `len`
+ * characters
+ */
+void json_writer_key_n(typed(json_writer) * writer, typed(json_string) key,
+                       typed(size) len);
+
+/**
+ * @brief Writes a NUL-terminated string
+ */
+void json_writer_string(typed(json_writer) * writer, typed(json_string) str);
+
+/**
+ * @brief Writes a string of `len` characters, which may hold NULs
+ */
+void json_writer_string_n(typed(json_writer) * writer, typed(json_string) str,
+                          typed(size) len);
+
+/**
+ * @brief Writes a number {json_number_t}, a double with the fewest digits
+ * that read back as the same double
+ */
+void json_writer_number(typed(json_writer) * writer,
+                        typed(json_number) number);
+
+/**
+ * @brief Writes an integer
+ */
+void json_writer_long(typed(json_writer) * writer,
+                      typed(json_number_long) value);
+
+/**
+ * @brief Writes a double with the fewest digits that read back as the
+ * same double
+ */
+void json_writer_double(typed(json_writer) * writer,
+                        typed(json_number_double) value);
+
+/**
+ * @brief Writes a boolean
+ */
+void json_writer_boolean(typed(json_writer) * writer,
+                         typed(json_boolean) value);
+
+/**
+ * @brief Writes a `null`
+ */
+void json_writer_null(typed(json_writer) * writer);
+
+/**
+ * @brief Writes a whole JSON element {json_element_t} as one value
+ */
+void json_writer_element(typed(json_writer) * writer,
+                         const typed(json_element) * element);
+
+/**
+ * @brief Flushes the sink {json_sink_t} of a writer
+ *
+ * @return true If everything written so far was taken by the sink
+ * @return false If the callback of the sink failed
+ */
+typed(json_boolean) json_writer_finish(typed(json_writer) * writer);
+
+/**
+ * @brief Prints a JSON element {json_element_t} to stdout with proper
+ * indentation, the way `json_serialize` writes it
  *
  * @param indent The number of spaces to indent each level by
  */
@@ -153,6 +1181,22 @@ void json_print(typed(json_element) * element, int indent);
  */
 void json_free(typed(json_element) * element);
 
+/**
+ * @brief Frees a JSON document {json_document_t} along with every
+ * element in it. Elements of a document must not be passed to
+ * `json_free`
+ *
+ * @param document The JSON document {json_document_t} to free
+ */
+void json_document_free(typed(json_document) * document);
+
+/**
+ * @brief Frees a tape {json_tape_t} along with its strings
+ *
+ * @param tape The tape {json_tape_t} to free
+ */
+void json_tape_free(typed(json_tape) * tape);
+
 /**
  * @brief Returns a string representation of JSON error {json_error_t} type
  *
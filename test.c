@@ -0,0 +1,1468 @@
+#include <dirent.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "json.h"
+
+/**
+ * @brief Number of pseudo-random documents every check goes through
+ */
+#define TEST_DOCUMENTS 300
+
+/**
+ * @brief Deepest nesting of the pseudo-random documents
+ */
+#define TEST_MAX_NESTING 6
+
+/**
+ * @brief Characters of input the parallel parse needs before it splits an
+ * array at all, two slices of 64 KB
+ */
+#define TEST_PARALLEL_BYTES (2 * 64 * 1024)
+
+/**
+ * @brief A growable NUL-terminated buffer of characters
+ */
+struct test_text {
+  char *data;
+  size_t len;
+  size_t capacity;
+};
+
+/**
+ * @brief What pseudo-random documents may hold
+ */
+struct test_shape {
+  // Spaces and newlines between tokens
+  bool whitespace;
+  // Keys with escapes, which the cursor reports as they are in the input
+  bool escaped_keys;
+  // Nulls and empty strings, which trees and tapes leave out
+  bool empty_values;
+};
+
+static unsigned long long test_state = 88172645463325252ULL;
+static int test_failures = 0;
+
+/**
+ * @brief The next pseudo-random number, the same on every run
+ */
+static unsigned long long test_random(void) {
+  test_state ^= test_state << 13;
+  test_state ^= test_state >> 7;
+  test_state ^= test_state << 17;
+  return test_state;
+}
+
+/**
+ * @brief Reports a failed expectation of the check `name`
+ */
+static void test_fail(const char *name, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  fprintf(stderr, "%s: ", name);
+  vfprintf(stderr, format, args);
+  fputc('\n', stderr);
+  va_end(args);
+
+  test_failures++;
+}
+
+static void test_append_n(struct test_text *text, const char *str,
+                          size_t len) {
+  if (text->len + len + 1 > text->capacity) {
+    text->capacity = 2 * (text->len + len + 1);
+    text->data = realloc(text->data, text->capacity);
+  }
+
+  memcpy(text->data + text->len, str, len);
+  text->len += len;
+  text->data[text->len] = '\0';
+}
+
+static void test_append(struct test_text *text, const char *str) {
+  test_append_n(text, str, strlen(str));
+}
+
+static void test_appendf(struct test_text *text, const char *format, ...) {
+  char buffer[64];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+
+  test_append_n(text, buffer, (size_t)len);
+}
+
+/**
+ * @brief Writes a few spaces or newlines if the shape allows them
+ */
+static void test_gen_space(struct test_text *text,
+                           const struct test_shape *shape) {
+  if (!shape->whitespace)
+    return;
+
+  static const char *spaces[] = {"", "", " ", "\n  ", "\t", " \r\n"};
+  test_append(text, spaces[test_random() % 6]);
+}
+
+static void test_gen_string(struct test_text *text,
+                            const struct test_shape *shape) {
+  // Escapes, multi-byte characters and the characters paths escape
+  static const char *parts[] = {
+      "a", "text", " ", "\\n", "\\\"", "\\\\", "\\/", "\\t", "~", "/", "12",
+      "\\u00e9", "\xc3\xa9", "\\ud83d\\ude00", "long words here"};
+  size_t count = test_random() % 4;
+  if (count == 0 && !shape->empty_values)
+    count = 1;
+
+  test_append(text, "\"");
+  for (size_t i = 0; i < count; i++)
+    test_append(text, parts[test_random() % 15]);
+  test_append(text, "\"");
+}
+
+static void test_gen_key(struct test_text *text,
+                         const struct test_shape *shape) {
+  static const char *keys[] = {"id",   "name", "a",        "b",
+                               "x_y",  "a/b",  "m~n",      "value",
+                               "data", "12",   "children", "long key here"};
+  static const char *escaped_keys[] = {"k\\u00e9y", "q\\\"t", "tab\\t"};
+
+  // The empty key is dropped along with its value, like empty values
+  if (shape->empty_values && test_random() % 16 == 0) {
+    test_append(text, "\"\"");
+    return;
+  }
+
+  if (shape->escaped_keys && test_random() % 8 == 0) {
+    test_appendf(text, "\"%s\"", escaped_keys[test_random() % 3]);
+    return;
+  }
+
+  test_appendf(text, "\"%s\"", keys[test_random() % 12]);
+}
+
+static void test_gen_number(struct test_text *text) {
+  switch (test_random() % 6) {
+  case 0:
+    test_appendf(text, "%d", (int)(test_random() % 2001) - 1000);
+    break;
+  case 1:
+    test_appendf(text, "%lld", (long long)test_random() / 2);
+    break;
+  case 2:
+    test_appendf(text, "%d.%d", (int)(test_random() % 1000) - 500,
+                 (int)(test_random() % 100));
+    break;
+  case 3:
+    test_appendf(text, "%de%d", (int)(test_random() % 100),
+                 (int)(test_random() % 40) - 20);
+    break;
+  default: {
+    // Any finite double, subnormals included
+    double value;
+    do {
+      unsigned long long bits = test_random();
+      memcpy(&value, &bits, sizeof(value));
+    } while (!isfinite(value));
+    test_appendf(text, "%.17g", value);
+    break;
+  }
+  }
+}
+
+static void test_gen_value(struct test_text *text,
+                           const struct test_shape *shape, int depth) {
+  unsigned long long kind = test_random() % (depth < TEST_MAX_NESTING ? 9 : 6);
+
+  switch (kind) {
+  case 0:
+  case 1:
+    test_gen_string(text, shape);
+    break;
+  case 2:
+  case 3:
+    test_gen_number(text);
+    break;
+  case 4:
+    test_append(text, test_random() % 2 ? "true" : "false");
+    break;
+  case 5:
+    if (shape->empty_values)
+      test_append(text, "null");
+    else
+      test_gen_number(text);
+    break;
+  case 6:
+  case 7: {
+    size_t count = test_random() % 5;
+    test_append(text, "{");
+    for (size_t i = 0; i < count; i++) {
+      if (i != 0)
+        test_append(text, ",");
+      test_gen_space(text, shape);
+      test_gen_key(text, shape);
+      test_gen_space(text, shape);
+      test_append(text, ":");
+      test_gen_space(text, shape);
+      test_gen_value(text, shape, depth + 1);
+      test_gen_space(text, shape);
+    }
+    test_append(text, "}");
+    break;
+  }
+  default: {
+    size_t count = test_random() % 5;
+    test_append(text, "[");
+    for (size_t i = 0; i < count; i++) {
+      if (i != 0)
+        test_append(text, ",");
+      test_gen_space(text, shape);
+      test_gen_value(text, shape, depth + 1);
+      test_gen_space(text, shape);
+    }
+    test_append(text, "]");
+    break;
+  }
+  }
+}
+
+/**
+ * @brief Makes a pseudo-random document whose root is always an object
+ * or an array
+ */
+static char *test_gen_document(const struct test_shape *shape, size_t *len) {
+  struct test_text text = {0};
+
+  test_gen_space(&text, shape);
+  bool is_object = test_random() % 2 == 0;
+  test_append(&text, is_object ? "{" : "[");
+  size_t count = 1 + test_random() % 4;
+  for (size_t i = 0; i < count; i++) {
+    if (i != 0)
+      test_append(&text, ",");
+    test_gen_space(&text, shape);
+    if (is_object) {
+      test_gen_key(&text, shape);
+      test_append(&text, ":");
+    }
+    test_gen_value(&text, shape, 2);
+    test_gen_space(&text, shape);
+  }
+  test_append(&text, is_object ? "}" : "]");
+  test_gen_space(&text, shape);
+
+  *len = text.len;
+  return text.data;
+}
+
+/**
+ * @brief Nests `1` in `depth` arrays
+ */
+static char *test_gen_nested(size_t depth, size_t *len) {
+  char *buffer = malloc(2 * depth + 2);
+  memset(buffer, '[', depth);
+  buffer[depth] = '1';
+  memset(buffer + depth + 1, ']', depth);
+  buffer[2 * depth + 1] = '\0';
+
+  *len = 2 * depth + 1;
+  return buffer;
+}
+
+/**
+ * @brief Serializes an element, minified unless `indent`
+ */
+static char *test_serialize(const typed(json_element) * element, int indent) {
+  typed(json_sink) sink = json_sink_make(NULL, NULL);
+  json_serialize(element, indent, &sink);
+
+  char *out = malloc(sink.len + 1);
+  memcpy(out, sink.buffer, sink.len);
+  out[sink.len] = '\0';
+  json_sink_free(&sink);
+
+  return out;
+}
+
+/**
+ * @brief Parses into a tree and serializes it minified, or describes the
+ * error
+ */
+static char *test_parse_serialize(const char *json, size_t len,
+                                  const typed(json_parse_options) * options) {
+  result(json_element) element_result =
+      json_parse_with_options(json, len, options);
+  if (result_is_err(json_element)(&element_result)) {
+    typed(json_error) error = result_unwrap_err(json_element)(&element_result);
+    return strdup(json_error_to_string(error));
+  }
+
+  typed(json_element) element = result_unwrap(json_element)(&element_result);
+  char *out = test_serialize(&element, 0);
+  json_free(&element);
+
+  return out;
+}
+
+/**
+ * @brief Serializes the root of a parsed document minified, or describes
+ * the error, and frees the document
+ */
+static char *test_document_serialize(result(json_document) * document_result) {
+  if (result_is_err(json_document)(document_result)) {
+    typed(json_error) error = result_unwrap_err(json_document)(document_result);
+    return strdup(json_error_to_string(error));
+  }
+
+  typed(json_document) document = result_unwrap(json_document)(document_result);
+  char *out = test_serialize(&document.root, 0);
+  json_document_free(&document);
+
+  return out;
+}
+
+/**
+ * @brief Compares two outputs of the same input, which it prints on a
+ * mismatch, and frees them
+ */
+static bool test_same(const char *name, const char *json, char *expected,
+                      char *actual) {
+  bool same = strcmp(expected, actual) == 0;
+  if (!same)
+    test_fail(name, "%s\n  expected %s\n  got      %s", json, expected,
+              actual);
+
+  free(expected);
+  free(actual);
+  return same;
+}
+
+static int test_compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Reads every *.json file of a directory, in sorted order. The
+ * last entry of the list is `NULL`
+ */
+static char **test_sample_paths(const char *directory) {
+  DIR *dir = opendir(directory);
+  if (dir == NULL) {
+    fprintf(stderr, "Expected directory \"%s\" not found\n", directory);
+    char **paths = malloc(sizeof(char *));
+    paths[0] = NULL;
+    return paths;
+  }
+
+  size_t count = 0;
+  char **paths = NULL;
+  for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+    size_t len = strlen(entry->d_name);
+    if (len < 5 || strcmp(entry->d_name + len - 5, ".json") != 0)
+      continue;
+
+    paths = realloc(paths, (count + 2) * sizeof(char *));
+    paths[count] = malloc(strlen(directory) + len + 2);
+    sprintf(paths[count], "%s/%s", directory, entry->d_name);
+    count++;
+  }
+  closedir(dir);
+
+  qsort(paths, count, sizeof(char *), test_compare_names);
+  paths = realloc(paths, (count + 1) * sizeof(char *));
+  paths[count] = NULL;
+
+  return paths;
+}
+
+static char *test_read_file(const char *path, size_t *len) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  *len = (size_t)ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  char *buffer = malloc(*len + 1);
+  *len = fread(buffer, 1, *len, file);
+  buffer[*len] = '\0';
+  fclose(file);
+
+  return buffer;
+}
+
+/**
+ * @brief Objects of 1 to 3 keys fill most of their hash index, which must
+ * still have an empty slot for a lookup of a missing key to stop at
+ */
+static void test_missing_keys(void) {
+  const char *objects[] = {"{\"a\":1}", "{\"a\":1,\"b\":2}",
+                           "{\"a\":1,\"b\":2,\"c\":3}"};
+  typed(json_key) missing = json_key_make("missing key");
+
+  for (size_t i = 0; i < sizeof(objects) / sizeof(objects[0]); i++) {
+    result(json_element) element_result = json_parse(objects[i]);
+    typed(json_element) element = result_unwrap(json_element)(&element_result);
+    typed(json_object) *object = element.value.as_object;
+
+    result(json_element) find = json_object_find(object, "missing key");
+    result(json_element) find_key = json_object_find_key(object, &missing);
+    result(size) shape_find = json_shape_find(object->shape, "missing key");
+    result(size) shape_find_key = json_shape_find_key(object->shape, &missing);
+    if (result_is_ok(json_element)(&find) ||
+        result_is_ok(json_element)(&find_key) ||
+        result_is_ok(size)(&shape_find) ||
+        result_is_ok(size)(&shape_find_key))
+      test_fail("missing keys", "found a missing key in %s", objects[i]);
+
+    json_free(&element);
+  }
+}
+
+/**
+ * @brief The structural index is only a faster way to the same tree
+ */
+static void test_indexed(char **samples) {
+  typed(json_parse_options) plain = {0};
+  plain.skip_whitespace = true;
+  typed(json_parse_options) indexed = plain;
+  indexed.structural_index = true;
+
+  // An entry with the empty key is dropped whole, so that its value is
+  // not read as the next key
+  const char *empty_keys[][2] = {
+      {"{\"\":4,\"x\":\"y\",\"z\":5}", "{\"x\":\"y\",\"z\":5}"},
+      {"{\"a\":1,\"\":2,\"b\":3}", "{\"a\":1,\"b\":3}"},
+      {"{\"\" : {\"q\":[1,\",\"]} , \"k\":\":\"}", "{\"k\":\":\"}"},
+      {"[{\"\":[1,2],\"a\":1},{\"\":\"\"}]", "[{\"a\":1}]"},
+  };
+  for (size_t i = 0; i < sizeof(empty_keys) / sizeof(empty_keys[0]); i++) {
+    const char *json = empty_keys[i][0];
+    test_same("empty keys", json, strdup(empty_keys[i][1]),
+              test_parse_serialize(json, strlen(json), &plain));
+    test_same("empty keys", json, strdup(empty_keys[i][1]),
+              test_parse_serialize(json, strlen(json), &indexed));
+  }
+
+  for (char **path = samples; *path != NULL; path++) {
+    size_t len;
+    char *json = test_read_file(*path, &len);
+    if (json == NULL)
+      continue;
+
+    test_same("indexed", *path, test_parse_serialize(json, len, &plain),
+              test_parse_serialize(json, len, &indexed));
+    free(json);
+  }
+
+  struct test_shape shape = {true, true, true};
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    test_same("indexed", json, test_parse_serialize(json, len, &plain),
+              test_parse_serialize(json, len, &indexed));
+    free(json);
+  }
+}
+
+/**
+ * @brief Documents hold the same values whether strings are copied,
+ * unescaped in place or left in the input as views, and whether keys and
+ * shapes are shared
+ */
+static void test_documents(void) {
+  struct test_shape shape = {true, true, true};
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    typed(json_parse_options) options = {0};
+    options.skip_whitespace = true;
+    char *expected = test_parse_serialize(json, len, &options);
+
+    result(json_document) plain =
+        json_parse_document_with_options(json, len, &options);
+    test_same("document", json, strdup(expected),
+              test_document_serialize(&plain));
+
+    options.string_views = true;
+    result(json_document) views =
+        json_parse_document_with_options(json, len, &options);
+    test_same("string views", json, strdup(expected),
+              test_document_serialize(&views));
+
+    options.share_shapes = true;
+    result(json_document) shared =
+        json_parse_document_with_options(json, len, &options);
+    test_same("shared shapes", json, strdup(expected),
+              test_document_serialize(&shared));
+
+    char *copy = malloc(len);
+    memcpy(copy, json, len);
+    options.string_views = false;
+    result(json_document) in_situ =
+        json_parse_document_in_situ(copy, len, &options);
+    test_same("in situ", json, strdup(expected),
+              test_document_serialize(&in_situ));
+
+    free(copy);
+    free(expected);
+    free(json);
+  }
+}
+
+/**
+ * @brief Appends a token to a JSON Pointer, escaping '~' and '/'
+ */
+static void test_append_token(struct test_text *pointer, const char *token,
+                              size_t len) {
+  test_append(pointer, "/");
+  for (size_t i = 0; i < len; i++) {
+    if (token[i] == '~')
+      test_append(pointer, "~0");
+    else if (token[i] == '/')
+      test_append(pointer, "~1");
+    else
+      test_append_n(pointer, token + i, 1);
+  }
+}
+
+/**
+ * @brief Finds the element at a path of the raw input and compares it
+ * with the element at the same place of the tree
+ */
+static void test_path_lookup(const char *json, size_t len,
+                             const char *pointer,
+                             const typed(json_element) * expected) {
+  result(json_path) path_result = json_path_compile(pointer);
+  if (result_is_err(json_path)(&path_result)) {
+    test_fail("paths", "%s does not compile", pointer);
+    return;
+  }
+  typed(json_path) path = result_unwrap(json_path)(&path_result);
+
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = true;
+  result(json_element) found = json_path_find(&path, json, len, &options);
+
+  if (expected == NULL) {
+    if (result_is_ok(json_element)(&found)) {
+      typed(json_element) element = result_unwrap(json_element)(&found);
+      test_fail("paths", "%s found %s in %s", pointer,
+                test_serialize(&element, 0), json);
+      json_free(&element);
+    }
+  } else if (result_is_err(json_element)(&found)) {
+    test_fail("paths", "%s not found in %s", pointer, json);
+  } else {
+    typed(json_element) element = result_unwrap(json_element)(&found);
+    test_same("paths", pointer, test_serialize(expected, 0),
+              test_serialize(&element, 0));
+    json_free(&element);
+  }
+
+  json_path_free(&path);
+}
+
+/**
+ * @brief Paths find what a walk of the tree finds, and nothing for a
+ * member that is not there
+ */
+static void test_paths(void) {
+  struct test_shape shape = {true, true, true};
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    typed(json_parse_options) options = {0};
+    options.skip_whitespace = true;
+    result(json_element) root_result =
+        json_parse_with_options(json, len, &options);
+    if (result_is_err(json_element)(&root_result)) {
+      free(json);
+      continue;
+    }
+    typed(json_element) root = result_unwrap(json_element)(&root_result);
+
+    // Walk down a random branch, looking every step up
+    struct test_text pointer = {0};
+    test_append(&pointer, "");
+    const typed(json_element) *element = &root;
+    for (;;) {
+      test_path_lookup(json, len, pointer.data, element);
+
+      if (element->type == JSON_ELEMENT_TYPE_OBJECT) {
+        typed(json_object) *object = element->value.as_object;
+        struct test_text missing = {0};
+        test_append(&missing, pointer.data);
+        test_append(&missing, "/missing key");
+        test_path_lookup(json, len, missing.data, NULL);
+        free(missing.data);
+
+        if (object->count == 0)
+          break;
+
+        // Duplicate keys are found at their first entry
+        typed(json_string_view) key =
+            object->shape->keys[test_random() % object->count];
+        test_append_token(&pointer, key.data, key.len);
+        for (size_t j = 0; j < object->count; j++) {
+          if (object->shape->keys[j].len == key.len &&
+              memcmp(object->shape->keys[j].data, key.data, key.len) == 0) {
+            element = &object->values[j];
+            break;
+          }
+        }
+      } else if (element->type == JSON_ELEMENT_TYPE_ARRAY) {
+        typed(json_array) *array = element->value.as_array;
+        char token[32];
+        sprintf(token, "%zu", array->count);
+        struct test_text beyond = {0};
+        test_append(&beyond, pointer.data);
+        test_append_token(&beyond, token, strlen(token));
+        test_path_lookup(json, len, beyond.data, NULL);
+        free(beyond.data);
+
+        if (array->count == 0)
+          break;
+
+        size_t index = test_random() % array->count;
+        sprintf(token, "%zu", index);
+        test_append_token(&pointer, token, strlen(token));
+        element = &array->elements[index];
+      } else {
+        break;
+      }
+    }
+
+    free(pointer.data);
+    json_free(&root);
+    free(json);
+  }
+}
+
+static typed(json_boolean) test_on_object_start(void *userdata) {
+  test_append(userdata, "{\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_object_end(void *userdata) {
+  test_append(userdata, "}\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_array_start(void *userdata) {
+  test_append(userdata, "[\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_array_end(void *userdata) {
+  test_append(userdata, "]\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_key(void *userdata,
+                                       typed(json_string_view) key) {
+  test_append(userdata, "key ");
+  test_append_n(userdata, key.data, key.len);
+  test_append(userdata, "\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_string(void *userdata,
+                                          typed(json_string_view) value) {
+  test_append(userdata, "string ");
+  test_append_n(userdata, value.data, value.len);
+  test_append(userdata, "\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_number(void *userdata,
+                                          typed(json_number) value) {
+  if (value.type == JSON_NUMBER_TYPE_LONG)
+    test_appendf(userdata, "long %ld\n", value.value.as_long);
+  else
+    test_appendf(userdata, "double %a\n", value.value.as_double);
+  return true;
+}
+
+static typed(json_boolean) test_on_boolean(void *userdata,
+                                           typed(json_boolean) value) {
+  test_append(userdata, value ? "true\n" : "false\n");
+  return true;
+}
+
+static typed(json_boolean) test_on_null(void *userdata) {
+  test_append(userdata, "null\n");
+  return true;
+}
+
+static const typed(json_callbacks) test_callbacks = {
+    test_on_object_start, test_on_object_end, test_on_array_start,
+    test_on_array_end,    test_on_key,        test_on_string,
+    test_on_number,       test_on_boolean,    test_on_null,
+};
+
+/**
+ * @brief Lists the events of a parse one per line, followed by its result
+ */
+static char *test_events(const char *json, size_t len,
+                         const typed(json_parse_options) * options) {
+  struct test_text events = {0};
+  test_append(&events, "");
+
+  result(json_boolean) events_result =
+      json_parse_events_with_options(json, len, &test_callbacks, &events,
+                                     options);
+  if (result_is_err(json_boolean)(&events_result))
+    test_append(&events, json_error_to_string(
+                             result_unwrap_err(json_boolean)(&events_result)));
+
+  return events.data;
+}
+
+/**
+ * @brief Lists the events of a push parse fed in chunks of the given
+ * sizes in turn, the same way as `test_events`
+ */
+static char *test_push_events(const char *json, size_t len,
+                              const typed(json_parse_options) * options,
+                              const size_t *chunks, size_t chunk_count) {
+  struct test_text events = {0};
+  test_append(&events, "");
+
+  typed(json_push_parser) *push =
+      json_push_parser_new(&test_callbacks, &events, options);
+  result(json_boolean) push_result = result_ok(json_boolean)(true);
+
+  size_t offset = 0;
+  for (size_t i = 0; offset < len; i++) {
+    size_t chunk = chunks[i % chunk_count];
+    if (chunk > len - offset)
+      chunk = len - offset;
+
+    // Chunks need not outlive the feed
+    char *copy = malloc(chunk);
+    memcpy(copy, json + offset, chunk);
+    push_result = json_push_feed(push, copy, chunk);
+    free(copy);
+
+    offset += chunk;
+    if (result_is_err(json_boolean)(&push_result) ||
+        !result_unwrap(json_boolean)(&push_result))
+      break;
+  }
+  if (result_is_ok(json_boolean)(&push_result) &&
+      result_unwrap(json_boolean)(&push_result))
+    push_result = json_push_finish(push);
+
+  if (result_is_err(json_boolean)(&push_result))
+    test_append(&events, json_error_to_string(
+                             result_unwrap_err(json_boolean)(&push_result)));
+
+  json_push_parser_free(push);
+  return events.data;
+}
+
+/**
+ * @brief A push parser reports the same events as the event parser,
+ * however the input is split
+ */
+static void test_push(void) {
+  struct test_shape shape = {true, true, true};
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = true;
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    char *expected = test_events(json, len, &options);
+
+    size_t single[] = {1};
+    test_same("push", json, strdup(expected),
+              test_push_events(json, len, &options, single, 1));
+
+    size_t whole[] = {len};
+    test_same("push", json, strdup(expected),
+              test_push_events(json, len, &options, whole, 1));
+
+    size_t chunks[8];
+    for (size_t j = 0; j < 8; j++)
+      chunks[j] = 1 + test_random() % 16;
+    test_same("push", json, expected,
+              test_push_events(json, len, &options, chunks, 8));
+
+    free(json);
+  }
+}
+
+/**
+ * @brief Lists the events of the value at a cursor the way the event
+ * parser reports them, keys as they are in the input
+ */
+static bool test_cursor_walk(typed(json_cursor) * cursor,
+                             struct test_text *events) {
+  result(json_element_type) type_result = json_cursor_type(cursor);
+  if (result_is_err(json_element_type)(&type_result))
+    return false;
+
+  switch (result_unwrap(json_element_type)(&type_result)) {
+  case JSON_ELEMENT_TYPE_OBJECT:
+    json_cursor_enter_object(cursor);
+    test_append(events, "{\n");
+    for (;;) {
+      typed(json_string_view) key;
+      result(json_boolean) next = json_cursor_next_field(cursor, &key);
+      if (result_is_err(json_boolean)(&next))
+        return false;
+      if (!result_unwrap(json_boolean)(&next))
+        break;
+
+      test_on_key(events, key);
+      if (!test_cursor_walk(cursor, events))
+        return false;
+    }
+    test_append(events, "}\n");
+    return true;
+  case JSON_ELEMENT_TYPE_ARRAY:
+    json_cursor_enter_array(cursor);
+    test_append(events, "[\n");
+    for (;;) {
+      result(json_boolean) next = json_cursor_next_element(cursor);
+      if (result_is_err(json_boolean)(&next))
+        return false;
+      if (!result_unwrap(json_boolean)(&next))
+        break;
+
+      if (!test_cursor_walk(cursor, events))
+        return false;
+    }
+    test_append(events, "]\n");
+    return true;
+  case JSON_ELEMENT_TYPE_STRING: {
+    char buffer[256];
+    result(json_string_view) value =
+        json_cursor_get_string(cursor, buffer, sizeof(buffer));
+    if (result_is_err(json_string_view)(&value))
+      return false;
+    return test_on_string(events, result_unwrap(json_string_view)(&value));
+  }
+  case JSON_ELEMENT_TYPE_NUMBER: {
+    result(json_number) value = json_cursor_get_number(cursor);
+    if (result_is_err(json_number)(&value))
+      return false;
+    return test_on_number(events, result_unwrap(json_number)(&value));
+  }
+  case JSON_ELEMENT_TYPE_BOOLEAN: {
+    result(json_boolean) value = json_cursor_get_boolean(cursor);
+    if (result_is_err(json_boolean)(&value))
+      return false;
+    return test_on_boolean(events, result_unwrap(json_boolean)(&value));
+  }
+  case JSON_ELEMENT_TYPE_NULL:
+    json_cursor_skip(cursor);
+    return test_on_null(events);
+  }
+
+  return false;
+}
+
+/**
+ * @brief A cursor reads the same values as the event parser reports, and
+ * skipping a value lands where reading it does
+ */
+static void test_cursor(void) {
+  struct test_shape shape = {true, false, true};
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = true;
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+
+    struct test_text events = {0};
+    test_append(&events, "");
+    typed(json_cursor) cursor = json_cursor_make(json, len, &options);
+    if (!test_cursor_walk(&cursor, &events))
+      test_append(&events, "failed");
+    test_same("cursor", json, test_events(json, len, &options), events.data);
+
+    typed(json_cursor) read = json_cursor_make(json, len, &options);
+    typed(json_cursor) skipped = read;
+    struct test_text ignored = {0};
+    test_cursor_walk(&read, &ignored);
+    json_cursor_skip(&skipped);
+    if (read.position != skipped.position)
+      test_fail("cursor", "skipping stops elsewhere than reading in %s",
+                json);
+
+    free(ignored.data);
+    free(json);
+  }
+}
+
+/**
+ * @brief Every line of newline-delimited JSON parses as it would on its
+ * own, on any number of threads
+ */
+static void test_lines(void) {
+  struct test_shape shape = {false, true, true};
+  struct test_text input = {0};
+  size_t line_count = TEST_DOCUMENTS;
+  char **lines = malloc(line_count * sizeof(char *));
+
+  for (size_t i = 0; i < line_count; i++) {
+    size_t len;
+    switch (i % 50) {
+    case 10:
+      lines[i] = strdup("");
+      break;
+    case 20:
+      lines[i] = strdup("{\"a\":");
+      break;
+    case 30:
+      lines[i] = strdup("  7  ");
+      break;
+    default:
+      lines[i] = test_gen_document(&shape, &len);
+    }
+
+    test_append(&input, lines[i]);
+    test_append(&input, i % 7 == 0 ? "\r\n" : "\n");
+  }
+
+  size_t thread_counts[] = {1, 2, 3, 8};
+  for (size_t t = 0; t < 4; t++) {
+    result(json_lines) lines_result =
+        json_parse_lines(input.data, input.len, thread_counts[t], NULL);
+    if (result_is_err(json_lines)(&lines_result)) {
+      test_fail("lines", "failed on %zu threads", thread_counts[t]);
+      continue;
+    }
+    typed(json_lines) parsed = result_unwrap(json_lines)(&lines_result);
+    if (parsed.count != line_count)
+      test_fail("lines", "%zu lines instead of %zu on %zu threads",
+                parsed.count, line_count, thread_counts[t]);
+
+    for (size_t i = 0; i < parsed.count && i < line_count; i++) {
+      result(json_element) *line = &parsed.lines[i];
+      char *actual;
+      if (result_is_err(json_element)(line)) {
+        typed(json_error) error = result_unwrap_err(json_element)(line);
+        actual = strdup(json_error_to_string(error));
+      } else {
+        typed(json_element) element = result_unwrap(json_element)(line);
+        actual = test_serialize(&element, 0);
+      }
+
+      test_same("lines", lines[i],
+                test_parse_serialize(lines[i], strlen(lines[i]), NULL),
+                actual);
+    }
+
+    json_lines_free(&parsed);
+  }
+
+  for (size_t i = 0; i < line_count; i++)
+    free(lines[i]);
+  free(lines);
+  free(input.data);
+}
+
+/**
+ * @brief A root array parsed on several threads is the same document as
+ * one parsed on a single thread
+ */
+static void test_parallel(void) {
+  struct test_shape shape = {true, true, true};
+  struct test_text input = {0};
+
+  test_append(&input, "[");
+  while (input.len < 3 * TEST_PARALLEL_BYTES) {
+    size_t len;
+    if (input.len > 1)
+      test_append(&input, test_random() % 2 ? "," : " ,\n ");
+    char *json = test_gen_document(&shape, &len);
+    test_append(&input, json);
+    free(json);
+  }
+  test_append(&input, "]");
+
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = true;
+  const char *names[] = {"whole array", "unterminated array"};
+  size_t lens[] = {input.len, input.len - 1};
+
+  for (size_t n = 0; n < 2; n++) {
+    result(json_document) sequential_result =
+        json_parse_document_with_options(input.data, lens[n], &options);
+    char *expected = test_document_serialize(&sequential_result);
+
+    size_t thread_counts[] = {2, 3, 8};
+    for (size_t t = 0; t < 3; t++) {
+      result(json_document) parallel_result = json_parse_document_parallel(
+          input.data, lens[n], thread_counts[t], &options);
+      test_same("parallel", names[n], strdup(expected),
+                test_document_serialize(&parallel_result));
+    }
+
+    free(expected);
+  }
+
+  free(input.data);
+}
+
+/**
+ * @brief The number of significant digits of a number as written
+ */
+static int test_digits(const char *number) {
+  int digits = 0;
+  int zeros = 0;
+  bool leading = true;
+
+  for (const char *ch = number; *ch != '\0' && *ch != 'e' && *ch != 'E';
+       ch++) {
+    if (*ch < '0' || *ch > '9')
+      continue;
+    if (*ch == '0' && leading)
+      continue;
+
+    leading = false;
+    if (*ch == '0') {
+      zeros++;
+    } else {
+      digits += zeros + 1;
+      zeros = 0;
+    }
+  }
+
+  return digits == 0 ? 1 : digits;
+}
+
+/**
+ * @brief Serialized JSON parses back to the same tree, pretty-printed or
+ * not, and doubles are written with the fewest digits that read back as
+ * the same double
+ */
+static void test_serializer(void) {
+  struct test_shape shape = {true, true, false};
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    typed(json_parse_options) options = {0};
+    options.skip_whitespace = true;
+    result(json_element) element_result =
+        json_parse_with_options(json, len, &options);
+    // Empty containers are left out, so some roots hold nothing
+    if (result_is_err(json_element)(&element_result)) {
+      free(json);
+      continue;
+    }
+    typed(json_element) element = result_unwrap(json_element)(&element_result);
+
+    char *minified = test_serialize(&element, 0);
+    char *pretty = test_serialize(&element, 2);
+    test_same("serializer", json, strdup(minified),
+              test_parse_serialize(minified, strlen(minified), NULL));
+    test_same("serializer", json, minified,
+              test_parse_serialize(pretty, strlen(pretty), &options));
+
+    free(pretty);
+    json_free(&element);
+    free(json);
+  }
+
+  for (int i = 0; i < 100000; i++) {
+    double value;
+    do {
+      unsigned long long bits = test_random();
+      memcpy(&value, &bits, sizeof(value));
+    } while (!isfinite(value));
+
+    typed(json_element) element = {0};
+    element.type = JSON_ELEMENT_TYPE_NUMBER;
+    element.value.as_number.type = JSON_NUMBER_TYPE_DOUBLE;
+    element.value.as_number.value.as_double = value;
+    char *written = test_serialize(&element, 0);
+
+    result(json_element) read_result = json_parse(written);
+    typed(json_element) read = {0};
+    if (result_is_ok(json_element)(&read_result))
+      read = result_unwrap(json_element)(&read_result);
+    if (read.type != JSON_ELEMENT_TYPE_NUMBER ||
+        read.value.as_number.type != JSON_NUMBER_TYPE_DOUBLE ||
+        memcmp(&read.value.as_number.value.as_double, &value,
+               sizeof(value)) != 0) {
+      test_fail("shortest doubles", "%.17g written as %s", value, written);
+    } else {
+      // Fewer digits never read back as the same double
+      int shortest = 1;
+      char buffer[32];
+      for (; shortest < 17; shortest++) {
+        sprintf(buffer, "%.*e", shortest - 1, value);
+        if (strtod(buffer, NULL) == value)
+          break;
+      }
+      if (test_digits(written) != shortest)
+        test_fail("shortest doubles", "%.17g written as %s instead of %s",
+                  value, written, buffer);
+    }
+
+    free(written);
+  }
+}
+
+/**
+ * @brief Writes the value of a tape as JSON, the way `json_serialize`
+ * writes a tree
+ */
+static void test_tape_write(typed(json_writer) * writer,
+                            typed(json_tape_value) value) {
+  switch (json_tape_type(value)) {
+  case JSON_ELEMENT_TYPE_OBJECT:
+    json_writer_begin_object(writer);
+    for (typed(json_tape_value) key = json_tape_first(value);
+         !json_tape_is_end(key); key = json_tape_next(key)) {
+      result(json_string_view) name = json_tape_get_string(key);
+      typed(json_string_view) view = result_unwrap(json_string_view)(&name);
+      json_writer_key_n(writer, view.data, view.len);
+      test_tape_write(writer, json_tape_key_value(key));
+    }
+    json_writer_end_object(writer);
+    break;
+  case JSON_ELEMENT_TYPE_ARRAY:
+    json_writer_begin_array(writer);
+    for (typed(json_tape_value) item = json_tape_first(value);
+         !json_tape_is_end(item); item = json_tape_next(item))
+      test_tape_write(writer, item);
+    json_writer_end_array(writer);
+    break;
+  case JSON_ELEMENT_TYPE_STRING: {
+    result(json_string_view) str = json_tape_get_string(value);
+    typed(json_string_view) view = result_unwrap(json_string_view)(&str);
+    json_writer_string_n(writer, view.data, view.len);
+    break;
+  }
+  case JSON_ELEMENT_TYPE_NUMBER: {
+    result(json_number) number = json_tape_get_number(value);
+    json_writer_number(writer, result_unwrap(json_number)(&number));
+    break;
+  }
+  case JSON_ELEMENT_TYPE_BOOLEAN: {
+    result(json_boolean) boolean = json_tape_get_boolean(value);
+    json_writer_boolean(writer, result_unwrap(json_boolean)(&boolean));
+    break;
+  }
+  case JSON_ELEMENT_TYPE_NULL:
+    json_writer_null(writer);
+    break;
+  }
+}
+
+/**
+ * @brief Looks up every member of the containers of a tree on the tape
+ * holding the same values
+ */
+static void test_tape_lookups(const char *json,
+                              const typed(json_element) * element,
+                              typed(json_tape_value) value) {
+  if (element->type == JSON_ELEMENT_TYPE_OBJECT) {
+    typed(json_object) *object = element->value.as_object;
+    if (json_tape_count(value) != object->count)
+      test_fail("tape", "%zu entries instead of %zu in %s",
+                json_tape_count(value), object->count, json);
+
+    for (size_t i = 0; i < object->count; i++) {
+      typed(json_string_view) key = object->shape->keys[i];
+      result(json_element) expected = json_object_find(object, key.data);
+      result(json_tape_value) found = json_tape_object_find(value, key.data);
+      typed(json_key) handle = json_key_make(key.data);
+      result(json_tape_value) found_key =
+          json_tape_object_find_key(value, &handle);
+      if (result_is_err(json_tape_value)(&found) ||
+          result_is_err(json_tape_value)(&found_key) ||
+          result_unwrap(json_tape_value)(&found).index !=
+              result_unwrap(json_tape_value)(&found_key).index) {
+        test_fail("tape", "key %s not found in %s", key.data, json);
+        continue;
+      }
+
+      typed(json_element) expected_element =
+          result_unwrap(json_element)(&expected);
+      test_tape_lookups(json, &expected_element,
+                        result_unwrap(json_tape_value)(&found));
+    }
+
+    result(json_tape_value) missing =
+        json_tape_object_find(value, "missing key");
+    if (result_is_ok(json_tape_value)(&missing))
+      test_fail("tape", "found a missing key in %s", json);
+  } else if (element->type == JSON_ELEMENT_TYPE_ARRAY) {
+    typed(json_array) *array = element->value.as_array;
+    if (json_tape_count(value) != array->count)
+      test_fail("tape", "%zu elements instead of %zu in %s",
+                json_tape_count(value), array->count, json);
+
+    for (size_t i = 0; i < array->count; i++) {
+      result(json_tape_value) found = json_tape_array_get(value, i);
+      if (result_is_err(json_tape_value)(&found)) {
+        test_fail("tape", "element %zu not found in %s", i, json);
+        continue;
+      }
+      test_tape_lookups(json, &array->elements[i],
+                        result_unwrap(json_tape_value)(&found));
+    }
+
+    result(json_tape_value) beyond = json_tape_array_get(value, array->count);
+    if (result_is_ok(json_tape_value)(&beyond))
+      test_fail("tape", "found an element beyond the end of %s", json);
+  }
+}
+
+/**
+ * @brief A tape holds the same values as the tree `json_parse` makes, and
+ * its lookups find the same members
+ */
+static void test_tape(void) {
+  struct test_shape shape = {true, true, true};
+  typed(json_parse_options) options = {0};
+  options.skip_whitespace = true;
+
+  for (int i = 0; i < TEST_DOCUMENTS; i++) {
+    size_t len;
+    char *json = test_gen_document(&shape, &len);
+    result(json_element) element_result =
+        json_parse_with_options(json, len, &options);
+    result(json_tape) tape_result = json_parse_tape(json, len, &options);
+    if (result_is_err(json_element)(&element_result) ||
+        result_is_err(json_tape)(&tape_result)) {
+      if (result_is_ok(json_element)(&element_result) ||
+          result_is_ok(json_tape)(&tape_result))
+        test_fail("tape", "only one of the tree and tape parses %s", json);
+      free(json);
+      continue;
+    }
+    typed(json_element) element = result_unwrap(json_element)(&element_result);
+    typed(json_tape) tape = result_unwrap(json_tape)(&tape_result);
+
+    typed(json_sink) sink = json_sink_make(NULL, NULL);
+    typed(json_writer) writer = json_writer_make(&sink, 0);
+    test_tape_write(&writer, json_tape_root(&tape));
+    json_writer_finish(&writer);
+    char *written = malloc(sink.len + 1);
+    memcpy(written, sink.buffer, sink.len);
+    written[sink.len] = '\0';
+    json_sink_free(&sink);
+    test_same("tape", json, test_serialize(&element, 0), written);
+
+    test_tape_lookups(json, &element, json_tape_root(&tape));
+
+    json_tape_free(&tape);
+    json_free(&element);
+    free(json);
+  }
+}
+
+/**
+ * @brief Whether a parse of every kind fails with `JSON_ERROR_TOO_DEEP`,
+ * or succeeds, at a depth, and whether a tree that succeeds writes back
+ * as it was read
+ */
+static void test_depth_limit(size_t depth, size_t max_depth,
+                             bool too_deep) {
+  size_t len;
+  char *json = test_gen_nested(depth, &len);
+  typed(json_parse_options) options = {0};
+  options.max_depth = max_depth;
+  typed(json_parse_options) indexed = options;
+  indexed.structural_index = true;
+
+  char name[64];
+  sprintf(name, "depth %zu of %zu", depth, max_depth);
+  const char *expected = too_deep ? "JSON_ERROR_TOO_DEEP" : "ok";
+
+  const typed(json_parse_options) *trees[] = {&options, &indexed};
+  for (size_t i = 0; i < 2; i++) {
+    result(json_element) tree = json_parse_with_options(json, len, trees[i]);
+    bool failed = result_is_err(json_element)(&tree);
+    if (failed != too_deep ||
+        (failed && result_unwrap_err(json_element)(&tree) !=
+                       JSON_ERROR_TOO_DEEP))
+      test_fail(name, "tree is not %s", expected);
+    if (!failed) {
+      typed(json_element) element = result_unwrap(json_element)(&tree);
+      test_same(name, "tree", strdup(json), test_serialize(&element, 0));
+      json_free(&element);
+    }
+  }
+
+  result(json_document) document =
+      json_parse_document_with_options(json, len, &options);
+  bool failed = result_is_err(json_document)(&document);
+  if (failed != too_deep)
+    test_fail(name, "document is not %s", expected);
+  if (!failed) {
+    typed(json_document) parsed = result_unwrap(json_document)(&document);
+    json_document_free(&parsed);
+  }
+
+  result(json_tape) tape = json_parse_tape(json, len, &options);
+  failed = result_is_err(json_tape)(&tape);
+  if (failed != too_deep)
+    test_fail(name, "tape is not %s", expected);
+  if (!failed) {
+    typed(json_tape) parsed = result_unwrap(json_tape)(&tape);
+    json_tape_free(&parsed);
+  }
+
+  typed(json_callbacks) none = {0};
+  result(json_boolean) events =
+      json_parse_events_with_options(json, len, &none, NULL, &options);
+  if (result_is_err(json_boolean)(&events) != too_deep)
+    test_fail(name, "events are not %s", expected);
+
+  typed(json_push_parser) *push = json_push_parser_new(&none, NULL, &options);
+  result(json_boolean) pushed = json_push_feed(push, json, len);
+  if (result_is_ok(json_boolean)(&pushed))
+    pushed = json_push_finish(push);
+  json_push_parser_free(push);
+  if (result_is_err(json_boolean)(&pushed) != too_deep)
+    test_fail(name, "push is not %s", expected);
+
+  free(json);
+}
+
+/**
+ * @brief Finds the first element of an array holding a nesting far
+ * beyond the limit, which is looked into without recursion
+ */
+static void test_path_depth(size_t depth) {
+  size_t nested_len;
+  char *nested = test_gen_nested(depth, &nested_len);
+  struct test_text json = {0};
+  test_append(&json, "[");
+  test_append(&json, nested);
+  test_append(&json, "]");
+  free(nested);
+
+  result(json_path) path_result = json_path_compile("/0");
+  typed(json_path) path = result_unwrap(json_path)(&path_result);
+
+  char name[64];
+  sprintf(name, "path depth %zu", depth);
+  result(json_element) found =
+      json_path_find(&path, json.data, json.len, NULL);
+  if (result_is_ok(json_element)(&found)) {
+    test_fail(name, "found an element beyond the limit");
+    typed(json_element) element = result_unwrap(json_element)(&found);
+    json_free(&element);
+  } else if (result_unwrap_err(json_element)(&found) != JSON_ERROR_TOO_DEEP) {
+    test_fail(name, "is not JSON_ERROR_TOO_DEEP");
+  }
+
+  json_path_free(&path);
+  free(json.data);
+}
+
+/**
+ * @brief Skips a nesting within a limit far beyond the default, which is
+ * done without recursion, to get to what follows it
+ */
+static void test_skip_depth(size_t depth) {
+  size_t nested_len;
+  char *nested = test_gen_nested(depth, &nested_len);
+  struct test_text array = {0};
+  test_append(&array, "[");
+  test_append(&array, nested);
+  test_append(&array, ",2]");
+  struct test_text object = {0};
+  test_append(&object, "{\"\":");
+  test_append(&object, nested);
+  test_append(&object, ",\"a\":1}");
+  free(nested);
+
+  typed(json_parse_options) options = {0};
+  options.max_depth = 2 * depth;
+
+  char name[64];
+  sprintf(name, "skip depth %zu", depth);
+
+  result(json_path) path_result = json_path_compile("/1");
+  typed(json_path) path = result_unwrap(json_path)(&path_result);
+  result(json_element) found =
+      json_path_find(&path, array.data, array.len, &options);
+  if (result_is_ok(json_element)(&found)) {
+    typed(json_element) element = result_unwrap(json_element)(&found);
+    test_same(name, "path", strdup("2"), test_serialize(&element, 0));
+    json_free(&element);
+  } else {
+    test_fail(name, "path does not find the element after it");
+  }
+  json_path_free(&path);
+
+  typed(json_cursor) cursor = json_cursor_make(array.data, array.len, NULL);
+  json_cursor_enter_array(&cursor);
+  json_cursor_next_element(&cursor);
+  json_cursor_skip(&cursor);
+  json_cursor_next_element(&cursor);
+  result(json_number) number = json_cursor_get_number(&cursor);
+  if (result_is_err(json_number)(&number) ||
+      result_unwrap(json_number)(&number).value.as_long != 2)
+    test_fail(name, "cursor does not get to the number after it");
+
+  // The empty key is dropped along with its value
+  test_same(name, "empty key", strdup("{\"a\":1}"),
+            test_parse_serialize(object.data, object.len, &options));
+
+  free(array.data);
+  free(object.data);
+}
+
+/**
+ * @brief Nesting up to the limit parses, writes and frees without
+ * recursion, and one level more fails
+ */
+static void test_depth(void) {
+  test_depth_limit(1024, 0, false);
+  test_depth_limit(1025, 0, true);
+  test_depth_limit(1000000, 1000000, false);
+  test_depth_limit(1000001, 1000000, true);
+  test_path_depth(1000000);
+  test_skip_depth(1000000);
+}
+
+int main(int argc, char **argv) {
+  const char *directory = argc > 1 ? argv[1] : "sample";
+  char **samples = test_sample_paths(directory);
+
+  test_missing_keys();
+  test_indexed(samples);
+  test_documents();
+  test_paths();
+  test_push();
+  test_cursor();
+  test_lines();
+  test_parallel();
+  test_serializer();
+  test_tape();
+  test_depth();
+
+  for (char **path = samples; *path != NULL; path++)
+    free(*path);
+  free(samples);
+
+  if (test_failures != 0) {
+    fprintf(stderr, "%d checks failed\n", test_failures);
+    return 1;
+  }
+
+  printf("All checks passed\n");
+  return 0;
+}